@@ -174,6 +174,12 @@ public:
     {}
 };
 
+// Thrown when the analysis needs more memory than CompilerArguments::memoryLimit allows
+class MemoryLimitExceeded : public compile_error {
+public:
+    MemoryLimitExceeded( size_t limit );
+};
+
 } // PracticalSemanticAnalyzer
 
 #endif // PRACTICAL_ERRORS_H
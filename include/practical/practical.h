@@ -10,14 +10,16 @@
 #define PRACTICAL_PRACTICAL_H
 
 #include "nocopy.h"
+#include "ref_counted.h"
 #include "typed.h"
 #include "slice.h"
 
 #include <boost/intrusive_ptr.hpp>
-#include <boost/smart_ptr/intrusive_ref_counter.hpp>
 
+#include <chrono>
 #include <iostream>
 #include <memory>
+#include <memory_resource>
 #include <string>
 #include <variant>
 
@@ -32,8 +34,101 @@ DECL_TYPED_NS( PracticalSemanticAnalyzer, ExpressionId, unsigned long, 0, Practi
 DECL_TYPED_NS( PracticalSemanticAnalyzer, JumpPointId, unsigned long, 0, PracticalSAModuleId );
 
 namespace PracticalSemanticAnalyzer {
+    // Where a compilation's time went, and how much work it did
+    struct CompileStats {
+        struct Time {
+            std::chrono::nanoseconds wall{};
+            // Of the thread doing the work
+            std::chrono::nanoseconds cpu{};
+
+            Time &operator+=( const Time &that ) {
+                wall += that.wall;
+                cpu += that.cpu;
+
+                return *this;
+            }
+        };
+
+        // Mapping the source file into memory
+        Time read;
+        Time tokenize;
+        // When streaming, this includes tokenizing the function bodies, which are only tokenized once parsed
+        Time parse;
+        Time symbolsPass1;
+        Time symbolsPass2;
+        // Summed over the module's functions. These can add up to more than the compilation took, as functions are
+        // analyzed in parallel, and as a function's time includes waiting for the ones it evaluates calls to.
+        Time buildAST;
+        Time codeGen;
+
+        size_t tokens = 0;
+        // Expression nodes and statements the analysis created, including the ones it discarded
+        size_t astNodes = 0;
+        size_t typesAllocated = 0;
+        // Value ranges of compound types. Scalar ranges need no allocation.
+        size_t valueRangesAllocated = 0;
+        // Searches for a cast between types the builtin cast table does not cover
+        size_t castSearches = 0;
+        // Overloads with the right number of arguments that were considered when resolving a call
+        size_t overloadCandidates = 0;
+        // Times the parser backtracked to try another rule, each one an exception thrown and caught again. No other
+        // exceptions are counted.
+        size_t parserBacktracks = 0;
+
+        CompileStats &operator+=( const CompileStats &that ) {
+            read += that.read;
+            tokenize += that.tokenize;
+            parse += that.parse;
+            symbolsPass1 += that.symbolsPass1;
+            symbolsPass2 += that.symbolsPass2;
+            buildAST += that.buildAST;
+            codeGen += that.codeGen;
+
+            tokens += that.tokens;
+            astNodes += that.astNodes;
+            typesAllocated += that.typesAllocated;
+            valueRangesAllocated += that.valueRangesAllocated;
+            castSearches += that.castSearches;
+            overloadCandidates += that.overloadCandidates;
+            parserBacktracks += that.parserBacktracks;
+
+            return *this;
+        }
+    };
+
     class CompilerArguments {
     public:
+        // Number of threads analyzing the module's functions. 0 means one per hardware thread.
+        unsigned numThreads = 1;
+        // Hand the functions to the backend in source order, from the thread that called compile. Otherwise, each
+        // function goes to the backend from the thread that analyzed it, as soon as it is ready. The expression and jump
+        // point ids are then no longer numbered densely across the module: each function's ids come from a range of its
+        // own.
+        bool deterministic = true;
+        // Tokenize on a thread of its own, parsing each top level item as soon as it is tokenized
+        bool pipelined = false;
+        // Analyze, generate and then free one function at a time, so that peak memory depends on the largest function
+        // rather than on the whole module. Function bodies are only tokenized and parsed when their turn comes, and
+        // a syntax error in one is therefore found after the functions before it were generated. Analyzes on the
+        // calling thread, ignoring numThreads and pipelined.
+        bool streaming = false;
+        // Where the analysis of the module's functions gets its memory from. nullptr means the global operator new.
+        // Must be thread safe when analyzing on several threads.
+        //
+        // Only the analysis arenas, which hold the functions' expressions, statements and cast chains, allocate from
+        // it. Everything else uses the global operator new: the tokens and the parse tree, as well as the types, value
+        // ranges, lookup tables and the expression memo's entries.
+        std::pmr::memory_resource *memoryResource = nullptr;
+        // Compiling fails with MemoryLimitExceeded once the compilation holds more than this many bytes. 0 means no
+        // limit.
+        //
+        // Counted are the functions' analysis, the tokens, and the parse tree. Parse tree nodes are counted when
+        // allocated, including ones the parser discards again. The types, value ranges, lookup tables and expression
+        // memo entries are not counted. The analysis is counted in chunks: each function takes at least 16KiB, held
+        // until the compilation ends unless streaming.
+        size_t memoryLimit = 0;
+        // If set, the compilation's statistics are added to it, also when it fails. compileMany adds those of all jobs.
+        CompileStats *stats = nullptr;
     };
 
     struct SourceLocation {
@@ -62,7 +157,7 @@ namespace PracticalSemanticAnalyzer {
         void *p;
     };
 
-    class StaticType : private NoCopy, public boost::intrusive_ref_counter<StaticType, boost::thread_unsafe_counter> {
+    class StaticType : private NoCopy, public RefCounted<StaticType> {
     public:
         using CPtr = boost::intrusive_ptr<const StaticType>;
 
@@ -150,7 +245,7 @@ namespace PracticalSemanticAnalyzer {
             bool operator==( const Array &rhs ) const;
         };
 
-        class Struct : public boost::intrusive_ref_counter<Struct, boost::thread_unsafe_counter> {
+        class Struct : public RefCounted<Struct> {
         public:
             using CPtr = boost::intrusive_ptr<const Struct>;
 
@@ -253,6 +348,8 @@ namespace PracticalSemanticAnalyzer {
         virtual void jump(JumpPointId destination) = 0;
 
         // Litarals
+        // For a signed type, value is in two's complement. Folded expressions can be negative, e.g. "3 - 10" as an S16
+        // arrives as LongEnoughInt(-7). Convert to LongEnoughIntSigned to get the actual value.
         virtual void setLiteral(ExpressionId id, LongEnoughInt value, StaticType::CPtr type) = 0;
         virtual void setLiteral(ExpressionId id, bool value) = 0;
         virtual void setLiteral(ExpressionId id, String value) = 0;
@@ -321,6 +418,13 @@ namespace PracticalSemanticAnalyzer {
         virtual void operatorLogicalNot( ExpressionId id, ExpressionId argument ) = 0;
     };
 
+    // All calls come from the thread that called compile, except for handleFunction. When compiling with more than one
+    // thread and without CompilerArguments::deterministic, handleFunction may be called by several threads at once,
+    // between declaring the module's symbols and moduleLeave. Each FunctionGen it returns is only used by the thread
+    // that asked for it.
+    //
+    // Expression and jump point ids are unique in the module, whatever the number of threads. A function gets the same
+    // ids no matter which thread analyzed it.
     class ModuleGen {
     public:
         virtual void moduleEnter(ModuleId id, String name, String file, size_t line, size_t col) = 0;
@@ -333,12 +437,35 @@ namespace PracticalSemanticAnalyzer {
         virtual std::shared_ptr<FunctionGen> handleFunction() = 0;
     };
 
+    // A file for compileMany to compile, and the backend to hand its module to
+    struct CompileJob {
+        std::string path;
+        ModuleGen *codeGen = nullptr;
+    };
+
+    struct CompileJobResult {
+        bool succeeded = false;
+        // What went wrong, if the job did not succeed
+        std::string error;
+        // Time spent reading, tokenizing and parsing the file
+        std::chrono::nanoseconds parseTime{};
+        // Time spent analyzing the module and generating its code
+        std::chrono::nanoseconds analysisTime{};
+        CompileStats stats;
+    };
+
     std::unique_ptr<CompilerArguments> allocateArguments();
 
     // Must be called exactly once, before starting actual compilation
     void prepare( BuiltinContextGen *ctxGen ); // This is the lookup context used for the builtin types
-    // XXX Should path actually be a buffer?
     int compile(std::string path, const CompilerArguments *arguments, ModuleGen *codeGen);
+    // Compiles source already in memory. fileName is only used to describe the source to the backend. The source is
+    // not copied: it, and the file name, need to stay valid until compile returns.
+    int compile(String source, String fileName, const CompilerArguments *arguments, ModuleGen *codeGen);
+    // Compiles the files on a pool of CompilerArguments::numThreads threads. Each module is analyzed by a single
+    // thread, and its ModuleGen is only called from that thread. One job failing does not stop the others. Returns the
+    // results in the order of the jobs.
+    std::vector<CompileJobResult> compileMany( Slice<const CompileJob> jobs, const CompilerArguments *arguments );
 } // End namespace PracticalSemanticAnalyzer
 
 namespace std {
@@ -0,0 +1,60 @@
+/* This file is part of the Practical programming langauge. https://github.com/Practical/practical-sa
+ *
+ * To the extent header files enjoy copyright protection, this file is file is copyright (C) 2021 by its authors
+ * You can see the file's authors in the AUTHORS file in the project's home repository.
+ *
+ * This is available under the Boost license. The license's text is available under the LICENSE file in the project's
+ * home directory.
+ */
+#ifndef PRACTICAL_REF_COUNTED_H
+#define PRACTICAL_REF_COUNTED_H
+
+#include <atomic>
+#include <limits>
+
+// Intrusive reference count, for use with boost::intrusive_ptr.
+//
+// The count is atomic. A module's types stay mortal while functions analyzed on different threads share them, as the
+// module changes them again once the threads are done.
+//
+// Objects every compilation uses, such as the builtin types, are made immortal. Immortal objects are never freed, and
+// pointers to them leave the count alone. This is not needed for thread safety. It keeps the threads from contending on
+// the counts of the objects they use the most.
+template<typename Derived>
+class RefCounted {
+    static constexpr unsigned Immortal = std::numeric_limits<unsigned>::max();
+
+    mutable std::atomic<unsigned> _refCount = 0;
+
+public:
+    RefCounted() = default;
+    // Copies start out with no references, and are never immortal
+    RefCounted( const RefCounted & ) {}
+    RefCounted &operator=( const RefCounted & ) {
+        return *this;
+    }
+
+    // Must be called before the object is shared between threads
+    void makeImmortal() const {
+        _refCount.store( Immortal, std::memory_order_relaxed );
+    }
+
+    bool isImmortal() const {
+        return _refCount.load( std::memory_order_relaxed )==Immortal;
+    }
+
+    friend void intrusive_ptr_add_ref( const RefCounted *object ) {
+        if( !object->isImmortal() )
+            object->_refCount.fetch_add( 1, std::memory_order_relaxed );
+    }
+
+    friend void intrusive_ptr_release( const RefCounted *object ) {
+        if( !object->isImmortal() && object->_refCount.fetch_sub( 1, std::memory_order_acq_rel )==1 )
+            delete static_cast<const Derived *>( object );
+    }
+
+protected:
+    ~RefCounted() = default;
+};
+
+#endif // PRACTICAL_REF_COUNTED_H
@@ -47,6 +47,11 @@ public:
         Type index = startValue;
 
     public:
+        Allocator() = default;
+        // Allocates the values following after
+        explicit Allocator( Typed after ) : index( after.get() ) {
+        }
+
         Typed allocate() {
             return Typed(++index);
         }
@@ -0,0 +1,59 @@
+/* This file is part of the Practical programming langauge. https://github.com/Practical/practical-sa
+ *
+ * This file is file is copyright (C) 2021 by its authors.
+ * You can see the file's authors in the AUTHORS file in the project's home repository.
+ *
+ * This is available under the Boost license. The license's text is available under the LICENSE file in the project's
+ * home directory.
+ */
+#include "ast/arrays.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class ArrayValueRangeTest : public CppUnit::TestFixture {
+    static LongEnoughInt elementMax( const AST::ArrayValueRange &range, size_t index ) {
+        return range.at( index ).get<AST::UnsignedIntValueRange>().maximum;
+    }
+
+    void overridesTest() {
+        AST::ArrayValueRange range( AST::UnsignedIntValueRange(0, 255), 1048576 );
+        CPPUNIT_ASSERT( !range.isLiteral() );
+        CPPUNIT_ASSERT_EQUAL( LongEnoughInt(255), elementMax( range, 1000 ) );
+
+        range.set( 10, 20, AST::UnsignedIntValueRange(1, 1) );
+        range.set( 30, AST::UnsignedIntValueRange(3, 3) );
+        CPPUNIT_ASSERT_EQUAL( size_t(2), range.overrides().size() );
+
+        // Overwrite the tail of the first interval, the gap and the second interval
+        range.set( 15, 31, AST::UnsignedIntValueRange(2, 2) );
+        CPPUNIT_ASSERT_EQUAL( size_t(2), range.overrides().size() );
+        CPPUNIT_ASSERT_EQUAL( LongEnoughInt(255), elementMax( range, 9 ) );
+        CPPUNIT_ASSERT_EQUAL( LongEnoughInt(1), elementMax( range, 14 ) );
+        CPPUNIT_ASSERT_EQUAL( LongEnoughInt(2), elementMax( range, 15 ) );
+        CPPUNIT_ASSERT_EQUAL( LongEnoughInt(2), elementMax( range, 30 ) );
+        CPPUNIT_ASSERT_EQUAL( LongEnoughInt(255), elementMax( range, 31 ) );
+
+        // Split an interval in the middle
+        range.set( 20, AST::UnsignedIntValueRange(4, 4) );
+        CPPUNIT_ASSERT_EQUAL( size_t(4), range.overrides().size() );
+        CPPUNIT_ASSERT_EQUAL( LongEnoughInt(2), elementMax( range, 19 ) );
+        CPPUNIT_ASSERT_EQUAL( LongEnoughInt(4), elementMax( range, 20 ) );
+        CPPUNIT_ASSERT_EQUAL( LongEnoughInt(2), elementMax( range, 21 ) );
+
+        range.set( 0, range.size(), AST::UnsignedIntValueRange(7, 7) );
+        CPPUNIT_ASSERT_EQUAL( size_t(1), range.overrides().size() );
+        CPPUNIT_ASSERT( range.isLiteral() );
+    }
+
+public:
+    static CppUnit::Test *suite()
+    {
+        CppUnit::TestSuite *suiteOfTests = new CppUnit::TestSuite( "ArrayValueRangeTest" );
+        suiteOfTests->addTest( new CppUnit::TestCaller<ArrayValueRangeTest>(
+                    "overridesTest",
+                    &ArrayValueRangeTest::overridesTest ) );
+        return suiteOfTests;
+    }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( ArrayValueRangeTest );
@@ -0,0 +1,48 @@
+/* This file is part of the Practical programming langauge. https://github.com/Practical/practical-sa
+ *
+ * To the extent header files enjoy copyright protection, this file is file is copyright (C) 2021 by its authors
+ * You can see the file's authors in the AUTHORS file in the project's home repository.
+ *
+ * This is available under the Boost license. The license's text is available under the LICENSE file in the project's
+ * home directory.
+ */
+#include "ast/arena.h"
+
+#include "asserts.h"
+
+#include <algorithm>
+
+namespace AST {
+
+void Arena::reset() {
+    for( Chunk &chunk : _chunks ) {
+        // The last chunk is only used up to _next
+        size_t used = &chunk!=&_chunks.back() ? chunk.size : _next - chunk.memory;
+        poison( chunk.memory, used, ReleasedPoison );
+        _resource->deallocate( chunk.memory, chunk.size, alignof(std::max_align_t) );
+    }
+
+    _chunks.clear();
+    _next = _end = nullptr;
+}
+
+void *Arena::allocateSlow( size_t size, size_t alignment ) {
+    size_t chunkSize = std::max( _chunks.empty() ? FirstChunkSize : _chunks.back().size * 2, size + alignment );
+    Chunk &chunk = _chunks.emplace_back( Chunk{ .memory = nullptr, .size = chunkSize } );
+    try {
+        chunk.memory = static_cast<std::byte *>( _resource->allocate( chunkSize, alignof(std::max_align_t) ) );
+    } catch(...) {
+        _chunks.pop_back();
+        throw;
+    }
+
+    _next = chunk.memory;
+    _end = _next + chunkSize;
+
+    void *result = tryAllocate( size, alignment );
+    ASSERT( result!=nullptr );
+
+    return result;
+}
+
+} // namespace AST
@@ -0,0 +1,149 @@
+/* This file is part of the Practical programming langauge. https://github.com/Practical/practical-sa
+ *
+ * To the extent header files enjoy copyright protection, this file is file is copyright (C) 2021 by its authors
+ * You can see the file's authors in the AUTHORS file in the project's home repository.
+ *
+ * This is available under the Boost license. The license's text is available under the LICENSE file in the project's
+ * home directory.
+ */
+#ifndef AST_ARENA_H
+#define AST_ARENA_H
+
+#include "config.h"
+
+#include "nocopy.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+namespace AST {
+
+// Bump allocator for the objects created while analyzing a single function.
+//
+// Allocating advances a pointer, and freeing does nothing: the memory is only released all at once, by reset or when
+// the arena goes away. Destructors still run as usual, as the objects refer to types and ranges that outlive them.
+//
+// Configuring with --enable-arena-poison fills memory with junk as it is handed out and as it is reset. Reading uninitialized or
+// stale objects then produces recognizably bad values instead of plausible ones.
+class Arena : private NoCopy {
+public:
+    // Destroys the object, leaving its memory to the arena
+    struct Deleter {
+        template<typename T>
+        void operator()( T *object ) const {
+            object->~T();
+        }
+    };
+
+    template<typename T>
+    using Ptr = std::unique_ptr<T, Deleter>;
+
+    // Standard allocator, for std::allocate_shared and containers
+    template<typename T>
+    class Allocator {
+        template<typename U>
+        friend class Allocator;
+
+        Arena *_arena;
+
+    public:
+        using value_type = T;
+
+        explicit Allocator( Arena &arena ) : _arena( &arena ) {}
+        template<typename U>
+        Allocator( const Allocator<U> &that ) : _arena( that._arena ) {}
+
+        T *allocate( size_t n ) {
+            return static_cast<T *>( _arena->allocate( n * sizeof(T), alignof(T) ) );
+        }
+
+        void deallocate( T *pointer, size_t n ) {
+        }
+
+        template<typename U>
+        bool operator==( const Allocator<U> &that ) const {
+            return _arena==that._arena;
+        }
+
+        template<typename U>
+        bool operator!=( const Allocator<U> &that ) const {
+            return _arena!=that._arena;
+        }
+    };
+
+private:
+    static constexpr size_t FirstChunkSize = 16 * 1024;
+    static constexpr unsigned char AllocatedPoison = 0xcd, ReleasedPoison = 0xdd;
+
+    struct Chunk {
+        std::byte *memory;
+        size_t size;
+    };
+
+    std::pmr::memory_resource *_resource;
+    // Allocating from the last one
+    std::vector<Chunk> _chunks;
+    std::byte *_next = nullptr, *_end = nullptr;
+
+public:
+    // Takes its memory from resource, in chunks
+    explicit Arena( std::pmr::memory_resource *resource = std::pmr::new_delete_resource() ) : _resource( resource ) {}
+    ~Arena() {
+        reset();
+    }
+
+    std::pmr::memory_resource *getResource() const {
+        return _resource;
+    }
+
+    void *allocate( size_t size, size_t alignment ) {
+        if( void *result = tryAllocate( size, alignment ) )
+            return result;
+
+        return allocateSlow( size, alignment );
+    }
+
+    template<typename T, typename... Args>
+    Ptr<T> make( Args&&... args ) {
+        return Ptr<T>( new( allocate( sizeof(T), alignof(T) ) ) T( std::forward<Args>(args)... ) );
+    }
+
+    template<typename T, typename... Args>
+    std::shared_ptr<T> makeShared( Args&&... args ) {
+        return std::allocate_shared<T>( Allocator<T>( *this ), std::forward<Args>(args)... );
+    }
+
+    // Frees everything allocated so far. The objects must have been destroyed.
+    void reset();
+
+private:
+    void *tryAllocate( size_t size, size_t alignment ) {
+        uintptr_t address = ( reinterpret_cast<uintptr_t>(_next) + alignment - 1 ) & ~( alignment - 1 );
+        if( _next==nullptr || address + size > reinterpret_cast<uintptr_t>(_end) )
+            return nullptr;
+
+        _next = reinterpret_cast<std::byte *>( address + size );
+        poison( reinterpret_cast<std::byte *>(address), size, AllocatedPoison );
+
+        return reinterpret_cast<void *>(address);
+    }
+
+    void *allocateSlow( size_t size, size_t alignment );
+
+#if ARENA_POISON
+    static void poison( std::byte *memory, size_t size, unsigned char pattern ) {
+        memset( memory, pattern, size );
+    }
+#else
+    static void poison( std::byte *, size_t, unsigned char ) {
+    }
+#endif
+};
+
+} // namespace AST
+
+#endif // AST_ARENA_H
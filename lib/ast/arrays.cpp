@@ -0,0 +1,65 @@
+/* This file is part of the Practical programming langauge. https://github.com/Practical/practical-sa
+ *
+ * To the extent header files enjoy copyright protection, this file is file is copyright (C) 2021 by its authors
+ * You can see the file's authors in the AUTHORS file in the project's home repository.
+ *
+ * This is available under the Boost license. The license's text is available under the LICENSE file in the project's
+ * home directory.
+ */
+#include "ast/arrays.h"
+
+#include <algorithm>
+
+namespace AST {
+
+const ValueRange &ArrayValueRange::at( size_t index ) const {
+    ASSERT( index<_numElements )<<"Array value range index "<<index<<" out of bounds "<<_numElements;
+
+    // First interval ending after index
+    auto interval = std::upper_bound(
+            _overrides.begin(), _overrides.end(), index,
+            []( size_t index, const Interval &interval ) { return index<interval.end; } );
+
+    if( interval!=_overrides.end() && interval->begin<=index )
+        return interval->range;
+
+    return _defaultRange;
+}
+
+void ArrayValueRange::set( size_t begin, size_t end, const ValueRange &range ) {
+    ASSERT( begin<end && end<=_numElements )<<
+            "Array value range interval ["<<begin<<", "<<end<<") invalid for "<<_numElements<<" elements";
+
+    // Intervals [first, last) overlap [begin, end)
+    auto first = std::upper_bound(
+            _overrides.begin(), _overrides.end(), begin,
+            []( size_t begin, const Interval &interval ) { return begin<interval.end; } );
+    auto last = std::lower_bound(
+            first, _overrides.end(), end,
+            []( const Interval &interval, size_t end ) { return interval.begin<end; } );
+
+    // Keep the parts of the overlapping intervals that stick out
+    std::vector<Interval> replacement;
+    if( first!=last && first->begin<begin )
+        replacement.emplace_back( Interval{ .begin = first->begin, .end = begin, .range = first->range } );
+    replacement.emplace_back( Interval{ .begin = begin, .end = end, .range = range } );
+    if( first!=last && std::prev(last)->end>end )
+        replacement.emplace_back( Interval{ .begin = end, .end = std::prev(last)->end, .range = std::prev(last)->range } );
+
+    auto position = _overrides.erase( first, last );
+    _overrides.insert( position, replacement.begin(), replacement.end() );
+}
+
+bool ArrayValueRange::isLiteral() const {
+    size_t numOverridden = 0;
+    for( const Interval &interval : _overrides ) {
+        if( ! interval.range.isLiteral() )
+            return false;
+
+        numOverridden += interval.end - interval.begin;
+    }
+
+    return numOverridden==_numElements || _defaultRange.isLiteral();
+}
+
+} // namespace AST
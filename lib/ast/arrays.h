@@ -9,27 +9,57 @@
 #ifndef AST_ARRAYS_H
 #define AST_ARRAYS_H
 
-#include "ast/bool_value_range.h"
+#include "ast/value_range.h"
+
+#include <vector>
 
 namespace AST {
 
+// The value ranges of an array's elements.
+//
+// Stored as a default range plus a sorted list of the index intervals that override it, so the cost is proportional
+// to the number of overrides rather than to the array's size.
 class ArrayValueRange final : public ValueRangeBase {
 public:
-    // TODO switch to sparse array?
-    std::vector<ValueRangeBase::CPtr> elementsValueRange;
+    // Elements [begin, end) have the value range "range"
+    struct Interval {
+        size_t begin, end;
+        ValueRange range;
+    };
+
+private:
+    size_t _numElements;
+    ValueRange _defaultRange;
+    // Sorted, non-overlapping and non-empty
+    std::vector<Interval> _overrides;
 
-    explicit ArrayValueRange( ValueRangeBase::CPtr elementsDefaultRange, size_t numElements ) :
-        elementsValueRange( numElements, elementsDefaultRange )
+public:
+    explicit ArrayValueRange( const ValueRange &elementsDefaultRange, size_t numElements ) :
+        _numElements( numElements ),
+        _defaultRange( elementsDefaultRange )
     {}
 
-    bool isLiteral() const override {
-        for( auto &range : elementsValueRange ) {
-            if( ! range->isLiteral() )
-                return false;
-        }
+    size_t size() const {
+        return _numElements;
+    }
+
+    const ValueRange &defaultRange() const {
+        return _defaultRange;
+    }
 
-        return true;
+    const std::vector<Interval> &overrides() const {
+        return _overrides;
     }
+
+    const ValueRange &at( size_t index ) const;
+
+    // Set the range of elements [begin, end)
+    void set( size_t begin, size_t end, const ValueRange &range );
+    void set( size_t index, const ValueRange &range ) {
+        set( index, index+1, range );
+    }
+
+    bool isLiteral() const override;
 };
 
 } // namespace AST
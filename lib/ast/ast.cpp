@@ -19,14 +19,15 @@
 
 namespace AST {
 
-JumpPointId::Allocator<> jumpPointAllocator;
-
 LookupContext AST::builtinCtx;
+BuiltinTypes AST::builtinTypes;
+CastTable AST::castTable;
 bool AST::_prepared = false;
 
 // Public methods
 void AST::prepare( BuiltinContextGen *ctxGen ) {
     registerBuiltinTypes( ctxGen );
+    builtinCtx.seal();
     _prepared = true;
 }
 
@@ -34,16 +35,6 @@ bool AST::prepared() {
     return _prepared;
 }
 
-void AST::codeGen( const NonTerminals::Module &parserModule, PracticalSemanticAnalyzer::ModuleGen *codeGen ) {
-    ASSERT( prepared() )<<"codegen called without calling prepare first";
-    module = new Module( parserModule, builtinCtx );
-
-    module->symbolsPass1();
-    module->symbolsPass2();
-
-    module->codeGen( codeGen );
-}
-
 // Private methods
 void AST::registerBuiltinTypes( BuiltinContextGen *ctxGen ) {
     ASSERT( !prepared() )<<"prepare called twice";
@@ -51,37 +42,48 @@ void AST::registerBuiltinTypes( BuiltinContextGen *ctxGen ) {
     // Types
     auto voidType = builtinCtx.registerScalarType(
             ScalarTypeImpl( "Void", "v", 0, 1, ScalarTypeImpl::Type::Void, ctxGen->registerVoidType(), 0 ),
-            new VoidValueRange() );
+            VoidValueRange() );
+    builtinTypes.registerType( BuiltinTypes::Id::Void, voidType );
     auto boolType = builtinCtx.registerScalarType(
             ScalarTypeImpl( "Bool", "b", 1, 1, ScalarTypeImpl::Type::Bool, ctxGen->registerBoolType(), 0 ),
-            BoolValueRange::allocate() );
+            BoolValueRange() );
+    builtinTypes.registerType( BuiltinTypes::Id::Bool, boolType );
     auto s8Type = builtinCtx.registerScalarType(
             ScalarTypeImpl( "S8", "s1", 8, 1, ScalarTypeImpl::Type::SignedInt, ctxGen->registerIntegerType( 8, 1, true ), 1 ),
-            SignedIntValueRange::allocate<int8_t>() );
+            SignedIntValueRange::full<int8_t>() );
+    builtinTypes.registerType( BuiltinTypes::Id::S8, s8Type );
     auto s16Type = builtinCtx.registerScalarType(
             ScalarTypeImpl( "S16", "s2", 16, 2, ScalarTypeImpl::Type::SignedInt, ctxGen->registerIntegerType( 16, 2, true ), 3 ),
-            SignedIntValueRange::allocate<int16_t>() );
+            SignedIntValueRange::full<int16_t>() );
+    builtinTypes.registerType( BuiltinTypes::Id::S16, s16Type );
     auto s32Type = builtinCtx.registerScalarType(
             ScalarTypeImpl( "S32", "s4", 32, 4, ScalarTypeImpl::Type::SignedInt, ctxGen->registerIntegerType( 32, 4, true ), 5 ),
-            SignedIntValueRange::allocate<int32_t>() );
+            SignedIntValueRange::full<int32_t>() );
+    builtinTypes.registerType( BuiltinTypes::Id::S32, s32Type );
     auto s64Type = builtinCtx.registerScalarType(
             ScalarTypeImpl( "S64", "s8", 64, 8, ScalarTypeImpl::Type::SignedInt, ctxGen->registerIntegerType( 64, 8, true ), 7 ),
-            SignedIntValueRange::allocate<int64_t>() );
+            SignedIntValueRange::full<int64_t>() );
+    builtinTypes.registerType( BuiltinTypes::Id::S64, s64Type );
     auto u8Type = builtinCtx.registerScalarType(
             ScalarTypeImpl( "U8", "u1", 8, 1, ScalarTypeImpl::Type::UnsignedInt, ctxGen->registerIntegerType( 8, 1, false ), 0 ),
-            UnsignedIntValueRange::allocate<uint8_t>() );
+            UnsignedIntValueRange::full<uint8_t>() );
+    builtinTypes.registerType( BuiltinTypes::Id::U8, u8Type );
     auto u16Type = builtinCtx.registerScalarType(
             ScalarTypeImpl( "U16", "u2", 16, 2, ScalarTypeImpl::Type::UnsignedInt, ctxGen->registerIntegerType( 16, 2, false ), 2 ),
-            UnsignedIntValueRange::allocate<uint16_t>() );
+            UnsignedIntValueRange::full<uint16_t>() );
+    builtinTypes.registerType( BuiltinTypes::Id::U16, u16Type );
     auto u32Type = builtinCtx.registerScalarType(
             ScalarTypeImpl( "U32", "u4", 32, 4, ScalarTypeImpl::Type::UnsignedInt, ctxGen->registerIntegerType( 32, 4, false ), 4 ),
-            UnsignedIntValueRange::allocate<uint32_t>() );
+            UnsignedIntValueRange::full<uint32_t>() );
+    builtinTypes.registerType( BuiltinTypes::Id::U32, u32Type );
     auto u64Type = builtinCtx.registerScalarType(
             ScalarTypeImpl( "U64", "u8", 64, 8, ScalarTypeImpl::Type::UnsignedInt, ctxGen->registerIntegerType( 64, 8, false ), 6 ),
-            UnsignedIntValueRange::allocate<uint64_t>() );
+            UnsignedIntValueRange::full<uint64_t>() );
+    builtinTypes.registerType( BuiltinTypes::Id::U64, u64Type );
     auto c8Type = builtinCtx.registerScalarType(
             ScalarTypeImpl( "C8", "c1", 8, 1, ScalarTypeImpl::Type::Char, ctxGen->registerCharType( 8, 1, false ), 0 ),
-            UnsignedIntValueRange::allocate<uint8_t>() );
+            UnsignedIntValueRange::full<uint8_t>() );
+    builtinTypes.registerType( BuiltinTypes::Id::C8, c8Type );
 
     // Implicit conversions
     builtinCtx.addCast( s8Type, s16Type, 2, signedExpansionCast, identityVrp,
@@ -155,9 +157,12 @@ void AST::registerBuiltinTypes( BuiltinContextGen *ctxGen ) {
     builtinCtx.addCast( s64Type, u64Type, 1, changeSignCast, signed2UnsignedVrp,
             LookupContext::CastDescriptor::ImplicitCastAllowed::VrpConditional );
 
-    ExpressionImpl::UnaryOp::init(builtinCtx);
-    ExpressionImpl::BinaryOp::init(builtinCtx);
+    // Binary operators first, as some unary operators share their names
+    ExpressionImpl::BinaryOp::init(builtinCtx, builtinTypes);
+    ExpressionImpl::UnaryOp::init(builtinCtx, builtinTypes);
     decayInit();
+
+    castTable.build( builtinCtx, builtinTypes );
 }
 
 } // End namespace AST
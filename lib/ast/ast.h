@@ -12,17 +12,20 @@
 #include <practical/practical.h>
 
 #include "parser.h"
+#include "ast/builtin_types.h"
+#include "ast/cast_table.h"
+#include "ast/compilation_session.h"
 #include "ast/lookup_context.h"
-#include "ast/module.h"
+#include "ast/statistics.h"
 
 namespace AST {
 
-extern JumpPointId::Allocator<> jumpPointAllocator;
-
+// The builtin context, shared by all compilations. Built once by prepare, and only read afterwards.
 class AST {
     static LookupContext builtinCtx;
+    static BuiltinTypes builtinTypes;
+    static CastTable castTable;
     static bool _prepared;
-    Module::Ptr module;
 
 public:
     static void prepare( BuiltinContextGen *ctxGen );
@@ -32,7 +35,18 @@ public:
         return builtinCtx;
     }
 
-    void codeGen(const NonTerminals::Module &module, PracticalSemanticAnalyzer::ModuleGen *codeGen);
+    static const BuiltinTypes &getBuiltinTypes() {
+        return builtinTypes;
+    }
+
+    static const CastTable &getCastTable() {
+        return castTable;
+    }
+
+    // The statistics of the compilation current on this thread
+    static Statistics &getStatistics() {
+        return CompilationSession::current().getStatistics();
+    }
 
 private:
     static void registerBuiltinTypes( BuiltinContextGen *ctxGen );
@@ -9,33 +9,20 @@
 #ifndef AST_BOOL_VALUE_RANGE_H
 #define AST_BOOL_VALUE_RANGE_H
 
-#include "ast/value_range_base.h"
-
-#include <type_traits>
-#include <limits>
-
 namespace AST {
 
-class BoolValueRange final : public ValueRangeBase {
-public:
+struct BoolValueRange {
     bool falseAllowed = true;
     bool trueAllowed = true;
 
+    BoolValueRange() = default;
     BoolValueRange( bool falseAllowed, bool trueAllowed ) :
         falseAllowed(falseAllowed), trueAllowed(trueAllowed)
     {}
 
-    bool isLiteral() const override {
+    bool isLiteral() const {
         return (trueAllowed && !falseAllowed) || (!trueAllowed && falseAllowed);
     }
-
-    static boost::intrusive_ptr<BoolValueRange> allocate( bool falseAllowed, bool trueAllowed ) {
-        return new BoolValueRange( falseAllowed, trueAllowed );
-    }
-
-    static auto allocate() {
-        return allocate( true, true );
-    }
 };
 
 } // namespace AST
@@ -0,0 +1,89 @@
+/* This file is part of the Practical programming langauge. https://github.com/Practical/practical-sa
+ *
+ * To the extent header files enjoy copyright protection, this file is file is copyright (C) 2021 by its authors
+ * You can see the file's authors in the AUTHORS file in the project's home repository.
+ *
+ * This is available under the Boost license. The license's text is available under the LICENSE file in the project's
+ * home directory.
+ */
+#include "ast/build_result.h"
+
+#include "ast/expression/base.h"
+
+#include <practical/errors.h>
+
+using namespace PracticalSemanticAnalyzer;
+
+namespace AST {
+
+BuildResult BuildResult::tooExpensive() {
+    return BuildResult( Status::TooExpensive );
+}
+
+BuildResult BuildResult::noMatchingOverload( const Tokenizer::Token *identifier ) {
+    BuildResult ret( Status::NoMatch );
+    ret._diagnostic = Diagnostic::Overload;
+    ret._identifier = identifier;
+
+    return ret;
+}
+
+BuildResult BuildResult::ambiguousOverloads( const Tokenizer::Token *identifier ) {
+    BuildResult ret( Status::Ambiguous );
+    ret._diagnostic = Diagnostic::Overload;
+    ret._identifier = identifier;
+
+    return ret;
+}
+
+BuildResult BuildResult::castNotAllowed(
+        StaticTypeImpl::CPtr sourceType, StaticTypeImpl::CPtr destinationType, bool implicit,
+        const SourceLocation &location )
+{
+    return castFailure( Status::NoMatch, std::move(sourceType), std::move(destinationType), implicit, location );
+}
+
+BuildResult BuildResult::ambiguousCast(
+        StaticTypeImpl::CPtr sourceType, StaticTypeImpl::CPtr destinationType, bool implicit,
+        const SourceLocation &location )
+{
+    return castFailure( Status::Ambiguous, std::move(sourceType), std::move(destinationType), implicit, location );
+}
+
+void BuildResult::raise() const {
+    switch( _diagnostic ) {
+    case Diagnostic::None:
+        ASSERT( _status==Status::TooExpensive )<<"Failed build result with no diagnostic";
+        throw ExpressionImpl::Base::ExpressionTooExpensive();
+    case Diagnostic::Overload:
+        if( _status==Status::Ambiguous )
+            throw AmbiguousOverloads( _identifier );
+
+        ASSERT( _status==Status::NoMatch )<<"Overload build result raised with status "<<static_cast<int>(_status);
+        throw NoMatchingOverload( _identifier );
+    case Diagnostic::Cast:
+        if( _status==Status::Ambiguous )
+            throw AmbiguousCast( _sourceType, _destinationType, _implicit, _location );
+
+        ASSERT( _status==Status::NoMatch )<<"Cast build result raised with status "<<static_cast<int>(_status);
+        throw CastNotAllowed( _sourceType, _destinationType, _implicit, _location );
+    }
+
+    ABORT()<<"Unreachable code reached";
+}
+
+BuildResult BuildResult::castFailure(
+        Status status, StaticTypeImpl::CPtr &&sourceType, StaticTypeImpl::CPtr &&destinationType, bool implicit,
+        const SourceLocation &location )
+{
+    BuildResult ret( status );
+    ret._diagnostic = Diagnostic::Cast;
+    ret._sourceType = std::move(sourceType);
+    ret._destinationType = std::move(destinationType);
+    ret._implicit = implicit;
+    ret._location = location;
+
+    return ret;
+}
+
+} // namespace AST
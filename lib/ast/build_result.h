@@ -0,0 +1,93 @@
+/* This file is part of the Practical programming langauge. https://github.com/Practical/practical-sa
+ *
+ * To the extent header files enjoy copyright protection, this file is file is copyright (C) 2021 by its authors
+ * You can see the file's authors in the AUTHORS file in the project's home repository.
+ *
+ * This is available under the Boost license. The license's text is available under the LICENSE file in the project's
+ * home directory.
+ */
+#ifndef AST_BUILD_RESULT_H
+#define AST_BUILD_RESULT_H
+
+#include "ast/static_type.h"
+
+#include <practical/practical.h>
+
+namespace Tokenizer {
+    struct Token;
+}
+
+namespace AST {
+
+// Outcome of building an expression or looking up a cast.
+//
+// Overload resolution routinely tries builds that do not fit, so such failures are returned rather than thrown. Only
+// the details needed for the diagnostic are kept. The actual compile error is created by raise(), and only once the
+// failure turns out to be final.
+class [[nodiscard]] BuildResult {
+public:
+    enum class Status {
+        Success,
+        TooExpensive,
+        NoMatch,
+        Ambiguous
+    };
+
+private:
+    enum class Diagnostic {
+        None,
+        Overload,
+        Cast
+    };
+
+    Status _status = Status::Success;
+    Diagnostic _diagnostic = Diagnostic::None;
+
+    // Overload failures
+    const Tokenizer::Token *_identifier = nullptr;
+
+    // Cast failures
+    StaticTypeImpl::CPtr _sourceType, _destinationType;
+    bool _implicit = false;
+    SourceLocation _location;
+
+public:
+    BuildResult() = default;
+
+    static BuildResult tooExpensive();
+    static BuildResult noMatchingOverload( const Tokenizer::Token *identifier );
+    static BuildResult ambiguousOverloads( const Tokenizer::Token *identifier );
+    static BuildResult castNotAllowed(
+            StaticTypeImpl::CPtr sourceType, StaticTypeImpl::CPtr destinationType, bool implicit,
+            const SourceLocation &location );
+    static BuildResult ambiguousCast(
+            StaticTypeImpl::CPtr sourceType, StaticTypeImpl::CPtr destinationType, bool implicit,
+            const SourceLocation &location );
+
+    explicit operator bool() const {
+        return _status==Status::Success;
+    }
+
+    Status getStatus() const {
+        return _status;
+    }
+
+    // Throw the compile error this failure describes
+    [[noreturn]] void raise() const;
+
+    void raiseOnFailure() const {
+        if( _status!=Status::Success )
+            raise();
+    }
+
+private:
+    explicit BuildResult( Status status ) : _status( status ) {}
+
+    static BuildResult castFailure(
+            Status status, StaticTypeImpl::CPtr &&sourceType, StaticTypeImpl::CPtr &&destinationType, bool implicit,
+            const SourceLocation &location );
+};
+
+} // namespace AST
+
+#endif // AST_BUILD_RESULT_H
@@ -0,0 +1,106 @@
+/* This file is part of the Practical programming langauge. https://github.com/Practical/practical-sa
+ *
+ * To the extent header files enjoy copyright protection, this file is file is copyright (C) 2021 by its authors
+ * You can see the file's authors in the AUTHORS file in the project's home repository.
+ *
+ * This is available under the Boost license. The license's text is available under the LICENSE file in the project's
+ * home directory.
+ */
+#ifndef AST_BUILTIN_TYPES_H
+#define AST_BUILTIN_TYPES_H
+
+#include "ast/static_type.h"
+#include "ast/value_range.h"
+#include "asserts.h"
+#include "nocopy.h"
+
+#include <array>
+#include <optional>
+
+namespace AST {
+
+// Direct access to the builtin types, without going through a by-name lookup
+class BuiltinTypes : private NoCopy {
+public:
+    enum class Id {
+        Void,
+        Bool,
+        S8, S16, S32, S64,
+        U8, U16, U32, U64,
+        C8,
+
+        NumIds // Must be last
+    };
+
+    static constexpr size_t NumIds = static_cast<size_t>( Id::NumIds );
+
+private:
+    std::array< StaticTypeImpl::CPtr, NumIds > _types;
+    std::array< ValueRange, NumIds > _defaultRanges;
+
+public:
+    void registerType( Id id, StaticTypeImpl::CPtr type ) {
+        size_t index = static_cast<size_t>(id);
+        ASSERT( index<NumIds )<<"Registering invalid builtin type id "<<index;
+        ASSERT( !_types[index] )<<"Builtin type "<<type<<" registered twice";
+
+        _defaultRanges[index] = type->defaultRange();
+        _types[index] = std::move(type);
+    }
+
+    const StaticTypeImpl::CPtr &get( Id id ) const {
+        const StaticTypeImpl::CPtr &ret = _types[ static_cast<size_t>(id) ];
+        ASSERT( ret )<<"Builtin type "<<static_cast<size_t>(id)<<" used before being registered";
+
+        return ret;
+    }
+
+    const ValueRange &defaultRange( Id id ) const {
+        return _defaultRanges[ static_cast<size_t>(id) ];
+    }
+
+    // Which builtin type this is, ignoring the type's flags. Doesn't require the types to be registered.
+    static std::optional<Id> idOf( const StaticTypeImpl *type ) {
+        auto typeType = type->getType();
+        auto scalar = std::get_if<const PracticalSemanticAnalyzer::StaticType::Scalar *>( &typeType );
+        if( scalar==nullptr )
+            return {};
+
+        using ScalarType = PracticalSemanticAnalyzer::StaticType::Scalar::Type;
+        switch( (*scalar)->getType() ) {
+        case ScalarType::Void:
+            return Id::Void;
+        case ScalarType::Bool:
+            return Id::Bool;
+        case ScalarType::SignedInt:
+            return intBySize( (*scalar)->getSize(), Id::S8 );
+        case ScalarType::UnsignedInt:
+            return intBySize( (*scalar)->getSize(), Id::U8 );
+        case ScalarType::Char:
+            if( (*scalar)->getSize()==8 )
+                return Id::C8;
+            break;
+        }
+
+        return {};
+    }
+
+private:
+    static std::optional<Id> intBySize( size_t bitSize, Id smallest ) {
+        size_t offset;
+        switch( bitSize ) {
+        case 8:  offset = 0; break;
+        case 16: offset = 1; break;
+        case 32: offset = 2; break;
+        case 64: offset = 3; break;
+        default:
+            return {};
+        }
+
+        return static_cast<Id>( static_cast<size_t>(smallest) + offset );
+    }
+};
+
+} // namespace AST
+
+#endif // AST_BUILTIN_TYPES_H
@@ -8,11 +8,11 @@
  */
 #include "ast/cast_chain.h"
 
+#include "ast/ast.h"
+#include "ast/compilation_session.h"
 #include "ast/expression/base.h"
 #include "ast/decay.h"
 
-#include <practical/errors.h>
-
 using namespace PracticalSemanticAnalyzer;
 
 namespace AST {
@@ -23,7 +23,7 @@ static std::vector< StaticTypeImpl::CPtr > castCandidates(
         StaticTypeImpl::CPtr type );
 
 CastChain::CastChain(
-        std::unique_ptr<CastChain> &&previousCast,
+        Arena::Ptr<CastChain> &&previousCast,
         const LookupContext::CastDescriptor &cast,
         const ExpressionImpl::ExpressionMetadata &metadata
     ) :
@@ -33,13 +33,14 @@ CastChain::CastChain(
 {}
 
 CastChain::CastChain(
-        std::unique_ptr<CastChain> &&previousCast,
+        Arena::Ptr<CastChain> &&previousCast,
         const LookupContext::CastDescriptor &cast
     ) :
-        CastChain( std::move(previousCast), cast, { .type = cast.destType } )
+        CastChain( std::move(previousCast), cast, { .type = cast.destType, .valueRange = ValueRange() } )
 {}
 
-std::unique_ptr<CastChain> CastChain::allocate(
+BuildResult CastChain::allocate(
+        Arena::Ptr<CastChain> &result,
         const LookupContext &lookupContext,
         StaticTypeImpl::CPtr destinationType,
         const ExpressionImpl::ExpressionMetadata &srcMetadata,
@@ -50,6 +51,30 @@ std::unique_ptr<CastChain> CastChain::allocate(
     ASSERT( destinationType != srcMetadata.type )<<
             "No point in seeking path from "<<srcMetadata.type<<" to "<<destinationType;
 
+    ASSERT( !result );
+
+    {
+        // Fastpath: cast between builtin types, whose path is precalculated
+        auto tableResult = tableAllocate( result, destinationType, srcMetadata, weight, weightLimit, implicit, location );
+        if( tableResult )
+            return *tableResult;
+    }
+
+    return searchAllocate( result, lookupContext, destinationType, srcMetadata, weight, weightLimit, implicit, location );
+}
+
+BuildResult CastChain::searchAllocate(
+        Arena::Ptr<CastChain> &result,
+        const LookupContext &lookupContext,
+        StaticTypeImpl::CPtr destinationType,
+        const ExpressionImpl::ExpressionMetadata &srcMetadata,
+        Weight &weight, Weight weightLimit,
+        bool implicit, const SourceLocation &location )
+{
+    ASSERT( !result );
+
+    ++AST::getStatistics().castSearches;
+
     {
         // Fastpath: direct cast from source to destination
         auto castDescriptor = lookupContext.lookupCast( srcMetadata.type, destinationType );
@@ -59,10 +84,15 @@ std::unique_ptr<CastChain> CastChain::allocate(
                 castDescriptor->whenPossible!=LookupContext::CastDescriptor::ImplicitCastAllowed::Never )
         {
             if( weight+Weight(castDescriptor->weight) > weightLimit ) {
-                throw ExpressionImpl::Base::ExpressionTooExpensive();
+                return BuildResult::tooExpensive();
             }
+
+            result = fastPathAllocate( castDescriptor, srcMetadata );
+            if( !result )
+                return BuildResult::castNotAllowed( srcMetadata.type, destinationType, implicit, location );
+
             weight += Weight(castDescriptor->weight);
-            return fastPathAllocate( castDescriptor, srcMetadata );
+            return BuildResult();
         }
     }
 
@@ -110,24 +140,24 @@ std::unique_ptr<CastChain> CastChain::allocate(
 
     if( validPaths.empty() ) {
         if( possiblyTooExpensive )
-            throw ExpressionImpl::Base::ExpressionTooExpensive();
+            return BuildResult::tooExpensive();
 
-        return nullptr;
+        return BuildResult::castNotAllowed( srcMetadata.type, destinationType, implicit, location );
     }
 
     if( validPaths.size()>1 )
-        throw AmbiguousCast(srcMetadata.type, destinationType, implicit, location);
+        return BuildResult::ambiguousCast( srcMetadata.type, destinationType, implicit, location );
 
+    Arena &arena = CompilationSession::current().getArena();
     const Junction *currentJunction = validPaths[0];
-    std::unique_ptr<CastChain> ret( new CastChain( nullptr, *currentJunction->descriptor ) );
+    Arena::Ptr<CastChain> ret = arena.make<CastChain>( nullptr, *currentJunction->descriptor );
     CastChain *currentChain = ret.get();
     StaticTypeImpl::CPtr currentType = destinationType;
 
     goto skipAllocation;
 
     while( currentJunction->predecessor ) {
-        currentChain->previousCast = std::unique_ptr<CastChain>(
-                new CastChain(nullptr, *currentJunction->descriptor) );
+        currentChain->previousCast = arena.make<CastChain>( nullptr, *currentJunction->descriptor );
         currentChain = currentChain->previousCast.get();
 
 skipAllocation:
@@ -137,16 +167,12 @@ skipAllocation:
         currentJunction = &paths.at(currentType);
     }
 
-    try {
-        ret->calcVrp( srcMetadata, implicit, location );
-    } catch( CastNotAllowed &ex ) {
-        return nullptr;
-    }
-
-    ASSERT( ret );
+    if( !ret->calcVrp( srcMetadata, implicit, location ) )
+        return BuildResult::castNotAllowed( srcMetadata.type, destinationType, implicit, location );
 
+    result = std::move(ret);
     weight = weightLimit;
-    return ret;
+    return BuildResult();
 }
 
 ExpressionId CastChain::codeGen(
@@ -163,7 +189,88 @@ ExpressionId CastChain::codeGen(
     return cast.codeGen( sourceType, previousResult, metadata.type, functionGen );
 }
 
-std::unique_ptr<CastChain> CastChain::fastPathAllocate(
+ValueRange CastChain::evaluate( const StaticTypeImpl *sourceType, const ValueRange &value ) const {
+    // Casts without VRP do not say which value they produce
+    if( !cast.calcVrp )
+        return ValueRange();
+
+    if( !previousCast )
+        return cast.calcVrp( sourceType, metadata.type.get(), value, true );
+
+    ValueRange previousValue = previousCast->evaluate( sourceType, value );
+    if( !previousValue )
+        return previousValue;
+
+    return cast.calcVrp( previousCast->metadata.type.get(), metadata.type.get(), previousValue, true );
+}
+
+std::optional<BuildResult> CastChain::tableAllocate(
+        Arena::Ptr<CastChain> &result,
+        StaticTypeImpl::CPtr destinationType,
+        const ExpressionImpl::ExpressionMetadata &srcMetadata,
+        Weight &weight, Weight weightLimit,
+        bool implicit, const SourceLocation &location )
+{
+    if( destinationType->getFlags()!=0 )
+        return {};
+
+    bool decayNeeded = false;
+    switch( srcMetadata.type->getFlags() ) {
+    case 0:
+        break;
+    case StaticType::Flags::Reference:
+        decayNeeded = true;
+        break;
+    default:
+        return {};
+    }
+
+    auto sourceId = BuiltinTypes::idOf( srcMetadata.type.get() );
+    auto destinationId = BuiltinTypes::idOf( destinationType.get() );
+    if( !sourceId || !destinationId )
+        return {};
+
+    Weight startWeight = weight;
+    if( decayNeeded )
+        startWeight += ReferenceDecayWeight;
+
+    const CastTable &castTable = AST::getCastTable();
+    const CastTable::Path &path = castTable.lookup( *sourceId, *destinationId );
+    if( !path.reachable ) {
+        // Same as the search, which only knows there is no path if it got to look everywhere
+        if( startWeight + castTable.farthestFrom( *sourceId ) > weightLimit )
+            return BuildResult::tooExpensive();
+
+        return BuildResult::castNotAllowed( srcMetadata.type, destinationType, implicit, location );
+    }
+
+    Weight pathWeight = startWeight + path.weight;
+
+    if( pathWeight > weightLimit )
+        return BuildResult::tooExpensive();
+
+    Arena &arena = CompilationSession::current().getArena();
+    if( decayNeeded ) {
+        result = arena.make<CastChain>(
+                nullptr, *referenceDecayCast(), ExpressionImpl::ExpressionMetadata{
+                    .type = AST::getBuiltinTypes().get( *sourceId ), .valueRange = ValueRange() } );
+    }
+
+    for( const LookupContext::CastDescriptor *cast : path.casts ) {
+        result = arena.make<CastChain>( std::move(result), *cast );
+    }
+    ASSERT( result );
+
+    if( !result->calcVrp( srcMetadata, implicit, location ) ) {
+        result.reset();
+        return BuildResult::castNotAllowed( srcMetadata.type, destinationType, implicit, location );
+    }
+
+    weight = pathWeight;
+    return BuildResult();
+}
+
+Arena::Ptr<CastChain> CastChain::fastPathAllocate(
             const LookupContext::CastDescriptor *castDescriptor,
             const ExpressionImpl::ExpressionMetadata &srcMetadata )
 {
@@ -186,11 +293,10 @@ std::unique_ptr<CastChain> CastChain::fastPathAllocate(
         metadata.valueRange = castDescriptor->destType->defaultRange();
     }
 
-    return std::unique_ptr<CastChain>( new CastChain(
+    return CompilationSession::current().getArena().make<CastChain>(
                 nullptr,
                 *castDescriptor,
-                std::move( metadata ) )
-            );
+                std::move( metadata ) );
 }
 
 static std::vector< StaticTypeImpl::CPtr > castCandidates(
@@ -228,14 +334,16 @@ static std::vector< StaticTypeImpl::CPtr > castCandidates(
     return ret;
 }
 
-void CastChain::calcVrp(
+BuildResult CastChain::calcVrp(
         const ExpressionImpl::ExpressionMetadata &srcMetadata, bool isImplicit, const SourceLocation &location )
 {
     ASSERT( ! metadata.valueRange );
 
     const ExpressionImpl::ExpressionMetadata *prevMetadata = nullptr;
     if( previousCast ) {
-        previousCast->calcVrp( srcMetadata, isImplicit, location );
+        BuildResult result = previousCast->calcVrp( srcMetadata, isImplicit, location );
+        if( !result )
+            return result;
 
         prevMetadata = &previousCast->metadata;
     } else {
@@ -248,8 +356,10 @@ void CastChain::calcVrp(
             prevMetadata->valueRange,
             isImplicit );
 
-    if( metadata.valueRange == nullptr )
-        throw CastNotAllowed( prevMetadata->type, metadata.type, isImplicit, location );
+    if( !metadata.valueRange )
+        return BuildResult::castNotAllowed( prevMetadata->type, metadata.type, isImplicit, location );
+
+    return BuildResult();
 }
 
 } // namespace AST
@@ -10,32 +10,50 @@
 #define AST_CAST_CHAIN_H
 
 #include "ast/expression/expression_metadata.h"
+#include "ast/arena.h"
+#include "ast/build_result.h"
 #include "ast/lookup_context.h"
 #include "ast/static_type.h"
 #include "ast/weight.h"
 
+#include <optional>
+
 namespace AST {
 
 class CastChain {
-    std::unique_ptr<CastChain> previousCast;
+    friend class Arena;
+
+    Arena::Ptr<CastChain> previousCast;
     const LookupContext::CastDescriptor &cast;
     ExpressionImpl::ExpressionMetadata metadata;
 
 private:
     CastChain(
-            std::unique_ptr<CastChain> &&previousCast,
+            Arena::Ptr<CastChain> &&previousCast,
             const LookupContext::CastDescriptor &cast,
             const ExpressionImpl::ExpressionMetadata &metadata
         );
 
     CastChain(
-            std::unique_ptr<CastChain> &&previousCast,
+            Arena::Ptr<CastChain> &&previousCast,
             const LookupContext::CastDescriptor &cast
         );
 
 public:
 
-    static std::unique_ptr<CastChain> allocate(
+    // On success, result holds the chain. On failure it is left empty.
+    static BuildResult allocate(
+            Arena::Ptr<CastChain> &result,
+            const LookupContext &lookupContext,
+            StaticTypeImpl::CPtr destinationType,
+            const ExpressionImpl::ExpressionMetadata &srcMetadata,
+            Weight &weight, Weight weightLimit,
+            bool implicit, const SourceLocation &location );
+
+    // Same as allocate, except that the path is always searched for, rather than taken from the cast table. The table
+    // must hold the paths this finds.
+    static BuildResult searchAllocate(
+            Arena::Ptr<CastChain> &result,
             const LookupContext &lookupContext,
             StaticTypeImpl::CPtr destinationType,
             const ExpressionImpl::ExpressionMetadata &srcMetadata,
@@ -47,7 +65,10 @@ public:
             PracticalSemanticAnalyzer::FunctionGen *functionGen
         ) const;
 
-    const ExpressionImpl::ExpressionMetadata getMetadata() const {
+    // Casts a value computed at compile time
+    ValueRange evaluate( const StaticTypeImpl *sourceType, const ValueRange &value ) const;
+
+    const ExpressionImpl::ExpressionMetadata &getMetadata() const {
         return metadata;
     }
 
@@ -59,11 +80,19 @@ public:
     };
 
 private:
-    static std::unique_ptr<CastChain> fastPathAllocate(
+    // Returns nothing if the cast table does not cover these types
+    static std::optional<BuildResult> tableAllocate(
+            Arena::Ptr<CastChain> &result,
+            StaticTypeImpl::CPtr destinationType,
+            const ExpressionImpl::ExpressionMetadata &srcMetadata,
+            Weight &weight, Weight weightLimit,
+            bool implicit, const SourceLocation &location );
+
+    static Arena::Ptr<CastChain> fastPathAllocate(
             const LookupContext::CastDescriptor *castDescriptor,
             const ExpressionImpl::ExpressionMetadata &srcMetadata );
 
-    void calcVrp(
+    BuildResult calcVrp(
             const ExpressionImpl::ExpressionMetadata &srcMetadata, bool isImplicit,
             const SourceLocation &location );
 };
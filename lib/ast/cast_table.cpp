@@ -0,0 +1,105 @@
+/* This file is part of the Practical programming langauge. https://github.com/Practical/practical-sa
+ *
+ * To the extent header files enjoy copyright protection, this file is file is copyright (C) 2021 by its authors
+ * You can see the file's authors in the AUTHORS file in the project's home repository.
+ *
+ * This is available under the Boost license. The license's text is available under the LICENSE file in the project's
+ * home directory.
+ */
+#include "ast/cast_table.h"
+
+namespace AST {
+
+bool CastTable::Path::implicitlyAllows( ValueRange sourceRange ) const {
+    ASSERT( reachable );
+
+    for( const LookupContext::CastDescriptor *cast : casts ) {
+        if( !cast->calcVrp ) {
+            sourceRange = cast->destType->defaultRange();
+            continue;
+        }
+
+        sourceRange = cast->calcVrp( cast->sourceType.get(), cast->destType.get(), sourceRange, true );
+        if( !sourceRange )
+            return false;
+    }
+
+    return true;
+}
+
+void CastTable::build( const LookupContext &builtinCtx, const BuiltinTypes &builtinTypes ) {
+    for( size_t source=0; source<BuiltinTypes::NumIds; ++source ) {
+        buildFrom( static_cast<BuiltinTypes::Id>(source), builtinCtx, builtinTypes );
+    }
+}
+
+void CastTable::buildFrom(
+        BuiltinTypes::Id source, const LookupContext &builtinCtx, const BuiltinTypes &builtinTypes )
+{
+    // Breadth first, the same way CastChain's search goes, so that the paths are the ones it would find. Every cast adds
+    // to the length, which takes precedence, so a type's path is final once the level before it is done. Casts that are
+    // never implicit are walked too, and of paths of the same weight the first one found is kept.
+    struct Junction {
+        const LookupContext::CastDescriptor *descriptor = nullptr;
+        size_t predecessor = BuiltinTypes::NumIds;
+        Weight weight;
+        bool reached = false;
+    };
+
+    std::array< Junction, BuiltinTypes::NumIds > junctions;
+    junctions[ static_cast<size_t>(source) ].weight = Weight(0, 0);
+    junctions[ static_cast<size_t>(source) ].reached = true;
+
+    std::vector<size_t> pendingCandidates{ static_cast<size_t>(source) }, candidates;
+    while( !pendingCandidates.empty() ) {
+        candidates = std::move( pendingCandidates );
+        pendingCandidates.clear();
+
+        for( size_t current : candidates ) {
+            for(
+                    auto cast = builtinCtx.allCastsFrom( builtinTypes.get( static_cast<BuiltinTypes::Id>(current) ) );
+                    cast; ++cast )
+            {
+                auto destId = BuiltinTypes::idOf( cast->destType.get() );
+                ASSERT( destId )<<"Builtin context has a cast to non-builtin type "<<cast->destType;
+                Junction &dest = junctions[ static_cast<size_t>(*destId) ];
+                Weight pathWeight = junctions[current].weight + Weight( cast->weight );
+
+                if( dest.reached && pathWeight>=dest.weight )
+                    continue;
+
+                if( !dest.reached )
+                    pendingCandidates.push_back( static_cast<size_t>(*destId) );
+
+                dest.descriptor = cast.get();
+                dest.predecessor = current;
+                dest.weight = pathWeight;
+                dest.reached = true;
+            }
+        }
+    }
+
+    Weight &farthest = _farthest[ static_cast<size_t>(source) ];
+    farthest = Weight(0, 0);
+    for( size_t destination=0; destination<BuiltinTypes::NumIds; ++destination ) {
+        Path &path = _paths[ static_cast<size_t>(source)*BuiltinTypes::NumIds + destination ];
+        const Junction &junction = junctions[destination];
+
+        path.casts.clear();
+        path.reachable = junction.reached;
+        path.weight = junction.weight;
+
+        if( !path.reachable )
+            continue;
+
+        if( farthest<path.weight )
+            farthest = path.weight;
+
+        for( size_t current = destination; current!=static_cast<size_t>(source); current = junctions[current].predecessor ) {
+            path.casts.emplace_back( junctions[current].descriptor );
+        }
+        std::reverse( path.casts.begin(), path.casts.end() );
+    }
+}
+
+} // namespace AST
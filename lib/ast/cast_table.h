@@ -0,0 +1,58 @@
+/* This file is part of the Practical programming langauge. https://github.com/Practical/practical-sa
+ *
+ * To the extent header files enjoy copyright protection, this file is file is copyright (C) 2021 by its authors
+ * You can see the file's authors in the AUTHORS file in the project's home repository.
+ *
+ * This is available under the Boost license. The license's text is available under the LICENSE file in the project's
+ * home directory.
+ */
+#ifndef AST_CAST_TABLE_H
+#define AST_CAST_TABLE_H
+
+#include "ast/builtin_types.h"
+#include "ast/lookup_context.h"
+#include "ast/weight.h"
+
+#include <array>
+#include <vector>
+
+namespace AST {
+
+// The cast path between every pair of builtin types that CastChain's search would find. Since casts may only be
+// registered on the builtin context, and that context doesn't change once prepared, these can be calculated once.
+class CastTable : private NoCopy {
+public:
+    struct Path {
+        // The casts to perform, starting from the source type
+        std::vector< const LookupContext::CastDescriptor * > casts;
+        Weight weight;
+        bool reachable = false;
+
+        // Whether an implicit cast along this path accepts a source value with the given range
+        bool implicitlyAllows( ValueRange sourceRange ) const;
+    };
+
+private:
+    std::array< Path, BuiltinTypes::NumIds * BuiltinTypes::NumIds > _paths;
+    std::array< Weight, BuiltinTypes::NumIds > _farthest;
+
+public:
+    void build( const LookupContext &builtinCtx, const BuiltinTypes &builtinTypes );
+
+    const Path &lookup( BuiltinTypes::Id source, BuiltinTypes::Id destination ) const {
+        return _paths[ static_cast<size_t>(source)*BuiltinTypes::NumIds + static_cast<size_t>(destination) ];
+    }
+
+    // The weight of the path to the farthest type reachable from source. A search that gave up on some of those for
+    // being too expensive cannot tell whether an unreachable type is really so.
+    Weight farthestFrom( BuiltinTypes::Id source ) const {
+        return _farthest[ static_cast<size_t>(source) ];
+    }
+
+private:
+    void buildFrom( BuiltinTypes::Id source, const LookupContext &builtinCtx, const BuiltinTypes &builtinTypes );
+};
+
+} // namespace AST
+
+#endif // AST_CAST_TABLE_H
@@ -9,8 +9,6 @@
 #include "ast/casts.h"
 
 #include "ast/expression.h"
-#include "ast/signed_int_value_range.h"
-#include "ast/unsigned_int_value_range.h"
 
 namespace AST {
 
@@ -36,19 +34,19 @@ ExpressionId unsignedExpansionCast(
     return id;
 }
 
-ValueRangeBase::CPtr identityVrp(
+ValueRange identityVrp(
             const StaticTypeImpl *sourceType,
             const StaticTypeImpl *destType,
-            ValueRangeBase::CPtr inputRange,
+            const ValueRange &inputRange,
             bool isImplicit )
 {
     return inputRange;
 }
 
-ValueRangeBase::CPtr unsignedToSignedIdentityVrp(
+ValueRange unsignedToSignedIdentityVrp(
             const StaticTypeImpl *sourceType,
             const StaticTypeImpl *destType,
-            ValueRangeBase::CPtr inputRangeBase,
+            const ValueRange &inputRangeBase,
             bool isImplicit )
 {
     ASSERT(
@@ -58,18 +56,12 @@ ValueRangeBase::CPtr unsignedToSignedIdentityVrp(
             "VRP for unsigned->signed called on input of type "<<
             std::get<const StaticType::Scalar *>(sourceType->getType())->getType();
 
-    ASSERT( dynamic_cast<const UnsignedIntValueRange *>(inputRangeBase.get())!=nullptr );
+    const UnsignedIntValueRange &inputRange = inputRangeBase.get<UnsignedIntValueRange>();
+    const SignedIntValueRange &maximalRange = destType->defaultRange().get<SignedIntValueRange>();
 
-    auto inputRange = static_cast<const UnsignedIntValueRange *>(inputRangeBase.get());
+    ASSERT( inputRange.maximum <= static_cast<LongEnoughInt>( maximalRange.maximum ) );
 
-    auto maximalRange = destType->defaultRange();
-    ASSERT( dynamic_cast<const SignedIntValueRange *>( maximalRange.get() )!=nullptr );
-
-    ASSERT(
-            inputRange->maximum <=
-            static_cast<LongEnoughInt>( static_cast<const SignedIntValueRange *>(maximalRange.get())->maximum ) );
-
-    return SignedIntValueRange::allocate( inputRange->minimum, inputRange->maximum );
+    return SignedIntValueRange( inputRange.minimum, inputRange.maximum );
 }
 
 ExpressionId integerReductionCast(
@@ -83,10 +75,10 @@ ExpressionId integerReductionCast(
     return id;
 }
 
-ValueRangeBase::CPtr unsignedReductionVrp(
+ValueRange unsignedReductionVrp(
             const StaticTypeImpl *sourceType,
             const StaticTypeImpl *destType,
-            ValueRangeBase::CPtr inputRangeBase,
+            const ValueRange &inputRangeBase,
             bool isImplicit )
 {
     ASSERT(
@@ -96,28 +88,24 @@ ValueRangeBase::CPtr unsignedReductionVrp(
             "VRP for unsigned->signed called on input of type "<<
             std::get<const StaticType::Scalar *>(sourceType->getType())->getType();
 
-    ASSERT( dynamic_cast<const UnsignedIntValueRange *>(inputRangeBase.get())!=nullptr );
+    const UnsignedIntValueRange &inputRange = inputRangeBase.get<UnsignedIntValueRange>();
+    const UnsignedIntValueRange &maximalRange = destType->defaultRange().get<UnsignedIntValueRange>();
 
-    auto inputRange = static_cast<const UnsignedIntValueRange *>(inputRangeBase.get());
-
-    auto maximalRange = destType->defaultRange();
-    ASSERT( dynamic_cast<const UnsignedIntValueRange *>( maximalRange.get() )!=nullptr );
-
-    if( inputRange->maximum > static_cast<const UnsignedIntValueRange *>(maximalRange.get())->maximum ) {
+    if( inputRange.maximum > maximalRange.maximum ) {
         // Values out of range
         if( ! isImplicit )
             return maximalRange;
 
-        return ValueRangeBase::CPtr(); // Cannot implicit cast
+        return ValueRange(); // Cannot implicit cast
     } else {
-        return UnsignedIntValueRange::allocate( inputRange->minimum, inputRange->maximum );
+        return UnsignedIntValueRange( inputRange.minimum, inputRange.maximum );
     }
 }
 
-ValueRangeBase::CPtr signedReductionVrp(
+ValueRange signedReductionVrp(
             const StaticTypeImpl *sourceType,
             const StaticTypeImpl *destType,
-            ValueRangeBase::CPtr inputRangeBase,
+            const ValueRange &inputRangeBase,
             bool isImplicit )
 {
     ASSERT(
@@ -127,33 +115,28 @@ ValueRangeBase::CPtr signedReductionVrp(
             "VRP for signed->signed called on input of type "<<
             std::get<const StaticType::Scalar *>(sourceType->getType())->getType();
 
-    ASSERT( dynamic_cast<const SignedIntValueRange *>(inputRangeBase.get())!=nullptr );
-
-    auto inputRange = static_cast<const SignedIntValueRange *>(inputRangeBase.get());
-
-    auto maximalRangeBase = destType->defaultRange();
-    ASSERT( dynamic_cast<const SignedIntValueRange *>( maximalRangeBase.get() )!=nullptr );
-    auto maximalRange = static_cast<const SignedIntValueRange *>(maximalRangeBase.get());
+    const SignedIntValueRange &inputRange = inputRangeBase.get<SignedIntValueRange>();
+    const SignedIntValueRange &maximalRange = destType->defaultRange().get<SignedIntValueRange>();
 
     if(
-            inputRange->maximum > maximalRange->maximum ||
-            inputRange->minimum < maximalRange->minimum
+            inputRange.maximum > maximalRange.maximum ||
+            inputRange.minimum < maximalRange.minimum
       )
     {
         // Values out of range
         if( ! isImplicit )
             return maximalRange;
 
-        return ValueRangeBase::CPtr(); // Cannot implicit cast
+        return ValueRange(); // Cannot implicit cast
     } else {
-        return SignedIntValueRange::allocate( inputRange->minimum, inputRange->maximum );
+        return SignedIntValueRange( inputRange.minimum, inputRange.maximum );
     }
 }
 
-ValueRangeBase::CPtr signed2UnsignedVrp(
+ValueRange signed2UnsignedVrp(
             const StaticTypeImpl *sourceType,
             const StaticTypeImpl *destType,
-            ValueRangeBase::CPtr inputRangeBase,
+            const ValueRange &inputRangeBase,
             bool isImplicit )
 {
     ASSERT(
@@ -163,32 +146,27 @@ ValueRangeBase::CPtr signed2UnsignedVrp(
             "VRP for signed->unsigned called on input of type "<<
             std::get<const StaticType::Scalar *>(sourceType->getType())->getType();
 
-    ASSERT( dynamic_cast<const SignedIntValueRange *>(inputRangeBase.get())!=nullptr );
-
-    auto inputRange = static_cast<const SignedIntValueRange *>(inputRangeBase.get());
-
-    auto maximalRangeBase = destType->defaultRange();
-    ASSERT( dynamic_cast<const UnsignedIntValueRange *>( maximalRangeBase.get() )!=nullptr );
-    auto maximalRange = static_cast<const UnsignedIntValueRange *>(maximalRangeBase.get());
+    const SignedIntValueRange &inputRange = inputRangeBase.get<SignedIntValueRange>();
+    const UnsignedIntValueRange &maximalRange = destType->defaultRange().get<UnsignedIntValueRange>();
 
     if(
-            inputRange->minimum<0
+            inputRange.minimum<0
       )
     {
         // Values out of range
         if( ! isImplicit )
             return maximalRange;
 
-        return ValueRangeBase::CPtr(); // Cannot implicit cast
+        return ValueRange(); // Cannot implicit cast
     } else {
-        return UnsignedIntValueRange::allocate( inputRange->minimum, inputRange->maximum );
+        return UnsignedIntValueRange( inputRange.minimum, inputRange.maximum );
     }
 }
 
-ValueRangeBase::CPtr unsigned2SignedVrp(
+ValueRange unsigned2SignedVrp(
             const StaticTypeImpl *sourceType,
             const StaticTypeImpl *destType,
-            ValueRangeBase::CPtr inputRangeBase,
+            const ValueRange &inputRangeBase,
             bool isImplicit )
 {
     ASSERT(
@@ -198,25 +176,20 @@ ValueRangeBase::CPtr unsigned2SignedVrp(
             "VRP for unsigned->signed ("<<(*sourceType)<<" to "<<(*destType)<<") called on input of type "<<
             std::get<const StaticType::Scalar *>(sourceType->getType())->getType();
 
-    ASSERT( dynamic_cast<const UnsignedIntValueRange *>(inputRangeBase.get())!=nullptr );
-
-    auto inputRange = static_cast<const UnsignedIntValueRange *>(inputRangeBase.get());
-
-    auto maximalRangeBase = destType->defaultRange();
-    ASSERT( dynamic_cast<const SignedIntValueRange *>( maximalRangeBase.get() )!=nullptr );
-    auto maximalRange = static_cast<const SignedIntValueRange *>(maximalRangeBase.get());
+    const UnsignedIntValueRange &inputRange = inputRangeBase.get<UnsignedIntValueRange>();
+    const SignedIntValueRange &maximalRange = destType->defaultRange().get<SignedIntValueRange>();
 
     if(
-            inputRange->maximum > maximalRange->maximum
+            inputRange.maximum > static_cast<LongEnoughInt>( maximalRange.maximum )
       )
     {
         // Values out of range
         if( ! isImplicit )
             return maximalRange;
 
-        return ValueRangeBase::CPtr(); // Cannot implicit cast
+        return ValueRange(); // Cannot implicit cast
     } else {
-        return SignedIntValueRange::allocate( inputRange->minimum, inputRange->maximum );
+        return SignedIntValueRange( inputRange.minimum, inputRange.maximum );
     }
 }
 
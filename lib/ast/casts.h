@@ -10,7 +10,7 @@
 #define AST_CASTS_H
 
 #include "ast/static_type.h"
-#include "ast/value_range_base.h"
+#include "ast/value_range.h"
 
 #include <practical/practical.h>
 
@@ -28,17 +28,17 @@ ExpressionId unsignedExpansionCast(
             PracticalSemanticAnalyzer::StaticType::CPtr destType,
             PracticalSemanticAnalyzer::FunctionGen *functionGen);
 
-ValueRangeBase::CPtr identityVrp(
+ValueRange identityVrp(
             const StaticTypeImpl *sourceType,
             const StaticTypeImpl *destType,
-            ValueRangeBase::CPtr inputRange,
+            const ValueRange &inputRange,
             bool isImplicit
         );
 
-ValueRangeBase::CPtr unsignedToSignedIdentityVrp(
+ValueRange unsignedToSignedIdentityVrp(
             const StaticTypeImpl *sourceType,
             const StaticTypeImpl *destType,
-            ValueRangeBase::CPtr inputRange,
+            const ValueRange &inputRange,
             bool isImplicit
         );
 
@@ -47,31 +47,31 @@ ExpressionId integerReductionCast(
             PracticalSemanticAnalyzer::StaticType::CPtr destType,
             PracticalSemanticAnalyzer::FunctionGen *functionGen);
 
-ValueRangeBase::CPtr unsignedReductionVrp(
+ValueRange unsignedReductionVrp(
             const StaticTypeImpl *sourceType,
             const StaticTypeImpl *destType,
-            ValueRangeBase::CPtr inputRange,
+            const ValueRange &inputRange,
             bool isImplicit
         );
 
-ValueRangeBase::CPtr signedReductionVrp(
+ValueRange signedReductionVrp(
             const StaticTypeImpl *sourceType,
             const StaticTypeImpl *destType,
-            ValueRangeBase::CPtr inputRange,
+            const ValueRange &inputRange,
             bool isImplicit
         );
 
-ValueRangeBase::CPtr signed2UnsignedVrp(
+ValueRange signed2UnsignedVrp(
             const StaticTypeImpl *sourceType,
             const StaticTypeImpl *destType,
-            ValueRangeBase::CPtr inputRange,
+            const ValueRange &inputRange,
             bool isImplicit
         );
 
-ValueRangeBase::CPtr unsigned2SignedVrp(
+ValueRange unsigned2SignedVrp(
             const StaticTypeImpl *sourceType,
             const StaticTypeImpl *destType,
-            ValueRangeBase::CPtr inputRange,
+            const ValueRange &inputRange,
             bool isImplicit
         );
 
@@ -0,0 +1,73 @@
+/* This file is part of the Practical programming langauge. https://github.com/Practical/practical-sa
+ *
+ * To the extent header files enjoy copyright protection, this file is file is copyright (C) 2021 by its authors
+ * You can see the file's authors in the AUTHORS file in the project's home repository.
+ *
+ * This is available under the Boost license. The license's text is available under the LICENSE file in the project's
+ * home directory.
+ */
+#include "ast/compilation_session.h"
+
+#include "ast/ast.h"
+
+namespace AST {
+
+thread_local CompilationSession *CompilationSession::_current = nullptr;
+
+Statistics *Statistics::current() {
+    CompilationSession *session = CompilationSession::currentOrNull();
+
+    return session!=nullptr ? &session->getStatistics() : nullptr;
+}
+
+CompilationSession::CompilationSession( MemoryLimit *memory ) :
+    _memoryLimit( memory ),
+    _arena( memory!=nullptr ? memory : std::pmr::new_delete_resource() )
+{}
+
+CompilationSession::CompilationSession( size_t functionIndex, MemoryLimit *memory ) :
+    _expressionIds( PracticalSemanticAnalyzer::ExpressionId( (functionIndex+1) << FunctionIdBits ) ),
+    _jumpPoints( PracticalSemanticAnalyzer::JumpPointId( (functionIndex+1) << FunctionIdBits ) ),
+    _memoryLimit( memory ),
+    _arena( memory!=nullptr ? memory : std::pmr::new_delete_resource() ),
+    _functionIndex( functionIndex )
+{
+    // The block's number must fit in the upper half of the ids
+    using IdType = PracticalSemanticAnalyzer::ExpressionId::UnderlyingType;
+    ASSERT( ( static_cast<IdType>(functionIndex+1) >> FunctionIdBits )==0 )<<
+            "Module has too many functions for the function id blocks";
+}
+
+void CompilationSession::codeGen(
+        const NonTerminals::Module &parserModule,
+        String fileName,
+        const PracticalSemanticAnalyzer::CompilerArguments &arguments,
+        PracticalSemanticAnalyzer::ModuleGen *codeGen )
+{
+    Scope scope( *this );
+
+    startModule( parserModule, fileName );
+    finishModule( arguments, codeGen );
+}
+
+void CompilationSession::startModule( const NonTerminals::Module &parserModule, String fileName ) {
+    ASSERT( AST::prepared() )<<"codegen called without calling prepare first";
+    ASSERT( !_module )<<"A session compiles a single module";
+
+    _module = new Module( parserModule, fileName, AST::getBuiltinCtx() );
+}
+
+void CompilationSession::symbolsPass1() {
+    _module->symbolsPass1( false );
+}
+
+void CompilationSession::finishModule(
+        const PracticalSemanticAnalyzer::CompilerArguments &arguments, PracticalSemanticAnalyzer::ModuleGen *codeGen )
+{
+    _module->symbolsPass1();
+    _module->symbolsPass2();
+
+    _module->codeGen( arguments, codeGen );
+}
+
+} // namespace AST
@@ -0,0 +1,167 @@
+/* This file is part of the Practical programming langauge. https://github.com/Practical/practical-sa
+ *
+ * To the extent header files enjoy copyright protection, this file is file is copyright (C) 2021 by its authors
+ * You can see the file's authors in the AUTHORS file in the project's home repository.
+ *
+ * This is available under the Boost license. The license's text is available under the LICENSE file in the project's
+ * home directory.
+ */
+#ifndef AST_COMPILATION_SESSION_H
+#define AST_COMPILATION_SESSION_H
+
+#include "ast/arena.h"
+#include "ast/memory_limit.h"
+#include "ast/module.h"
+#include "ast/statistics.h"
+#include "parser.h"
+
+#include <practical/practical.h>
+
+#include <limits>
+#include <vector>
+
+namespace AST {
+
+class Function;
+
+// Everything a single compilation changes.
+//
+// The builtin context AST::prepare builds is shared by all sessions, and is only read once prepared. A session is
+// made current on a thread for as long as it compiles, so that different threads can run separate compilations.
+//
+// Each of the module's functions is analyzed in a session of its own, so that functions can be analyzed on different
+// threads. The objects a function's analysis creates are allocated from its session's arena, and released with it.
+class CompilationSession : private NoCopy {
+public:
+    static constexpr size_t NotAFunction = std::numeric_limits<size_t>::max();
+
+private:
+    // Function sessions allocate ids from a block of their own, so that the ids do not depend on which thread got to
+    // the function first. The blocks take the upper half of the ids. DenseIdsGen renumbers them when the functions are
+    // handed out in order.
+    static constexpr unsigned FunctionIdBits = sizeof( PracticalSemanticAnalyzer::ExpressionId::UnderlyingType ) * 4;
+    static_assert( sizeof( PracticalSemanticAnalyzer::JumpPointId::UnderlyingType ) * 4 == FunctionIdBits );
+
+    Statistics _statistics;
+    PracticalSemanticAnalyzer::ExpressionId::Allocator<> _expressionIds;
+    PracticalSemanticAnalyzer::JumpPointId::Allocator<> _jumpPoints;
+    PracticalSemanticAnalyzer::ModuleId::Allocator<> _moduleIds;
+    // Null if the compilation's memory is not counted
+    MemoryLimit *_memoryLimit = nullptr;
+    // Must outlive the objects allocated from it, including the module
+    Arena _arena;
+    Module::Ptr _module;
+    size_t _functionIndex = NotAFunction;
+    // Released functions rebuilt to evaluate calls to them while analyzing this session's function
+    std::vector<Function *> _rebuiltFunctions;
+
+    static thread_local CompilationSession *_current;
+
+public:
+    // Makes the session current on this thread for as long as it lives
+    class Scope : private NoCopy {
+        CompilationSession *_previous;
+
+    public:
+        explicit Scope( CompilationSession &session ) : _previous( _current ) {
+            _current = &session;
+        }
+
+        ~Scope() {
+            _current = _previous;
+        }
+    };
+
+    CompilationSession() = default;
+    // Allocates the analysis objects from memory, and charges it for the memory allocated elsewhere
+    explicit CompilationSession( MemoryLimit *memory );
+    // The session analyzing the module's function with the given index, in source order
+    CompilationSession( size_t functionIndex, MemoryLimit *memory );
+
+    static CompilationSession &current() {
+        ASSERT( _current!=nullptr )<<"No compilation session is current on this thread";
+        return *_current;
+    }
+
+    static CompilationSession *currentOrNull() {
+        return _current;
+    }
+
+    void codeGen(
+            const NonTerminals::Module &parserModule,
+            String fileName,
+            const PracticalSemanticAnalyzer::CompilerArguments &arguments,
+            PracticalSemanticAnalyzer::ModuleGen *codeGen );
+
+    // The steps codeGen goes through, for analyzing a module while it is being parsed. The session must be current.
+    // symbolsPass1 registers the items the parser added so far, and finishModule completes the analysis once the
+    // module is fully parsed.
+    void startModule( const NonTerminals::Module &parserModule, String fileName );
+    void symbolsPass1();
+    void finishModule(
+            const PracticalSemanticAnalyzer::CompilerArguments &arguments, PracticalSemanticAnalyzer::ModuleGen *codeGen );
+
+    // Whether an id was allocated by one of the function sessions, rather than by the module's session
+    static bool isFunctionId( unsigned long id ) {
+        return ( id >> FunctionIdBits ) != 0;
+    }
+
+    size_t getFunctionIndex() const {
+        return _functionIndex;
+    }
+
+    // Adds the statistics of one of the module's function sessions to this one's
+    void mergeStatistics( const CompilationSession &functionSession ) {
+        _statistics += functionSession._statistics;
+    }
+
+    Statistics &getStatistics() {
+        return _statistics;
+    }
+
+    Arena &getArena() {
+        return _arena;
+    }
+
+    MemoryLimit *getMemoryLimit() const {
+        return _memoryLimit;
+    }
+
+    // Counts memory not allocated from the arena, such as tokens and parse tree nodes, against the memory limit
+    void chargeMemory( size_t bytes ) {
+        if( _memoryLimit!=nullptr )
+            _memoryLimit->charge( bytes );
+    }
+
+    void refundMemory( size_t bytes ) {
+        if( _memoryLimit!=nullptr )
+            _memoryLimit->refund( bytes );
+    }
+
+    void addRebuiltFunction( Function *function ) {
+        _rebuiltFunctions.emplace_back( function );
+    }
+
+    std::vector<Function *> takeRebuiltFunctions() {
+        std::vector<Function *> rebuiltFunctions;
+        rebuiltFunctions.swap( _rebuiltFunctions );
+
+        return rebuiltFunctions;
+    }
+
+    PracticalSemanticAnalyzer::ExpressionId allocateExpressionId() {
+        return _expressionIds.allocate();
+    }
+
+    PracticalSemanticAnalyzer::JumpPointId allocateJumpPoint() {
+        return _jumpPoints.allocate();
+    }
+
+    PracticalSemanticAnalyzer::ModuleId allocateModuleId() {
+        return _moduleIds.allocate();
+    }
+};
+
+} // namespace AST
+
+#endif // AST_COMPILATION_SESSION_H
@@ -26,4 +26,8 @@ void CompoundStatement::codeGen( PracticalSemanticAnalyzer::FunctionGen *functio
     statementList.codeGen( lookupCtx, functionGen );
 }
 
+bool CompoundStatement::evaluate( Interpreter &interpreter ) const {
+    return statementList.evaluate( lookupCtx, interpreter );
+}
+
 } // namespace AST
@@ -23,6 +23,7 @@ public:
     explicit CompoundStatement( const NonTerminals::CompoundStatement &parserCompound, const LookupContext &parentCtx );
     void buildAST();
     void codeGen( PracticalSemanticAnalyzer::FunctionGen *functionGen ) const;
+    bool evaluate( Interpreter &interpreter ) const;
 };
 
 } // namespace AST
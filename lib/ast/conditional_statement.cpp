@@ -7,7 +7,9 @@
  * home directory.
  */
 #include "ast/ast.h"
+#include "ast/compilation_session.h"
 #include "ast/conditional_statement.h"
+#include "ast/interpreter.h"
 #include "ast/statement.h"
 
 namespace AST {
@@ -16,32 +18,57 @@ ConditionalStatement::ConditionalStatement( const NonTerminals::Statement::Condi
     condition( parserCondition.condition )
 {
     ASSERT( parserCondition.ifClause );
-    ifClause = safenew<Statement>( *parserCondition.ifClause );
+    Arena &arena = CompilationSession::current().getArena();
+    ifClause = arena.make<Statement>( *parserCondition.ifClause );
 
     if( parserCondition.elseClause ) {
-        elseClause = safenew<Statement>( *parserCondition.elseClause );
+        elseClause = arena.make<Statement>( *parserCondition.elseClause );
     }
 }
 
 void ConditionalStatement::buildAST( LookupContext &lookupCtx ) {
     Weight weight;
-    auto boolType = AST::getBuiltinCtx().lookupType("Bool");
+    const StaticTypeImpl::CPtr &boolType = AST::getBuiltinTypes().get( BuiltinTypes::Id::Bool );
     condition.buildAST(lookupCtx, boolType, weight, Expression::NoWeightLimit);
-    ifClause->buildAST(lookupCtx);
-    if( elseClause )
+
+    {
+        LookupContext::RangeNarrowing narrowing( lookupCtx );
+        condition.narrowRanges( true, narrowing );
+        ifClause->buildAST(lookupCtx);
+    }
+
+    if( elseClause ) {
+        LookupContext::RangeNarrowing narrowing( lookupCtx );
+        condition.narrowRanges( false, narrowing );
         elseClause->buildAST(lookupCtx);
+    }
 }
 
 void ConditionalStatement::codeGen(
         const LookupContext &lookupCtx, PracticalSemanticAnalyzer::FunctionGen *functionGen ) const
 {
+    const ValueRange &conditionRange = condition.getValueRange();
+    if( conditionRange.isLiteral() ) {
+        ++AST::getStatistics().branchesEliminated;
+
+        if( condition.hasSideEffects() )
+            condition.codeGen(functionGen);
+
+        if( conditionRange.get<BoolValueRange>().trueAllowed )
+            ifClause->codeGen( lookupCtx, functionGen );
+        else if( elseClause )
+            elseClause->codeGen( lookupCtx, functionGen );
+
+        return;
+    }
+
     ExpressionId conditionResult = condition.codeGen(functionGen);
     JumpPointId elsePoint, contPoint;
     if( elseClause ) {
-        elsePoint = jumpPointAllocator.allocate();
+        elsePoint = CompilationSession::current().allocateJumpPoint();
     }
     // It's a silly thing to do, but make sure that the continuation jump point it higher than the else jump point
-    contPoint = jumpPointAllocator.allocate();
+    contPoint = CompilationSession::current().allocateJumpPoint();
 
     functionGen->conditionalBranch( ExpressionId(), StaticType::CPtr(), conditionResult, elsePoint, contPoint );
 
@@ -55,4 +82,18 @@ void ConditionalStatement::codeGen(
     functionGen->setJumpPoint( contPoint );
 }
 
+bool ConditionalStatement::evaluate( const LookupContext &lookupCtx, Interpreter &interpreter ) const {
+    ValueRange conditionValue = condition.evaluate(interpreter);
+    if( !conditionValue )
+        return false;
+
+    if( conditionValue.get<BoolValueRange>().trueAllowed )
+        return ifClause->evaluate( lookupCtx, interpreter );
+
+    if( elseClause )
+        return elseClause->evaluate( lookupCtx, interpreter );
+
+    return true;
+}
+
 } // namespace AST
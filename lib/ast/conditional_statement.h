@@ -9,6 +9,7 @@
 #ifndef AST_CONDITIONAL_STATEMENT_H
 #define AST_CONDITIONAL_STATEMENT_H
 
+#include "arena.h"
 #include "expression.h"
 #include "lookup_context.h"
 #include "parser.h"
@@ -19,13 +20,15 @@ class Statement;
 
 class ConditionalStatement {
     Expression condition;
-    std::unique_ptr<Statement> ifClause, elseClause;
+    Arena::Ptr<Statement> ifClause, elseClause;
 
 public:
     explicit ConditionalStatement( const NonTerminals::Statement::ConditionalStatement &parserCondition );
 
     void buildAST( LookupContext &lookupCtx );
     void codeGen( const LookupContext &lookupCtx, PracticalSemanticAnalyzer::FunctionGen *functionGen ) const;
+    // Returns false if the statement cannot be evaluated at compile time
+    bool evaluate( const LookupContext &lookupCtx, Interpreter &interpreter ) const;
 };
 
 } // namespace AST::ExpressionImpl
@@ -24,10 +24,10 @@ static ExpressionId referenceToBuiltinValueCodegen(
     return resultId;
 }
 
-ValueRangeBase::CPtr referenceToBuiltinValueVrp(
+ValueRange referenceToBuiltinValueVrp(
             const StaticTypeImpl *sourceType,
             const StaticTypeImpl *destType,
-            ValueRangeBase::CPtr inputRange,
+            const ValueRange &inputRange,
             bool isImplicit
         )
 {
@@ -53,6 +53,10 @@ static const std::unordered_map< DecayCasts, LookupContext::CastDescriptor > dec
 void decayInit() {
 }
 
+const LookupContext::CastDescriptor *referenceDecayCast() {
+    return &decayCasts.at(DecayCasts::ReferenceToBuiltinValue);
+}
+
 std::vector< StaticTypeImpl::CPtr > decay(
             std::unordered_map< StaticTypeImpl::CPtr, CastChain::Junction > &paths,
             StaticTypeImpl::CPtr type )
@@ -63,9 +67,9 @@ std::vector< StaticTypeImpl::CPtr > decay(
         paths.emplace(
                 decayedType,
                 CastChain::Junction{
-                    .descriptor = &decayCasts.at(DecayCasts::ReferenceToBuiltinValue),
+                    .descriptor = referenceDecayCast(),
                     .predecessor = type,
-                    .pathWeight=paths.at(type).pathWeight+Weight(1, 0) }
+                    .pathWeight=paths.at(type).pathWeight+ReferenceDecayWeight }
             );
         return RetType{ decayedType };
     }
@@ -15,6 +15,10 @@ namespace AST {
 
 void decayInit();
 
+static constexpr Weight ReferenceDecayWeight = Weight(1, 0);
+// The cast used for turning a reference into the value it refers to
+const LookupContext::CastDescriptor *referenceDecayCast();
+
 std::vector< StaticTypeImpl::CPtr > decay(
         std::unordered_map< StaticTypeImpl::CPtr, CastChain::Junction > &paths,
         StaticTypeImpl::CPtr type );
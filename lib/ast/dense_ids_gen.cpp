@@ -0,0 +1,279 @@
+/* This file is part of the Practical programming langauge. https://github.com/Practical/practical-sa
+ *
+ * To the extent header files enjoy copyright protection, this file is file is copyright (C) 2021 by its authors
+ * You can see the file's authors in the AUTHORS file in the project's home repository.
+ *
+ * This is available under the Boost license. The license's text is available under the LICENSE file in the project's
+ * home directory.
+ */
+#include "ast/dense_ids_gen.h"
+
+#include <vector>
+
+namespace AST {
+
+void DenseIdsGen::functionEnter(
+        String name, StaticType::CPtr returnType, Slice<const PracticalSemanticAnalyzer::ArgumentDeclaration> arguments,
+        String file, const PracticalSemanticAnalyzer::SourceLocation &location )
+{
+    std::vector<PracticalSemanticAnalyzer::ArgumentDeclaration> mappedArguments;
+    mappedArguments.reserve( arguments.size() );
+    for( const auto &argument : arguments )
+        mappedArguments.emplace_back( argument.type, argument.name, map( argument.lvalueId ) );
+
+    _backend->functionEnter( name, returnType, mappedArguments, file, location );
+}
+
+void DenseIdsGen::functionLeave() {
+    _backend->functionLeave();
+}
+
+void DenseIdsGen::returnValue( ExpressionId id ) {
+    _backend->returnValue( map(id) );
+}
+
+void DenseIdsGen::returnValue() {
+    _backend->returnValue();
+}
+
+void DenseIdsGen::conditionalBranch(
+        ExpressionId id, StaticType::CPtr type, ExpressionId conditionExpression, JumpPointId elsePoint,
+        JumpPointId continuationPoint )
+{
+    // Mapped in order, so that the new ids do not depend on the order the compiler evaluates arguments in
+    ExpressionId mappedId = map(id), mappedCondition = map(conditionExpression);
+    JumpPointId mappedElse = map(elsePoint), mappedContinuation = map(continuationPoint);
+
+    _backend->conditionalBranch( mappedId, type, mappedCondition, mappedElse, mappedContinuation );
+}
+
+void DenseIdsGen::setConditionClauseResult( ExpressionId id ) {
+    _backend->setConditionClauseResult( map(id) );
+}
+
+void DenseIdsGen::setJumpPoint( JumpPointId id, String name ) {
+    _backend->setJumpPoint( map(id), name );
+}
+
+void DenseIdsGen::jump( JumpPointId destination ) {
+    _backend->jump( map(destination) );
+}
+
+void DenseIdsGen::setLiteral( ExpressionId id, LongEnoughInt value, StaticType::CPtr type ) {
+    _backend->setLiteral( map(id), value, type );
+}
+
+void DenseIdsGen::setLiteral( ExpressionId id, bool value ) {
+    _backend->setLiteral( map(id), value );
+}
+
+void DenseIdsGen::setLiteral( ExpressionId id, String value ) {
+    _backend->setLiteral( map(id), value );
+}
+
+void DenseIdsGen::setLiteralNull( ExpressionId id, StaticType::CPtr type ) {
+    _backend->setLiteralNull( map(id), type );
+}
+
+void DenseIdsGen::allocateStackVar( ExpressionId id, StaticType::CPtr type, String name ) {
+    _backend->allocateStackVar( map(id), type, name );
+}
+
+void DenseIdsGen::assign( ExpressionId lvalue, ExpressionId rvalue ) {
+    ExpressionId mappedLvalue = map(lvalue);
+    _backend->assign( mappedLvalue, map(rvalue) );
+}
+
+void DenseIdsGen::dereferencePointer( ExpressionId id, StaticType::CPtr type, ExpressionId addr ) {
+    ExpressionId mappedId = map(id);
+    _backend->dereferencePointer( mappedId, type, map(addr) );
+}
+
+void DenseIdsGen::truncateInteger(
+        ExpressionId id, ExpressionId source, StaticType::CPtr sourceType, StaticType::CPtr destType )
+{
+    ExpressionId mappedId = map(id);
+    _backend->truncateInteger( mappedId, map(source), sourceType, destType );
+}
+
+void DenseIdsGen::changeIntegerSign(
+        ExpressionId id, ExpressionId source, StaticType::CPtr sourceType, StaticType::CPtr destType )
+{
+    ExpressionId mappedId = map(id);
+    _backend->changeIntegerSign( mappedId, map(source), sourceType, destType );
+}
+
+void DenseIdsGen::expandIntegerSigned(
+        ExpressionId id, ExpressionId source, StaticType::CPtr sourceType, StaticType::CPtr destType )
+{
+    ExpressionId mappedId = map(id);
+    _backend->expandIntegerSigned( mappedId, map(source), sourceType, destType );
+}
+
+void DenseIdsGen::expandIntegerUnsigned(
+        ExpressionId id, ExpressionId source, StaticType::CPtr sourceType, StaticType::CPtr destType )
+{
+    ExpressionId mappedId = map(id);
+    _backend->expandIntegerUnsigned( mappedId, map(source), sourceType, destType );
+}
+
+void DenseIdsGen::callFunctionDirect(
+        ExpressionId id, String name, Slice<const ExpressionId> arguments, StaticType::CPtr returnType )
+{
+    ExpressionId mappedId = map(id);
+    std::vector<ExpressionId> mappedArguments;
+    mappedArguments.reserve( arguments.size() );
+    for( ExpressionId argument : arguments )
+        mappedArguments.emplace_back( map(argument) );
+
+    _backend->callFunctionDirect( mappedId, name, mappedArguments, returnType );
+}
+
+void DenseIdsGen::binaryOperatorPlusUnsigned(
+        ExpressionId id, ExpressionId left, ExpressionId right, StaticType::CPtr resultType )
+{
+    ExpressionId mappedId = map(id), mappedLeft = map(left);
+    _backend->binaryOperatorPlusUnsigned( mappedId, mappedLeft, map(right), resultType );
+}
+
+void DenseIdsGen::binaryOperatorPlusSigned(
+        ExpressionId id, ExpressionId left, ExpressionId right, StaticType::CPtr resultType )
+{
+    ExpressionId mappedId = map(id), mappedLeft = map(left);
+    _backend->binaryOperatorPlusSigned( mappedId, mappedLeft, map(right), resultType );
+}
+
+void DenseIdsGen::binaryOperatorMinusUnsigned(
+        ExpressionId id, ExpressionId left, ExpressionId right, StaticType::CPtr resultType )
+{
+    ExpressionId mappedId = map(id), mappedLeft = map(left);
+    _backend->binaryOperatorMinusUnsigned( mappedId, mappedLeft, map(right), resultType );
+}
+
+void DenseIdsGen::binaryOperatorMinusSigned(
+        ExpressionId id, ExpressionId left, ExpressionId right, StaticType::CPtr resultType )
+{
+    ExpressionId mappedId = map(id), mappedLeft = map(left);
+    _backend->binaryOperatorMinusSigned( mappedId, mappedLeft, map(right), resultType );
+}
+
+void DenseIdsGen::binaryOperatorMultiplyUnsigned(
+        ExpressionId id, ExpressionId left, ExpressionId right, StaticType::CPtr resultType )
+{
+    ExpressionId mappedId = map(id), mappedLeft = map(left);
+    _backend->binaryOperatorMultiplyUnsigned( mappedId, mappedLeft, map(right), resultType );
+}
+
+void DenseIdsGen::binaryOperatorMultiplySigned(
+        ExpressionId id, ExpressionId left, ExpressionId right, StaticType::CPtr resultType )
+{
+    ExpressionId mappedId = map(id), mappedLeft = map(left);
+    _backend->binaryOperatorMultiplySigned( mappedId, mappedLeft, map(right), resultType );
+}
+
+void DenseIdsGen::binaryOperatorDivideUnsigned(
+        ExpressionId id, ExpressionId left, ExpressionId right, StaticType::CPtr resultType )
+{
+    ExpressionId mappedId = map(id), mappedLeft = map(left);
+    _backend->binaryOperatorDivideUnsigned( mappedId, mappedLeft, map(right), resultType );
+}
+
+void DenseIdsGen::operatorEquals(
+        ExpressionId id, ExpressionId left, ExpressionId right, StaticType::CPtr resultType )
+{
+    ExpressionId mappedId = map(id), mappedLeft = map(left);
+    _backend->operatorEquals( mappedId, mappedLeft, map(right), resultType );
+}
+
+void DenseIdsGen::operatorNotEquals(
+        ExpressionId id, ExpressionId left, ExpressionId right, StaticType::CPtr resultType )
+{
+    ExpressionId mappedId = map(id), mappedLeft = map(left);
+    _backend->operatorNotEquals( mappedId, mappedLeft, map(right), resultType );
+}
+
+void DenseIdsGen::operatorLessThanUnsigned(
+        ExpressionId id, ExpressionId left, ExpressionId right, StaticType::CPtr resultType )
+{
+    ExpressionId mappedId = map(id), mappedLeft = map(left);
+    _backend->operatorLessThanUnsigned( mappedId, mappedLeft, map(right), resultType );
+}
+
+void DenseIdsGen::operatorLessThanSigned(
+        ExpressionId id, ExpressionId left, ExpressionId right, StaticType::CPtr resultType )
+{
+    ExpressionId mappedId = map(id), mappedLeft = map(left);
+    _backend->operatorLessThanSigned( mappedId, mappedLeft, map(right), resultType );
+}
+
+void DenseIdsGen::operatorLessThanOrEqualsUnsigned(
+        ExpressionId id, ExpressionId left, ExpressionId right, StaticType::CPtr resultType )
+{
+    ExpressionId mappedId = map(id), mappedLeft = map(left);
+    _backend->operatorLessThanOrEqualsUnsigned( mappedId, mappedLeft, map(right), resultType );
+}
+
+void DenseIdsGen::operatorLessThanOrEqualsSigned(
+        ExpressionId id, ExpressionId left, ExpressionId right, StaticType::CPtr resultType )
+{
+    ExpressionId mappedId = map(id), mappedLeft = map(left);
+    _backend->operatorLessThanOrEqualsSigned( mappedId, mappedLeft, map(right), resultType );
+}
+
+void DenseIdsGen::operatorGreaterThanUnsigned(
+        ExpressionId id, ExpressionId left, ExpressionId right, StaticType::CPtr resultType )
+{
+    ExpressionId mappedId = map(id), mappedLeft = map(left);
+    _backend->operatorGreaterThanUnsigned( mappedId, mappedLeft, map(right), resultType );
+}
+
+void DenseIdsGen::operatorGreaterThanSigned(
+        ExpressionId id, ExpressionId left, ExpressionId right, StaticType::CPtr resultType )
+{
+    ExpressionId mappedId = map(id), mappedLeft = map(left);
+    _backend->operatorGreaterThanSigned( mappedId, mappedLeft, map(right), resultType );
+}
+
+void DenseIdsGen::operatorGreaterThanOrEqualsUnsigned(
+        ExpressionId id, ExpressionId left, ExpressionId right, StaticType::CPtr resultType )
+{
+    ExpressionId mappedId = map(id), mappedLeft = map(left);
+    _backend->operatorGreaterThanOrEqualsUnsigned( mappedId, mappedLeft, map(right), resultType );
+}
+
+void DenseIdsGen::operatorGreaterThanOrEqualsSigned(
+        ExpressionId id, ExpressionId left, ExpressionId right, StaticType::CPtr resultType )
+{
+    ExpressionId mappedId = map(id), mappedLeft = map(left);
+    _backend->operatorGreaterThanOrEqualsSigned( mappedId, mappedLeft, map(right), resultType );
+}
+
+void DenseIdsGen::operatorLogicalNot( ExpressionId id, ExpressionId argument ) {
+    ExpressionId mappedId = map(id);
+    _backend->operatorLogicalNot( mappedId, map(argument) );
+}
+
+// Private methods
+DenseIdsGen::ExpressionId DenseIdsGen::map( ExpressionId id ) {
+    if( !CompilationSession::isFunctionId( id.get() ) )
+        return id;
+
+    auto inserted = _expressionIds.try_emplace( id );
+    if( inserted.second )
+        inserted.first->second = _moduleSession.allocateExpressionId();
+
+    return inserted.first->second;
+}
+
+DenseIdsGen::JumpPointId DenseIdsGen::map( JumpPointId id ) {
+    if( !CompilationSession::isFunctionId( id.get() ) )
+        return id;
+
+    auto inserted = _jumpPoints.try_emplace( id );
+    if( inserted.second )
+        inserted.first->second = _moduleSession.allocateJumpPoint();
+
+    return inserted.first->second;
+}
+
+} // namespace AST
@@ -0,0 +1,122 @@
+/* This file is part of the Practical programming langauge. https://github.com/Practical/practical-sa
+ *
+ * To the extent header files enjoy copyright protection, this file is file is copyright (C) 2021 by its authors
+ * You can see the file's authors in the AUTHORS file in the project's home repository.
+ *
+ * This is available under the Boost license. The license's text is available under the LICENSE file in the project's
+ * home directory.
+ */
+#ifndef AST_DENSE_IDS_GEN_H
+#define AST_DENSE_IDS_GEN_H
+
+#include "ast/compilation_session.h"
+
+#include <practical/practical.h>
+
+#include <memory>
+#include <unordered_map>
+
+namespace AST {
+
+// Hands a function's code on to the backend, renumbering the ids from the function session's block densely.
+//
+// Each id gets the next one of the module session's ids when it first shows up, so functions handed out one after the
+// other get consecutive ids, no matter which thread analyzed them. Ids from the module session, such as those of the
+// arguments, are passed on as they are.
+class DenseIdsGen : public PracticalSemanticAnalyzer::FunctionGen {
+    using ExpressionId = PracticalSemanticAnalyzer::ExpressionId;
+    using JumpPointId = PracticalSemanticAnalyzer::JumpPointId;
+    using StaticType = PracticalSemanticAnalyzer::StaticType;
+
+    std::shared_ptr<PracticalSemanticAnalyzer::FunctionGen> _backend;
+    CompilationSession &_moduleSession;
+    std::unordered_map<ExpressionId, ExpressionId> _expressionIds;
+    std::unordered_map<JumpPointId, JumpPointId> _jumpPoints;
+
+public:
+    DenseIdsGen( std::shared_ptr<PracticalSemanticAnalyzer::FunctionGen> backend, CompilationSession &moduleSession ) :
+        _backend( std::move(backend) ), _moduleSession( moduleSession )
+    {}
+
+    void functionEnter(
+            String name, StaticType::CPtr returnType, Slice<const PracticalSemanticAnalyzer::ArgumentDeclaration> arguments,
+            String file, const PracticalSemanticAnalyzer::SourceLocation &location ) override;
+    void functionLeave() override;
+
+    void returnValue( ExpressionId id ) override;
+    void returnValue() override;
+
+    void conditionalBranch(
+            ExpressionId id, StaticType::CPtr type, ExpressionId conditionExpression, JumpPointId elsePoint,
+            JumpPointId continuationPoint ) override;
+    void setConditionClauseResult( ExpressionId id ) override;
+    void setJumpPoint( JumpPointId id, String name ) override;
+    void jump( JumpPointId destination ) override;
+
+    void setLiteral( ExpressionId id, LongEnoughInt value, StaticType::CPtr type ) override;
+    void setLiteral( ExpressionId id, bool value ) override;
+    void setLiteral( ExpressionId id, String value ) override;
+    void setLiteralNull( ExpressionId id, StaticType::CPtr type ) override;
+
+    void allocateStackVar( ExpressionId id, StaticType::CPtr type, String name ) override;
+    void assign( ExpressionId lvalue, ExpressionId rvalue ) override;
+    void dereferencePointer( ExpressionId id, StaticType::CPtr type, ExpressionId addr ) override;
+
+    void truncateInteger(
+            ExpressionId id, ExpressionId source, StaticType::CPtr sourceType, StaticType::CPtr destType ) override;
+    void changeIntegerSign(
+            ExpressionId id, ExpressionId source, StaticType::CPtr sourceType, StaticType::CPtr destType ) override;
+    void expandIntegerSigned(
+            ExpressionId id, ExpressionId source, StaticType::CPtr sourceType, StaticType::CPtr destType ) override;
+    void expandIntegerUnsigned(
+            ExpressionId id, ExpressionId source, StaticType::CPtr sourceType, StaticType::CPtr destType ) override;
+
+    void callFunctionDirect(
+            ExpressionId id, String name, Slice<const ExpressionId> arguments, StaticType::CPtr returnType ) override;
+
+    void binaryOperatorPlusUnsigned(
+            ExpressionId id, ExpressionId left, ExpressionId right, StaticType::CPtr resultType ) override;
+    void binaryOperatorPlusSigned(
+            ExpressionId id, ExpressionId left, ExpressionId right, StaticType::CPtr resultType ) override;
+    void binaryOperatorMinusUnsigned(
+            ExpressionId id, ExpressionId left, ExpressionId right, StaticType::CPtr resultType ) override;
+    void binaryOperatorMinusSigned(
+            ExpressionId id, ExpressionId left, ExpressionId right, StaticType::CPtr resultType ) override;
+    void binaryOperatorMultiplyUnsigned(
+            ExpressionId id, ExpressionId left, ExpressionId right, StaticType::CPtr resultType ) override;
+    void binaryOperatorMultiplySigned(
+            ExpressionId id, ExpressionId left, ExpressionId right, StaticType::CPtr resultType ) override;
+    void binaryOperatorDivideUnsigned(
+            ExpressionId id, ExpressionId left, ExpressionId right, StaticType::CPtr resultType ) override;
+
+    void operatorEquals(
+            ExpressionId id, ExpressionId left, ExpressionId right, StaticType::CPtr resultType ) override;
+    void operatorNotEquals(
+            ExpressionId id, ExpressionId left, ExpressionId right, StaticType::CPtr resultType ) override;
+    void operatorLessThanUnsigned(
+            ExpressionId id, ExpressionId left, ExpressionId right, StaticType::CPtr resultType ) override;
+    void operatorLessThanSigned(
+            ExpressionId id, ExpressionId left, ExpressionId right, StaticType::CPtr resultType ) override;
+    void operatorLessThanOrEqualsUnsigned(
+            ExpressionId id, ExpressionId left, ExpressionId right, StaticType::CPtr resultType ) override;
+    void operatorLessThanOrEqualsSigned(
+            ExpressionId id, ExpressionId left, ExpressionId right, StaticType::CPtr resultType ) override;
+    void operatorGreaterThanUnsigned(
+            ExpressionId id, ExpressionId left, ExpressionId right, StaticType::CPtr resultType ) override;
+    void operatorGreaterThanSigned(
+            ExpressionId id, ExpressionId left, ExpressionId right, StaticType::CPtr resultType ) override;
+    void operatorGreaterThanOrEqualsUnsigned(
+            ExpressionId id, ExpressionId left, ExpressionId right, StaticType::CPtr resultType ) override;
+    void operatorGreaterThanOrEqualsSigned(
+            ExpressionId id, ExpressionId left, ExpressionId right, StaticType::CPtr resultType ) override;
+
+    void operatorLogicalNot( ExpressionId id, ExpressionId argument ) override;
+
+private:
+    ExpressionId map( ExpressionId id );
+    JumpPointId map( JumpPointId id );
+};
+
+} // namespace AST
+
+#endif // AST_DENSE_IDS_GEN_H
@@ -8,6 +8,8 @@
  */
 #include "ast/expression.h"
 
+#include "ast/ast.h"
+#include "ast/compilation_session.h"
 #include "ast/expression/binary_op.h"
 #include "ast/expression/cast_op.h"
 #include "ast/expression/compound_expression.h"
@@ -30,8 +32,16 @@ SourceLocation Expression::getLocation() const {
     return actualExpression->getLocation();
 }
 
+bool Expression::hasSideEffects() const {
+    return actualExpression->hasSideEffects();
+}
+
+void Expression::narrowRanges( bool outcome, LookupContext::RangeNarrowing &narrowing ) const {
+    actualExpression->narrowRanges( outcome, narrowing );
+}
+
 // Protected memthods
-void Expression::buildASTImpl(
+BuildResult Expression::buildASTImpl(
         LookupContext &lookupContext, ExpectedResult expectedResult, Weight &weight, Weight weightLimit )
 {
     struct Visitor {
@@ -40,81 +50,107 @@ void Expression::buildASTImpl(
         ExpectedResult expectedResult;
         Weight &weight;
         const Weight weightLimit;
+        Arena &arena;
 
-        void operator()( const std::unique_ptr<NonTerminals::CompoundExpression> &parserExpression ) {
-            auto expression = safenew<ExpressionImpl::CompoundExpression>( *parserExpression, lookupContext );
-
-            expression->buildAST( lookupContext, expectedResult, weight, weightLimit );
-            _this->actualExpression = std::move(expression);
+        BuildResult operator()( const std::unique_ptr<NonTerminals::CompoundExpression> &parserExpression ) {
+            return build( arena.makeShared<ExpressionImpl::CompoundExpression>( *parserExpression, lookupContext ) );
         }
 
-        void operator()( const NonTerminals::Literal &parserLiteral ) {
-            auto literal = safenew<ExpressionImpl::Literal>( parserLiteral );
-
-            literal->buildAST( lookupContext, expectedResult, weight, weightLimit );
-            _this->actualExpression = std::move(literal);
+        BuildResult operator()( const NonTerminals::Literal &parserLiteral ) {
+            return build( arena.makeShared<ExpressionImpl::Literal>( parserLiteral ) );
         }
 
-        void operator()( const NonTerminals::Identifier &parserIdentifier ) {
-            auto identifier = safenew<ExpressionImpl::Identifier>( parserIdentifier );
-
-            identifier->buildAST( lookupContext, expectedResult, weight, weightLimit );
-            _this->actualExpression = std::move(identifier);
+        BuildResult operator()( const NonTerminals::Identifier &parserIdentifier ) {
+            return build( arena.makeShared<ExpressionImpl::Identifier>( parserIdentifier ) );
         }
 
-        void operator()( const NonTerminals::Expression::UnaryOperator &op ) {
-            auto unaryOp = safenew<ExpressionImpl::UnaryOp>(op);
-
-            unaryOp->buildAST( lookupContext, expectedResult, weight, weightLimit );
-            _this->actualExpression = std::move(unaryOp);
+        BuildResult operator()( const NonTerminals::Expression::UnaryOperator &op ) {
+            return build( arena.makeShared<ExpressionImpl::UnaryOp>(op) );
         }
 
-        void operator()( const NonTerminals::Expression::BinaryOperator &op ) {
-            auto binaryOp = safenew<ExpressionImpl::BinaryOp>(op);
-
-            binaryOp->buildAST( lookupContext, expectedResult, weight, weightLimit );
-            _this->actualExpression = std::move(binaryOp);
+        BuildResult operator()( const NonTerminals::Expression::BinaryOperator &op ) {
+            return build( arena.makeShared<ExpressionImpl::BinaryOp>(op) );
         }
 
-        void operator()( const NonTerminals::Expression::CastOperator &cast ) {
-            auto castOp = safenew<ExpressionImpl::CastOp>(cast);
+        BuildResult operator()( const NonTerminals::Expression::CastOperator &cast ) {
+            return build( arena.makeShared<ExpressionImpl::CastOp>(cast) );
+        }
 
-            castOp->buildAST( lookupContext, expectedResult, weight, weightLimit );
-            _this->actualExpression = std::move(castOp);
+        BuildResult operator()( const NonTerminals::Expression::FunctionCall &parserFuncCall ) {
+            return build( arena.makeShared<ExpressionImpl::FunctionCall>( parserFuncCall ) );
         }
 
-        void operator()( const NonTerminals::Expression::FunctionCall &parserFuncCall ) {
-            auto functionCall = safenew<ExpressionImpl::FunctionCall>( parserFuncCall );
+        BuildResult operator()( const std::unique_ptr<NonTerminals::ConditionalExpression> &parserCondition ) {
+            return build( arena.makeShared<ExpressionImpl::ConditionalExpression>( *parserCondition ) );
+        }
 
-            functionCall->buildAST( lookupContext, expectedResult, weight, weightLimit );
-            _this->actualExpression = std::move(functionCall);
+        BuildResult operator()( const NonTerminals::Type &type ) {
+            ABORT()<<"TODO implement";
         }
 
-        void operator()( const std::unique_ptr<NonTerminals::ConditionalExpression> &parserCondition ) {
-            auto condition = safenew<ExpressionImpl::ConditionalExpression>( *parserCondition );
+        BuildResult build( std::shared_ptr<ExpressionImpl::Base> expression ) {
+            ++AST::getStatistics().astNodes;
+            BuildResult result = expression->tryBuildAST( lookupContext, expectedResult, weight, weightLimit );
+            if( result )
+                _this->actualExpression = std::move(expression);
 
-            condition->buildAST( lookupContext, expectedResult, weight, weightLimit );
-            _this->actualExpression = std::move(condition);
+            return result;
         }
+    };
 
-        void operator()( const NonTerminals::Type &type ) {
-            ABORT()<<"TODO implement";
+    if( weight>weightLimit )
+        return BuildResult::tooExpensive();
+
+    // Build with a zero based weight, so that the result can be reused regardless of the weight accumulated so far
+    Weight budget = weight.remaining( weightLimit );
+    ExpressionMemo &memo = lookupContext.getExpressionMemo();
+
+    const ExpressionMemo::Entry *memoized = memo.lookup( parserExpression, expectedResult, budget );
+    if( memoized!=nullptr ) {
+        if( !memoized->expression )
+            return memoized->failure;
+        // Building it again would come to the same weight
+        if( budget<memoized->weight )
+            return BuildResult::tooExpensive();
+
+        actualExpression = memoized->expression;
+        weight += memoized->weight;
+    } else {
+        Weight buildWeight;
+
+        BuildResult result = std::visit(
+                Visitor{
+                    ._this = this, .lookupContext = lookupContext, .expectedResult = expectedResult,
+                    .weight = buildWeight, .weightLimit = budget,
+                    .arena = CompilationSession::current().getArena()
+                },
+                parserExpression.value );
+
+        if( !result ) {
+            memo.addFailure( parserExpression, expectedResult, result, budget );
+            return result;
         }
-    };
 
-    std::visit(
-            Visitor{
-                ._this = this, .lookupContext = lookupContext, .expectedResult = expectedResult,
-                .weight = weight, .weightLimit = weightLimit
-            },
-            parserExpression.value );
+        memo.addSuccess( parserExpression, expectedResult, actualExpression, buildWeight );
+        weight += buildWeight;
+    }
 
     metadata.type = actualExpression->getType();
     metadata.valueRange = actualExpression->getValueRange();
+
+    return BuildResult();
 }
 
 ExpressionId Expression::codeGenImpl( PracticalSemanticAnalyzer::FunctionGen *functionGen ) const {
     return actualExpression->codeGen( functionGen );
 }
 
+ValueRange Expression::evaluateImpl( Interpreter &interpreter ) const {
+    return actualExpression->evaluate( interpreter );
+}
+
+ValueRange Expression::getEvaluatedValue() const {
+    return actualExpression->getKnownValue();
+}
+
 } // namespace AST
@@ -21,7 +21,8 @@ namespace AST {
 
 class Expression final : public ExpressionImpl::Base {
     const NonTerminals::Expression &parserExpression;
-    std::unique_ptr< ExpressionImpl::Base > actualExpression;
+    // Shared, as the same built expression may be reused by several overload resolution candidates
+    std::shared_ptr< const ExpressionImpl::Base > actualExpression;
 
 public:
     explicit Expression( const NonTerminals::Expression &parserExpression );
@@ -32,12 +33,16 @@ public:
     }
 
     SourceLocation getLocation() const override;
+    bool hasSideEffects() const override;
+    void narrowRanges( bool outcome, LookupContext::RangeNarrowing &narrowing ) const override;
 
 protected:
-    void buildASTImpl(
+    BuildResult buildASTImpl(
             LookupContext &lookupContext, ExpectedResult expectedResult, Weight &weight, Weight weightLimit
         ) override;
     ExpressionId codeGenImpl( PracticalSemanticAnalyzer::FunctionGen *functionGen ) const override;
+    ValueRange evaluateImpl( Interpreter &interpreter ) const override;
+    ValueRange getEvaluatedValue() const override;
 };
 
 } // namespace AST
@@ -23,19 +23,20 @@ AddressOf::AddressOf( const NonTerminals::Expression &parserOperand ) :
     operand( parserOperand )
 {}
 
-void AddressOf::buildASTImpl(
+BuildResult AddressOf::buildASTImpl(
         LookupContext &lookupContext, ExpectedResult expectedResult, ExpressionMetadata &metadata,
         Weight &weight, Weight weightLimit
     )
 {
     bool handled = false;
+    BuildResult result;
 
     if( expectedResult) {
         StaticType::Types expectedType = expectedResult.getType()->getType();
         auto expectedPointer = std::get_if<const StaticType::Pointer *>( &expectedType );
 
         if( expectedPointer ) {
-            operand.buildAST(
+            result = operand.tryBuildAST(
                     lookupContext,
                     ExpectedResult(
                         (*expectedPointer)->getPointedType()->addFlags( StaticType::Flags::Reference ),
@@ -49,14 +50,19 @@ void AddressOf::buildASTImpl(
     }
 
     if( !handled ) {
-        operand.buildAST( lookupContext, ExpectedResult(), weight, weightLimit );
+        result = operand.tryBuildAST( lookupContext, ExpectedResult(), weight, weightLimit );
     }
 
+    if( !result )
+        return result;
+
     if( (operand.getType()->getFlags() & StaticType::Flags::Reference)==0 )
         throw LValueRequired( operand.getType(), operand.getLocation() );
 
     metadata.type = StaticTypeImpl::allocate( PointerTypeImpl( operand.getType() ) );
     metadata.valueRange = new PointerValueRange( operand.getValueRange() );
+
+    return result;
 }
 
 ExpressionId AddressOf::codeGen( PracticalSemanticAnalyzer::FunctionGen *functionGen ) const {
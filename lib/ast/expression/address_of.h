@@ -19,7 +19,7 @@ class AddressOf {
 public:
     explicit AddressOf( const NonTerminals::Expression &parserOperand );
 
-    void buildASTImpl(
+    BuildResult buildASTImpl(
             LookupContext &lookupContext, ExpectedResult expectedResult, ExpressionMetadata &metadata,
             Weight &weight, Weight weightLimit
         );
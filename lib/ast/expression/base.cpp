@@ -8,14 +8,12 @@
  */
 #include "base.h"
 
-#include <practical/errors.h>
+#include "ast/compilation_session.h"
 
 namespace AST::ExpressionImpl {
 
 ExpressionId Base::allocateId() {
-    static ExpressionId::Allocator<> allocator;
-
-    return allocator.allocate();
+    return CompilationSession::current().allocateExpressionId();
 }
 
 Base::~Base() {}
@@ -27,27 +25,40 @@ StaticTypeImpl::CPtr Base::getType() const {
     return metadata.type;
 }
 
-void Base::buildAST( LookupContext &lookupContext, ExpectedResult expectedResult, Weight &weight, Weight weightLimit )
+BuildResult Base::tryBuildAST(
+        LookupContext &lookupContext, ExpectedResult expectedResult, Weight &weight, Weight weightLimit )
 {
-    buildASTImpl( lookupContext, expectedResult, weight, weightLimit );
+    BuildResult result = buildASTImpl( lookupContext, expectedResult, weight, weightLimit );
+    if( !result )
+        return result;
 
     if( weight>weightLimit )
-        throw ExpressionTooExpensive();
+        return BuildResult::tooExpensive();
 
     ASSERT( metadata.type )<<"Build AST did not set a return type "<<getLocation();
     ASSERT( metadata.valueRange )<<"Build AST did not set a value range "<<getLocation();
     if( !expectedResult || *expectedResult.getType()==*metadata.type )
-        return;
+        return result;
 
-    castChain = CastChain::allocate(
-            lookupContext, expectedResult.getType(), metadata, weight, weightLimit, true, getLocation() );
+    result = CastChain::allocate(
+            castChain, lookupContext, expectedResult.getType(), metadata, weight, weightLimit, true, getLocation() );
 
-    if( !castChain && expectedResult.isMandatory() ) {
-        throw CastNotAllowed( metadata.type, expectedResult.getType(), true, getLocation() );
-    }
+    if( result.getStatus()==BuildResult::Status::NoMatch && !expectedResult.isMandatory() )
+        return BuildResult();
+
+    return result;
+}
+
+void Base::buildAST( LookupContext &lookupContext, ExpectedResult expectedResult, Weight &weight, Weight weightLimit )
+{
+    tryBuildAST( lookupContext, expectedResult, weight, weightLimit ).raiseOnFailure();
 }
 
 ExpressionId Base::codeGen( PracticalSemanticAnalyzer::FunctionGen *functionGen ) const {
+    ValueRange folded = foldedValue();
+    if( folded )
+        return codeGenFolded( folded, functionGen );
+
     ExpressionId ret = codeGenImpl( functionGen );
 
     if( castChain )
@@ -56,4 +67,81 @@ ExpressionId Base::codeGen( PracticalSemanticAnalyzer::FunctionGen *functionGen
     return ret;
 }
 
+ValueRange Base::evaluate( Interpreter &interpreter ) const {
+    if( !interpreter.step() )
+        return ValueRange();
+
+    // Values VRP already knows need no evaluation, provided nothing else would have happened computing them
+    const ValueRange &range = getValueRange();
+    if( range.getKind()!=ValueRange::Kind::Compound && range.isLiteral() && !hasSideEffects() )
+        return range;
+
+    ValueRange value = evaluateImpl( interpreter );
+    if( value && castChain )
+        value = castChain->evaluate( metadata.type.get(), value );
+
+    if( !value || value.getKind()==ValueRange::Kind::Compound || !value.isLiteral() )
+        return ValueRange();
+
+    return value;
+}
+
+ValueRange Base::getKnownValue() const {
+    ValueRange value = getValueRange();
+    if( value.getKind()!=ValueRange::Kind::Compound && value.isLiteral() )
+        return value;
+
+    value = getEvaluatedValue();
+    if( value && castChain )
+        value = castChain->evaluate( metadata.type.get(), value );
+
+    if( !value || value.getKind()==ValueRange::Kind::Compound || !value.isLiteral() )
+        return ValueRange();
+
+    return value;
+}
+
+// The single scalar value of an expression that can be evaluated for its value alone, or an empty range
+ValueRange Base::foldedValue() const {
+    ValueRange value = getKnownValue();
+
+    switch( value.getKind() ) {
+    case ValueRange::Kind::Bool:
+    case ValueRange::Kind::UnsignedInt:
+    case ValueRange::Kind::SignedInt:
+        break;
+    default:
+        return ValueRange();
+    }
+
+    if( ( getType()->getFlags() & StaticType::Flags::Reference ) || hasSideEffects() )
+        return ValueRange();
+
+    return value;
+}
+
+ExpressionId Base::codeGenFolded(
+        const ValueRange &range, PracticalSemanticAnalyzer::FunctionGen *functionGen ) const
+{
+    ExpressionId id = allocateId();
+
+    switch( range.getKind() ) {
+    case ValueRange::Kind::Bool:
+        functionGen->setLiteral( id, range.get<BoolValueRange>().trueAllowed );
+        break;
+    case ValueRange::Kind::UnsignedInt:
+        functionGen->setLiteral( id, range.get<UnsignedIntValueRange>().minimum, getType() );
+        break;
+    case ValueRange::Kind::SignedInt:
+        // Negative values are passed in two's complement
+        functionGen->setLiteral(
+                id, static_cast<LongEnoughInt>( range.get<SignedIntValueRange>().minimum ), getType() );
+        break;
+    default:
+        ABORT()<<"Folding a value range of kind "<<static_cast<int>( range.getKind() );
+    }
+
+    return id;
+}
+
 } // namespace AST::ExpressionImpl
@@ -10,9 +10,11 @@
 #define AST_EXPRESSION_BASE_H
 
 #include "ast/expression/expression_metadata.h"
+#include "ast/build_result.h"
 #include "ast/cast_chain.h"
 #include "ast/cast_op.h"
 #include "ast/expected_result.h"
+#include "ast/interpreter.h"
 #include "ast/lookup_context.h"
 #include "ast/weight.h"
 
@@ -22,7 +24,7 @@ namespace AST::ExpressionImpl {
 
 class Base {
 private:
-    std::unique_ptr<CastChain> castChain;
+    Arena::Ptr<CastChain> castChain;
 
 protected:
     ExpressionMetadata metadata;
@@ -47,22 +49,54 @@ public:
 
     StaticTypeImpl::CPtr getType() const;
 
-    ValueRangeBase::CPtr getValueRange() const {
+    const ValueRange &getValueRange() const {
         if( castChain )
             return castChain->getMetadata().valueRange;
 
         return metadata.valueRange;
     }
 
+    // Failures overload resolution may recover from are returned. Errors that fail the compilation are thrown.
+    BuildResult tryBuildAST(
+            LookupContext &lookupContext, ExpectedResult expectedResult, Weight &weight, Weight weightLimit );
+    // Same as tryBuildAST, but throws on any failure
     void buildAST( LookupContext &lookupContext, ExpectedResult expectedResult, Weight &weight, Weight weightLimit );
     ExpressionId codeGen( PracticalSemanticAnalyzer::FunctionGen *functionGen ) const;
+    // Computes the expression's value at compile time. Returns an empty range if it cannot.
+    ValueRange evaluate( Interpreter &interpreter ) const;
+    // The expression's value, after implicit casts, if VRP proved it or it was computed at build time. Returns an empty
+    // range otherwise.
+    ValueRange getKnownValue() const;
+
+    // Whether evaluating the expression does anything beyond computing its value
+    virtual bool hasSideEffects() const {
+        return true;
+    }
+
+    // Narrows the ranges of the variables this (boolean) expression tests, for code that only runs if it evaluated to
+    // outcome
+    virtual void narrowRanges( bool outcome, LookupContext::RangeNarrowing &narrowing ) const {}
 
     virtual SourceLocation getLocation() const = 0;
 
 protected:
-    virtual void buildASTImpl(
+    virtual BuildResult buildASTImpl(
             LookupContext &lookupContext, ExpectedResult expectedResult, Weight &weight, Weight weightLimit ) = 0;
     virtual ExpressionId codeGenImpl( PracticalSemanticAnalyzer::FunctionGen *functionGen ) const = 0;
+    // Evaluates the expression before its implicit casts. Expressions VRP does not already know cannot be evaluated by
+    // default.
+    virtual ValueRange evaluateImpl( Interpreter &interpreter ) const {
+        return ValueRange();
+    }
+    // The value, before implicit casts, the expression was computed to have at build time, beyond what VRP knows. Such
+    // values are only used for folding the expression. They never feed VRP.
+    virtual ValueRange getEvaluatedValue() const {
+        return ValueRange();
+    }
+
+private:
+    ValueRange foldedValue() const;
+    ExpressionId codeGenFolded( const ValueRange &value, PracticalSemanticAnalyzer::FunctionGen *functionGen ) const;
 };
 
 } // namespace AST::ExpressionImpl
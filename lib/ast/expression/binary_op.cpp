@@ -8,16 +8,19 @@
  */
 #include "ast/expression/binary_op.h"
 
+#include "ast/expression/identifier.h"
 #include "ast/operators/algebraic_int.h"
 #include "ast/operators/boolean.h"
 #include "tokenizer.h"
 
+#include <array>
 #include <experimental/array>
 
 namespace AST::ExpressionImpl {
 
 // Non member private helpers
 static std::unordered_map< Tokenizer::Tokens, std::string > operatorNames;
+static OverloadResolver::OperatorTable operators;
 
 static void defineMatchingPairs(
         LookupContext::Function::Definition::CodeGenProto *codeGenerator,
@@ -28,9 +31,10 @@ static void defineMatchingPairs(
         LookupContext &builtinCtx)
 {
     for( auto &type : types ) {
+        std::array<StaticTypeImpl::CPtr, 2> argumentTypes{ type, type };
         builtinCtx.addBuiltinFunction(
                 name,
-                retType, { type, type },
+                retType, argumentTypes,
                 codeGenerator, calcVrp );
     }
 }
@@ -43,32 +47,127 @@ static void defineMatchingPairs(
         LookupContext &builtinCtx)
 {
     for( auto &type : types ) {
+        std::array<StaticTypeImpl::CPtr, 2> argumentTypes{ type, type };
         builtinCtx.addBuiltinFunction(
                 name,
-                type, { type, type },
+                type, argumentTypes,
                 codeGenerator, calcVrp );
     }
 }
 
-static String opToFuncName( Tokenizer::Tokens token ) {
-    return operatorNames.at(token);
+// The comparison that holds when "lhs op rhs" does not
+static Tokenizer::Tokens negateComparison( Tokenizer::Tokens op ) {
+    switch( op ) {
+    case Tokenizer::Tokens::OP_LESS_THAN:       return Tokenizer::Tokens::OP_GREATER_THAN_EQ;
+    case Tokenizer::Tokens::OP_LESS_THAN_EQ:    return Tokenizer::Tokens::OP_GREATER_THAN;
+    case Tokenizer::Tokens::OP_GREATER_THAN:    return Tokenizer::Tokens::OP_LESS_THAN_EQ;
+    case Tokenizer::Tokens::OP_GREATER_THAN_EQ: return Tokenizer::Tokens::OP_LESS_THAN;
+    case Tokenizer::Tokens::OP_EQUALS:          return Tokenizer::Tokens::OP_NOT_EQUALS;
+    case Tokenizer::Tokens::OP_NOT_EQUALS:      return Tokenizer::Tokens::OP_EQUALS;
+    default:
+        ABORT()<<"Negating non-comparison operator "<<op;
+    }
+}
+
+// The comparison equivalent to "lhs op rhs" when written as "rhs op lhs"
+static Tokenizer::Tokens mirrorComparison( Tokenizer::Tokens op ) {
+    switch( op ) {
+    case Tokenizer::Tokens::OP_LESS_THAN:       return Tokenizer::Tokens::OP_GREATER_THAN;
+    case Tokenizer::Tokens::OP_LESS_THAN_EQ:    return Tokenizer::Tokens::OP_GREATER_THAN_EQ;
+    case Tokenizer::Tokens::OP_GREATER_THAN:    return Tokenizer::Tokens::OP_LESS_THAN;
+    case Tokenizer::Tokens::OP_GREATER_THAN_EQ: return Tokenizer::Tokens::OP_LESS_THAN_EQ;
+    case Tokenizer::Tokens::OP_EQUALS:
+    case Tokenizer::Tokens::OP_NOT_EQUALS:
+        return op;
+    default:
+        ABORT()<<"Mirroring non-comparison operator "<<op;
+    }
+}
+
+// The values of range for which "value op bound" might hold
+template<typename VR>
+static ValueRange rangeSatisfying( const VR &range, Tokenizer::Tokens op, const VR &bound ) {
+    using Limits = std::numeric_limits< decltype(bound.minimum) >;
+
+    switch( op ) {
+    case Tokenizer::Tokens::OP_LESS_THAN:
+        if( bound.maximum==Limits::min() )
+            return ValueRange();
+
+        return ValueRange( range ).intersect( VR( Limits::min(), bound.maximum-1 ) );
+    case Tokenizer::Tokens::OP_LESS_THAN_EQ:
+        return ValueRange( range ).intersect( VR( Limits::min(), bound.maximum ) );
+    case Tokenizer::Tokens::OP_GREATER_THAN:
+        if( bound.minimum==Limits::max() )
+            return ValueRange();
+
+        return ValueRange( range ).intersect( VR( bound.minimum+1, Limits::max() ) );
+    case Tokenizer::Tokens::OP_GREATER_THAN_EQ:
+        return ValueRange( range ).intersect( VR( bound.minimum, Limits::max() ) );
+    case Tokenizer::Tokens::OP_EQUALS:
+        return ValueRange( range ).intersect( bound );
+    case Tokenizer::Tokens::OP_NOT_EQUALS:
+        // Only excluding a value at the edge of the range narrows it
+        if( bound.isLiteral() && range.minimum<range.maximum ) {
+            if( bound.minimum==range.minimum )
+                return VR( range.minimum+1, range.maximum );
+            if( bound.minimum==range.maximum )
+                return VR( range.minimum, range.maximum-1 );
+        }
+
+        return range;
+    default:
+        ABORT()<<"Range satisfying non-comparison operator "<<op;
+    }
+}
+
+static void narrowComparison(
+        Tokenizer::Tokens op, Slice<const Expression> operands, LookupContext::RangeNarrowing &narrowing )
+{
+    for( unsigned i=0; i<2; ++i ) {
+        const Identifier *identifier = operands[i].tryGetActualExpression<Identifier>();
+        if( identifier==nullptr )
+            continue;
+
+        auto variable = std::get_if<LookupContext::Variable>( identifier->getCtxIdentifier() );
+        if( variable==nullptr )
+            continue;
+
+        // Both operands were cast to the overload's type, so their ranges are of the same kind
+        const ValueRange &range = operands[i].getValueRange();
+        const ValueRange &bound = operands[1-i].getValueRange();
+        Tokenizer::Tokens variableOp = i==0 ? op : mirrorComparison( op );
+
+        switch( range.getKind() ) {
+        case ValueRange::Kind::UnsignedInt:
+            narrowing.narrow( *variable, rangeSatisfying(
+                        range.get<UnsignedIntValueRange>(), variableOp, bound.get<UnsignedIntValueRange>() ) );
+            break;
+        case ValueRange::Kind::SignedInt:
+            narrowing.narrow( *variable, rangeSatisfying(
+                        range.get<SignedIntValueRange>(), variableOp, bound.get<SignedIntValueRange>() ) );
+            break;
+        default:
+            break;
+        }
+    }
 }
 
 // Static methods
-void BinaryOp::init(LookupContext &builtinCtx) {
+void BinaryOp::init(LookupContext &builtinCtx, const BuiltinTypes &builtinTypes) {
     auto unsignedTypes = std::experimental::make_array<const StaticTypeImpl::CPtr>(
-        builtinCtx.lookupType( "U8" ),
-        builtinCtx.lookupType( "U16" ),
-        builtinCtx.lookupType( "U32" ),
-        builtinCtx.lookupType( "U64" )
+        builtinTypes.get( BuiltinTypes::Id::U8 ),
+        builtinTypes.get( BuiltinTypes::Id::U16 ),
+        builtinTypes.get( BuiltinTypes::Id::U32 ),
+        builtinTypes.get( BuiltinTypes::Id::U64 )
     );
     auto signedTypes = std::experimental::make_array<const StaticTypeImpl::CPtr>(
-        builtinCtx.lookupType( "S8" ),
-        builtinCtx.lookupType( "S16" ),
-        builtinCtx.lookupType( "S32" ),
-        builtinCtx.lookupType( "S64" )
+        builtinTypes.get( BuiltinTypes::Id::S8 ),
+        builtinTypes.get( BuiltinTypes::Id::S16 ),
+        builtinTypes.get( BuiltinTypes::Id::S32 ),
+        builtinTypes.get( BuiltinTypes::Id::S64 )
     );
-    const StaticTypeImpl::CPtr boolType = builtinCtx.lookupType( "Bool" );
+    const StaticTypeImpl::CPtr boolType = builtinTypes.get( BuiltinTypes::Id::Bool );
 
     auto inserter = operatorNames.emplace( Tokenizer::Tokens::OP_ARROW, "__opArrow" );
     inserter = operatorNames.emplace( Tokenizer::Tokens::OP_ASSIGN, "__opAssign" );
@@ -113,12 +212,13 @@ void BinaryOp::init(LookupContext &builtinCtx) {
     defineMatchingPairs( Operators::lessThanOrEqualsCodegenUInt, Operators::lessThanOrEqualsVrpUnsigned, inserter.first->second, boolType, unsignedTypes, builtinCtx );
     defineMatchingPairs( Operators::lessThanOrEqualsCodegenSInt, Operators::lessThanOrEqualsVrpSigned, inserter.first->second, boolType, signedTypes, builtinCtx );
 
+    std::array<StaticTypeImpl::CPtr, 2> logicalArgumentTypes{ boolType, boolType };
     inserter = operatorNames.emplace( Tokenizer::Tokens::OP_LOGIC_AND, "__opAnd" );
     builtinCtx.addBuiltinFunction(
-            inserter.first->second, boolType, { boolType, boolType }, Operators::logicalAnd, Operators::logicalAndVrp );
+            inserter.first->second, boolType, logicalArgumentTypes, Operators::logicalAnd, Operators::logicalAndVrp );
     inserter = operatorNames.emplace( Tokenizer::Tokens::OP_LOGIC_OR, "__opOr" );
     builtinCtx.addBuiltinFunction(
-            inserter.first->second, boolType, { boolType, boolType }, Operators::logicalOr, Operators::logicalOrVrp );
+            inserter.first->second, boolType, logicalArgumentTypes, Operators::logicalOr, Operators::logicalOrVrp );
 
     inserter = operatorNames.emplace( Tokenizer::Tokens::OP_MINUS, "__opMinus" );
     defineMatchingPairs( Operators::bMinusCodegenUnsigned, Operators::bMinusUnsignedVrp, inserter.first->second, unsignedTypes, builtinCtx );
@@ -135,6 +235,15 @@ void BinaryOp::init(LookupContext &builtinCtx) {
 
     inserter = operatorNames.emplace( Tokenizer::Tokens::OP_SHIFT_LEFT, "__opShiftLeft" );
     inserter = operatorNames.emplace( Tokenizer::Tokens::OP_SHIFT_RIGHT, "__opShiftRight" );
+
+    for( const auto &[token, name] : operatorNames ) {
+        OverloadResolver::OperatorOverloads &overloads = operators[ static_cast<size_t>(token) ];
+        overloads = OverloadResolver::OperatorOverloads();
+
+        const LookupContext::Identifier *identifier = builtinCtx.lookupIdentifier( name );
+        if( identifier!=nullptr )
+            overloads.init( std::get<LookupContext::Function>(*identifier), 2 );
+    }
 }
 
 BinaryOp::BinaryOp( const NonTerminals::Expression::BinaryOperator &parserOp ) :
@@ -145,23 +254,81 @@ SourceLocation BinaryOp::getLocation() const {
     return parserOp.op->location;
 }
 
+bool BinaryOp::hasSideEffects() const {
+    return resolver.hasSideEffects();
+}
+
+void BinaryOp::narrowRanges( bool outcome, LookupContext::RangeNarrowing &narrowing ) const {
+    Slice<const Expression> operands = resolver.getArguments();
+
+    switch( parserOp.op->token ) {
+    case Tokenizer::Tokens::OP_LOGIC_AND:
+        // Only a true result says anything about both operands
+        if( outcome ) {
+            operands[0].narrowRanges( true, narrowing );
+            operands[1].narrowRanges( true, narrowing );
+        }
+        break;
+    case Tokenizer::Tokens::OP_LOGIC_OR:
+        if( !outcome ) {
+            operands[0].narrowRanges( false, narrowing );
+            operands[1].narrowRanges( false, narrowing );
+        }
+        break;
+    case Tokenizer::Tokens::OP_LESS_THAN:
+    case Tokenizer::Tokens::OP_LESS_THAN_EQ:
+    case Tokenizer::Tokens::OP_GREATER_THAN:
+    case Tokenizer::Tokens::OP_GREATER_THAN_EQ:
+    case Tokenizer::Tokens::OP_EQUALS:
+    case Tokenizer::Tokens::OP_NOT_EQUALS:
+        narrowComparison( outcome ? parserOp.op->token : negateComparison( parserOp.op->token ), operands, narrowing );
+        break;
+    default:
+        break;
+    }
+}
+
 // Protected methods
-void BinaryOp::buildASTImpl(
+BuildResult BinaryOp::buildASTImpl(
         LookupContext &lookupContext, ExpectedResult expectedResult, Weight &weight, Weight weightLimit )
 {
-    String baseName = opToFuncName( parserOp.op->token );
-    auto identifier = lookupContext.lookupIdentifier( baseName );
-    ASSERT( identifier )<<"Binary operator "<<parserOp.op->token<<" is not yet implemented by the compiler";
-    const LookupContext::Function &function =
-            std::get<LookupContext::Function>(*identifier);
-
-    resolver.resolveOverloads(
-            lookupContext, expectedResult, function.overloads, weight, weightLimit, metadata,
-            { parserOp.operands[0].get(), parserOp.operands[1].get() }, parserOp.op );
+    size_t index = static_cast<size_t>( parserOp.op->token );
+    ASSERT( index<operators.size() && operators[index].function )<<
+            "Binary operator "<<parserOp.op->token<<" is not yet implemented by the compiler";
+
+    std::array<const NonTerminals::Expression *, 2> operands{ parserOp.operands[0].get(), parserOp.operands[1].get() };
+    return resolver.resolveOperator(
+            lookupContext, expectedResult, operators[index], weight, weightLimit, metadata, operands, parserOp.op );
 }
 
 ExpressionId BinaryOp::codeGenImpl( PracticalSemanticAnalyzer::FunctionGen *functionGen ) const {
     return resolver.codeGen( functionGen );
 }
 
+ValueRange BinaryOp::evaluateImpl( Interpreter &interpreter ) const {
+    Slice<const Expression> operands = resolver.getArguments();
+
+    switch( parserOp.op->token ) {
+    case Tokenizer::Tokens::OP_LOGIC_AND:
+    case Tokenizer::Tokens::OP_LOGIC_OR:
+        {
+            // Short circuit, same as the generated code does
+            bool decidingValue = parserOp.op->token==Tokenizer::Tokens::OP_LOGIC_OR;
+            ValueRange first = operands[0].evaluate( interpreter );
+            if( !first || first.get<BoolValueRange>().trueAllowed==decidingValue )
+                return first;
+
+            return operands[1].evaluate( interpreter );
+        }
+    default:
+        break;
+    }
+
+    return resolver.evaluate( interpreter );
+}
+
+ValueRange BinaryOp::getEvaluatedValue() const {
+    return resolver.getEvaluatedValue();
+}
+
 } // namespace AST::ExpressionImpl
@@ -9,6 +9,7 @@
 #ifndef AST_EXPRESSION_BINARY_OP_H
 #define AST_EXPRESSION_BINARY_OP_H
 
+#include "ast/builtin_types.h"
 #include "ast/expression/overload_resolver.h"
 #include "ast/expression.h"
 #include "parser.h"
@@ -20,17 +21,21 @@ class BinaryOp final : public Base {
     OverloadResolver resolver;
 
 public:
-    static void init(LookupContext &builtinCtx);
+    static void init(LookupContext &builtinCtx, const BuiltinTypes &builtinTypes);
 
     explicit BinaryOp( const NonTerminals::Expression::BinaryOperator &parserOp );
 
     SourceLocation getLocation() const override;
+    bool hasSideEffects() const override;
+    void narrowRanges( bool outcome, LookupContext::RangeNarrowing &narrowing ) const override;
 
 protected:
-    void buildASTImpl(
+    BuildResult buildASTImpl(
             LookupContext &lookupContext, ExpectedResult expectedResult, Weight &weight, Weight weightLimit
         ) override;
     ExpressionId codeGenImpl( PracticalSemanticAnalyzer::FunctionGen *functionGen ) const override;
+    ValueRange evaluateImpl( Interpreter &interpreter ) const override;
+    ValueRange getEvaluatedValue() const override;
 };
 
 } // namespace AST::ExpressionImpl
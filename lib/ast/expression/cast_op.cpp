@@ -20,7 +20,11 @@ SourceLocation CastOp::getLocation() const {
     return parserCast.op->location;
 }
 
-void CastOp::buildASTImpl(
+bool CastOp::hasSideEffects() const {
+    return expression.hasSideEffects();
+}
+
+BuildResult CastOp::buildASTImpl(
         LookupContext &lookupContext, ExpectedResult expectedResult, Weight &weight, Weight weightLimit
     )
 {
@@ -30,17 +34,26 @@ void CastOp::buildASTImpl(
     case Tokenizer::Tokens::RESERVED_EXPECT:
         {
             // Just give the expression a mandatory expected type
-            expression.buildAST( lookupContext, metadata.type, weight, weightLimit );
+            BuildResult result = expression.tryBuildAST( lookupContext, metadata.type, weight, weightLimit );
+            if( !result )
+                return result;
+
             metadata.valueRange = expression.getValueRange();
         }
         break;
     default:
         ABORT()<<"Unidentified token "<<parserCast.op->token<<" passed as cast";
     }
+
+    return BuildResult();
 }
 
 ExpressionId CastOp::codeGenImpl( PracticalSemanticAnalyzer::FunctionGen *functionGen ) const {
     return expression.codeGen( functionGen );
 }
 
+ValueRange CastOp::evaluateImpl( Interpreter &interpreter ) const {
+    return expression.evaluate( interpreter );
+}
+
 } // namespace AST::ExpressionImpl
@@ -22,12 +22,14 @@ public:
     explicit CastOp( const NonTerminals::Expression::CastOperator &parserCast );
 
     SourceLocation getLocation() const override;
+    bool hasSideEffects() const override;
 
 protected:
-    void buildASTImpl(
+    BuildResult buildASTImpl(
             LookupContext &lookupContext, ExpectedResult expectedResult, Weight &weight, Weight weightLimit
         ) override;
     ExpressionId codeGenImpl( PracticalSemanticAnalyzer::FunctionGen *functionGen ) const override;
+    ValueRange evaluateImpl( Interpreter &interpreter ) const override;
 };
 
 } // namespace AST::ExpressionImpl
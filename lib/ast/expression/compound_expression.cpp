@@ -22,16 +22,20 @@ SourceLocation CompoundExpression::getLocation() const {
     return expression.getLocation();
 }
 
-void CompoundExpression::buildASTImpl(
+BuildResult CompoundExpression::buildASTImpl(
         LookupContext &lookupContext, ExpectedResult expectedResult, Weight &weight, Weight weightLimit)
 {
     ASSERT( &lookupContext == this->lookupContext.getParent() );
 
     statements.buildAST( this->lookupContext );
-    expression.buildAST( this->lookupContext, expectedResult, weight, weightLimit );
+    BuildResult result = expression.tryBuildAST( this->lookupContext, expectedResult, weight, weightLimit );
+    if( !result )
+        return result;
 
     metadata.type = expression.getType();
     metadata.valueRange = expression.getValueRange();
+
+    return result;
 }
 
 ExpressionId CompoundExpression::codeGenImpl( PracticalSemanticAnalyzer::FunctionGen *functionGen ) const {
@@ -39,4 +43,11 @@ ExpressionId CompoundExpression::codeGenImpl( PracticalSemanticAnalyzer::Functio
     return expression.codeGen( functionGen );
 }
 
+ValueRange CompoundExpression::evaluateImpl( Interpreter &interpreter ) const {
+    if( !statements.evaluate( this->lookupContext, interpreter ) )
+        return ValueRange();
+
+    return expression.evaluate( interpreter );
+}
+
 } // namespace AST::ExpressionImpl
@@ -28,10 +28,11 @@ public:
     SourceLocation getLocation() const override;
 
 protected:
-    void buildASTImpl(
+    BuildResult buildASTImpl(
             LookupContext &lookupContext, ExpectedResult expectedResult, Weight &weight, Weight weightLimit
         ) override;
     ExpressionId codeGenImpl( PracticalSemanticAnalyzer::FunctionGen *functionGen ) const override;
+    ValueRange evaluateImpl( Interpreter &interpreter ) const override;
 };
 
 } // namespace AST::ExpressionImpl
@@ -21,23 +21,59 @@ SourceLocation ConditionalExpression::getLocation() const {
     return condition.getLocation();
 }
 
-void ConditionalExpression::buildASTImpl(
+bool ConditionalExpression::hasSideEffects() const {
+    return condition.hasSideEffects() || ifClause.hasSideEffects() || elseClause.hasSideEffects();
+}
+
+BuildResult ConditionalExpression::buildASTImpl(
         LookupContext &lookupContext, ExpectedResult expectedResult, Weight &weight, Weight weightLimit )
 {
     Weight conditionWeight;
-    auto boolType = AST::getBuiltinCtx().lookupType("Bool");
-    condition.buildAST(lookupContext, boolType, conditionWeight, Expression::NoWeightLimit);
+    const StaticTypeImpl::CPtr &boolType = AST::getBuiltinTypes().get( BuiltinTypes::Id::Bool );
+    BuildResult result = condition.tryBuildAST(lookupContext, boolType, conditionWeight, Expression::NoWeightLimit);
+    if( !result )
+        return result;
+
+    {
+        LookupContext::RangeNarrowing narrowing( lookupContext );
+        condition.narrowRanges( true, narrowing );
+        result = ifClause.tryBuildAST(lookupContext, expectedResult, weight, weightLimit);
+        if( !result )
+            return result;
+    }
 
-    ifClause.buildAST(lookupContext, expectedResult, weight, weightLimit);
-    elseClause.buildAST(lookupContext, ifClause.getType(), weight, weightLimit);
+    {
+        LookupContext::RangeNarrowing narrowing( lookupContext );
+        condition.narrowRanges( false, narrowing );
+        result = elseClause.tryBuildAST(lookupContext, ifClause.getType(), weight, weightLimit);
+        if( !result )
+            return result;
+    }
 
     metadata.type = ifClause.getType();
-    metadata.valueRange = metadata.type->defaultRange(); // TODO merge the two ranges instead
+    metadata.valueRange = ifClause.getValueRange().unite( elseClause.getValueRange() );
+    if( !metadata.valueRange )
+        metadata.valueRange = metadata.type->defaultRange();
+
+    return result;
 }
 
 ExpressionId ConditionalExpression::codeGenImpl( PracticalSemanticAnalyzer::FunctionGen *functionGen ) const {
+    const ValueRange &conditionRange = condition.getValueRange();
+    if( conditionRange.isLiteral() ) {
+        ++AST::getStatistics().branchesEliminated;
+
+        if( condition.hasSideEffects() )
+            condition.codeGen(functionGen);
+
+        if( conditionRange.get<BoolValueRange>().trueAllowed )
+            return ifClause.codeGen( functionGen );
+
+        return elseClause.codeGen( functionGen );
+    }
+
     ExpressionId conditionResult = condition.codeGen(functionGen);
-    JumpPointId elsePoint{ jumpPointAllocator.allocate() }, contPoint{ jumpPointAllocator.allocate() };
+    JumpPointId elsePoint{ CompilationSession::current().allocateJumpPoint() }, contPoint{ CompilationSession::current().allocateJumpPoint() };
 
     ExpressionId resultId = allocateId();
     functionGen->conditionalBranch( resultId, ifClause.getType(), conditionResult, elsePoint, contPoint );
@@ -52,4 +88,15 @@ ExpressionId ConditionalExpression::codeGenImpl( PracticalSemanticAnalyzer::Func
     return resultId;
 }
 
+ValueRange ConditionalExpression::evaluateImpl( Interpreter &interpreter ) const {
+    ValueRange conditionValue = condition.evaluate( interpreter );
+    if( !conditionValue )
+        return ValueRange();
+
+    if( conditionValue.get<BoolValueRange>().trueAllowed )
+        return ifClause.evaluate( interpreter );
+
+    return elseClause.evaluate( interpreter );
+}
+
 } // namespace AST::ExpressionImpl
@@ -21,12 +21,14 @@ public:
     explicit ConditionalExpression( const NonTerminals::ConditionalExpression &parserCondition );
 
     SourceLocation getLocation() const override;
+    bool hasSideEffects() const override;
 
 protected:
-    void buildASTImpl(
+    BuildResult buildASTImpl(
             LookupContext &lookupContext, ExpectedResult expectedResult, Weight &weight, Weight weightLimit
         ) override;
     ExpressionId codeGenImpl( PracticalSemanticAnalyzer::FunctionGen *functionGen ) const override;
+    ValueRange evaluateImpl( Interpreter &interpreter ) const override;
 };
 
 } // namespace AST::ExpressionImpl
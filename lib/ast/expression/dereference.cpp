@@ -19,7 +19,7 @@ Dereference::Dereference( const NonTerminals::Expression &parserOperand ) :
     operand( parserOperand )
 {}
 
-void Dereference::buildASTImpl(
+BuildResult Dereference::buildASTImpl(
         LookupContext &lookupContext, ExpectedResult expectedResult, ExpressionMetadata &metadata,
         Weight &weight, Weight weightLimit
     )
@@ -33,7 +33,9 @@ void Dereference::buildASTImpl(
         expectedOperandResult = ExpectedResult( std::move(operandExpectedType), expectedResult.isMandatory() );
     }
 
-    operand.buildAST( lookupContext, expectedOperandResult, weight, weightLimit );
+    BuildResult result = operand.tryBuildAST( lookupContext, expectedOperandResult, weight, weightLimit );
+    if( !result )
+        return result;
 
     StaticType::Types resultTypeType = operand.getType()->getType();
     auto resultPointerParent = std::get_if<const StaticType::Pointer *>( &resultTypeType );
@@ -45,11 +47,13 @@ void Dereference::buildASTImpl(
 
     metadata.type = downCast( resultPointer->getPointedType()->setFlags( StaticType::Flags::Reference ) );
 
-    auto operandRange = operand.getValueRange()->downCast< PointerValueRange >();
-    if( operandRange->initialized.trueAllowed == false ) {
+    const PointerValueRange &operandRange = operand.getValueRange().get< PointerValueRange >();
+    if( operandRange.initialized.trueAllowed == false ) {
         throw KnownRuntimeViolation( "Dereferencing a pointer known to be null", operand.getLocation() );
     }
-    metadata.valueRange = operandRange->pointedValueRange;
+    metadata.valueRange = operandRange.pointedValueRange;
+
+    return result;
 }
 
 ExpressionId Dereference::codeGen( PracticalSemanticAnalyzer::FunctionGen *functionGen ) const {
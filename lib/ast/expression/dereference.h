@@ -19,7 +19,7 @@ class Dereference {
 public:
     explicit Dereference( const NonTerminals::Expression &parserOperand );
 
-    void buildASTImpl(
+    BuildResult buildASTImpl(
             LookupContext &lookupContext, ExpectedResult expectedResult, ExpressionMetadata &metadata,
             Weight &weight, Weight weightLimit
         );
@@ -10,13 +10,13 @@
 #define AST_EXPRESSION_EXPRESSION_METADATA_H
 
 #include "ast/static_type.h"
-#include "ast/value_range_base.h"
+#include "ast/value_range.h"
 
 namespace AST::ExpressionImpl {
 
     struct ExpressionMetadata {
         StaticTypeImpl::CPtr type;
-        ValueRangeBase::CPtr valueRange;
+        ValueRange valueRange;
     };
 
 } // namespace AST::ExpressionImpl
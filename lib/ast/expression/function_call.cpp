@@ -25,12 +25,18 @@ SourceLocation FunctionCall::getLocation() const {
     return parserFunctionCall.op->location;
 }
 
+bool FunctionCall::hasSideEffects() const {
+    return resolver.hasSideEffects();
+}
+
 // protected methods
-void FunctionCall::buildASTImpl(
+BuildResult FunctionCall::buildASTImpl(
         LookupContext &lookupContext, ExpectedResult expectedResult, Weight &weight, Weight weightLimit )
 {
     functionId.emplace( *parserFunctionCall.expression );
-    functionId->buildAST( lookupContext, ExpectedResult(), weight, weightLimit );
+    BuildResult result = functionId->tryBuildAST( lookupContext, ExpectedResult(), weight, weightLimit );
+    if( !result )
+        return result;
 
     const Identifier *identifier = functionId->tryGetActualExpression<Identifier>();
     ASSERT(identifier)<<"TODO calling function through generic pointer expression not yet implemented";
@@ -41,6 +47,7 @@ void FunctionCall::buildASTImpl(
         ExpectedResult &expectedResult;
         Weight &weight;
         const Weight weightLimit;
+        BuildResult &result;
 
         void operator()( const LookupContext::Variable &var ) {
             ABORT()<<"TODO calling function through a variable not yet implemented";
@@ -54,12 +61,14 @@ void FunctionCall::buildASTImpl(
                 arguments[i] = &_this->parserFunctionCall.arguments.arguments[i];
             }
 
-            _this->resolver.resolveOverloads(
-                    lookupContext, expectedResult, function.overloads,
+            result = _this->resolver.resolveOverloads(
+                    lookupContext, expectedResult, function,
                     weight, weightLimit,
                     _this->metadata, Slice(arguments, numArguments), _this->parserFunctionCall.op );
+            if( !result )
+                return;
+
             _this->metadata.type = downCast( _this->resolver.getType().getReturnType() );
-            _this->metadata.valueRange = _this->metadata.type->defaultRange();
         }
 
         void operator()( const StructMember &member ) {
@@ -70,14 +79,24 @@ void FunctionCall::buildASTImpl(
     std::visit(
             Visitor{
                 ._this=this, .lookupContext=lookupContext, .expectedResult=expectedResult,
-                .weight=weight, .weightLimit=weightLimit,
+                .weight=weight, .weightLimit=weightLimit, .result=result,
             },
             *identifier->getCtxIdentifier()
         );
+
+    return result;
 }
 
 ExpressionId FunctionCall::codeGenImpl( PracticalSemanticAnalyzer::FunctionGen *functionGen ) const {
     return resolver.codeGen( functionGen );
 }
 
+ValueRange FunctionCall::evaluateImpl( Interpreter &interpreter ) const {
+    return resolver.evaluate( interpreter );
+}
+
+ValueRange FunctionCall::getEvaluatedValue() const {
+    return resolver.getEvaluatedValue();
+}
+
 } // namespace AST::ExpressionImpl
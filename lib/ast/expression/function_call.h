@@ -25,12 +25,15 @@ public:
     explicit FunctionCall( const NonTerminals::Expression::FunctionCall &parserFunctionCall );
 
     SourceLocation getLocation() const override;
+    bool hasSideEffects() const override;
 
 protected:
-    void buildASTImpl(
+    BuildResult buildASTImpl(
             LookupContext &lookupContext, ExpectedResult expectedResult, Weight &weight, Weight weightLimit
         ) override;
     ExpressionId codeGenImpl( PracticalSemanticAnalyzer::FunctionGen *functionGen ) const override;
+    ValueRange evaluateImpl( Interpreter &interpreter ) const override;
+    ValueRange getEvaluatedValue() const override;
 };
 
 } // namespace AST::ExpressionImpl
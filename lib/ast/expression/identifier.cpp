@@ -28,7 +28,7 @@ SourceLocation Identifier::getLocation() const {
     return parserIdentifier.identifier->location;
 }
 
-void Identifier::buildASTImpl(
+BuildResult Identifier::buildASTImpl(
         LookupContext &lookupContext, ExpectedResult expectedResult, Weight &weight, Weight weightLimit )
 {
     identifier = lookupContext.lookupIdentifier( parserIdentifier.identifier->text );
@@ -40,11 +40,12 @@ void Identifier::buildASTImpl(
 
     struct Visitor {
         Identifier *_this;
+        const LookupContext &lookupContext;
         ExpectedResult &expectedResult;
 
         void operator()( const LookupContext::Variable &var ) {
             _this->metadata.type = downCast( var.type->addFlags( StaticType::Flags::Reference ) );
-            _this->metadata.valueRange = var.type->defaultRange();
+            _this->metadata.valueRange = lookupContext.lookupVariableRange( var );
         }
 
         void operator()( const LookupContext::Function &func ) {
@@ -59,7 +60,15 @@ void Identifier::buildASTImpl(
         }
     };
 
-    std::visit( Visitor{._this=this, .expectedResult=expectedResult}, *identifier );
+    std::visit( Visitor{._this=this, .lookupContext=lookupContext, .expectedResult=expectedResult}, *identifier );
+
+    return BuildResult();
+}
+
+void Identifier::narrowRanges( bool outcome, LookupContext::RangeNarrowing &narrowing ) const {
+    // A boolean variable used as a condition
+    if( auto variable = std::get_if<LookupContext::Variable>( identifier ) )
+        narrowing.narrow( *variable, BoolValueRange( !outcome, outcome ) );
 }
 
 ExpressionId Identifier::codeGenImpl( PracticalSemanticAnalyzer::FunctionGen *functionGen ) const {
@@ -94,4 +103,16 @@ ExpressionId Identifier::codeGenImpl( PracticalSemanticAnalyzer::FunctionGen *fu
     return std::visit( Visitor{.functionGen = functionGen}, *identifier );
 }
 
+ValueRange Identifier::evaluateImpl( Interpreter &interpreter ) const {
+    auto variable = std::get_if<LookupContext::Variable>( identifier );
+    if( variable==nullptr || ( variable->type->getFlags() & StaticType::Flags::Reference ) )
+        return ValueRange();
+
+    const ValueRange *value = interpreter.lookupVariable( variable->lvalueId );
+    if( value==nullptr )
+        return ValueRange();
+
+    return *value;
+}
+
 } // namespace AST::ExpressionImpl
@@ -28,12 +28,17 @@ public:
     }
 
     SourceLocation getLocation() const override;
+    bool hasSideEffects() const override {
+        return false;
+    }
+    void narrowRanges( bool outcome, LookupContext::RangeNarrowing &narrowing ) const override;
 
 protected:
-    void buildASTImpl(
+    BuildResult buildASTImpl(
             LookupContext &lookupContext, ExpectedResult expectedResult, Weight &weight, Weight weightLimit
         ) override;
     ExpressionId codeGenImpl( PracticalSemanticAnalyzer::FunctionGen *functionGen ) const override;
+    ValueRange evaluateImpl( Interpreter &interpreter ) const override;
 };
 
 } // namespace AST::ExpressionImpl
@@ -29,7 +29,7 @@ SourceLocation Literal::getLocation() const {
     return parserLiteral.getLocation();
 }
 
-void Literal::buildASTImpl(
+BuildResult Literal::buildASTImpl(
         LookupContext &lookupContext, ExpectedResult expectedResult, Weight &weight, Weight weightLimit )
 {
     struct Visitor {
@@ -61,6 +61,8 @@ void Literal::buildASTImpl(
                 .expectedResult = expectedResult
             },
             parserLiteral.literal );
+
+    return BuildResult();
 }
 
 ExpressionId Literal::codeGenImpl( PracticalSemanticAnalyzer::FunctionGen *functionGen ) const {
@@ -95,29 +97,29 @@ void Literal::buildAstInt(
 {
     ASSERT( !metadata.type )<<"Cannot reuse AST nodes";
 
-    StaticTypeImpl::CPtr naturalType;
+    const BuiltinTypes &builtinTypes = AST::getBuiltinTypes();
+    BuiltinTypes::Id naturalTypeId;
     if( literal.value>std::numeric_limits<uint32_t>::max() ) {
         ASSERT( literal.value<=std::numeric_limits<uint64_t>::max() );
-        naturalType = AST::getBuiltinCtx().lookupType("U64");
+        naturalTypeId = BuiltinTypes::Id::U64;
     } else if( literal.value>std::numeric_limits<uint16_t>::max() ) {
-        naturalType = AST::getBuiltinCtx().lookupType("U32");
+        naturalTypeId = BuiltinTypes::Id::U32;
     } else if( literal.value>std::numeric_limits<uint8_t>::max() ) {
-        naturalType = AST::getBuiltinCtx().lookupType("U16");
+        naturalTypeId = BuiltinTypes::Id::U16;
     } else {
-        naturalType = AST::getBuiltinCtx().lookupType("U8");
+        naturalTypeId = BuiltinTypes::Id::U8;
     }
-    ASSERT( naturalType );
+    const StaticTypeImpl::CPtr &naturalType = builtinTypes.get( naturalTypeId );
 
-    metadata.valueRange = UnsignedIntValueRange::allocate( literal.value, literal.value );
+    metadata.valueRange = UnsignedIntValueRange( literal.value, literal.value );
 
     if( !expectedResult ) {
-        static const StaticTypeImpl::CPtr DefaultLiteralIntType =
-                AST::getBuiltinCtx().lookupType("U64");
+        const StaticTypeImpl::CPtr &defaultLiteralIntType = builtinTypes.get( BuiltinTypes::Id::U64 );
         static const Weight DefaultLiteralIntWeight =
-                Weight( std::get< const StaticType::Scalar *>( DefaultLiteralIntType->getType() )->getLiteralWeight(), 0 );
+                Weight( std::get< const StaticType::Scalar *>( defaultLiteralIntType->getType() )->getLiteralWeight(), 0 );
 
         // If nothing is expected, return the maximal unsigned type
-        metadata.type =  DefaultLiteralIntType;
+        metadata.type = defaultLiteralIntType;
         ASSERT( metadata.type );
 
         weight += DefaultLiteralIntWeight;
@@ -132,7 +134,7 @@ void Literal::buildAstInt(
             limit <<= (*expectedScalar)->getSize()-1;
             if( literal.value<limit ) {
                 metadata.type = expectedResult.getType();
-                metadata.valueRange = SignedIntValueRange::allocate( literal.value, literal.value );
+                metadata.valueRange = SignedIntValueRange( literal.value, literal.value );
 
                 weight += Weight( (*expectedScalar)->getLiteralWeight(), 0 );
 
@@ -172,8 +174,8 @@ void Literal::buildAstBool(
         const NonTerminals::LiteralBool &literal, Weight &weight, Weight weightLimit,
         ExpectedResult expectedResult )
 {
-    metadata.type = AST::getBuiltinCtx().lookupType("Bool");
-    metadata.valueRange = BoolValueRange::allocate( literal.value==false, literal.value==true );
+    metadata.type = AST::getBuiltinTypes().get( BuiltinTypes::Id::Bool );
+    metadata.valueRange = BoolValueRange( literal.value==false, literal.value==true );
 }
 
 void Literal::buildAstPointer(
@@ -197,7 +199,7 @@ void Literal::buildAstString(
         const NonTerminals::LiteralString &literal, Weight &weight, Weight weightLimit,
         ExpectedResult expectedResult )
 {
-    auto c8Type = AST::getBuiltinCtx().lookupType("C8");
+    const StaticTypeImpl::CPtr &c8Type = AST::getBuiltinTypes().get( BuiltinTypes::Id::C8 );
     metadata.type = StaticTypeImpl::allocate( PointerTypeImpl( c8Type ) );
     metadata.valueRange = new PointerValueRange( c8Type->defaultRange() );
 }
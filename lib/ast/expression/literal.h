@@ -22,9 +22,12 @@ public:
     explicit Literal( const NonTerminals::Literal &parserLiteral );
 
     SourceLocation getLocation() const override;
+    bool hasSideEffects() const override {
+        return false;
+    }
 
 protected:
-    void buildASTImpl(
+    BuildResult buildASTImpl(
             LookupContext &lookupContext, ExpectedResult expectedResult, Weight &weight, Weight weightLimit
         ) override;
     ExpressionId codeGenImpl( PracticalSemanticAnalyzer::FunctionGen *functionGen ) const override;
@@ -8,16 +8,167 @@
  */
 #include "ast/expression/overload_resolver.h"
 
+#include "ast/ast.h"
 #include "ast/expression.h"
 
-#include <practical/errors.h>
-
 namespace AST::ExpressionImpl {
 
-void OverloadResolver::resolveOverloads(
+namespace {
+
+// An argument whose builtin type doesn't depend on the type expected of it
+struct RigidArgument {
+    BuiltinTypes::Id typeId;
+    ValueRange valueRange;
+};
+
+} // anonymous namespace
+
+// Only identifiers and explicit casts are known not to adapt to the expected type
+static std::optional<RigidArgument> rigidArgument(
+        LookupContext &lookupContext, const NonTerminals::Expression &parserArgument )
+{
+    if(
+            !std::holds_alternative<NonTerminals::Identifier>( parserArgument.value ) &&
+            !std::holds_alternative<NonTerminals::Expression::CastOperator>( parserArgument.value ) )
+    {
+        return {};
+    }
+
+    Expression argument( parserArgument );
+    Weight weight;
+    if( !argument.tryBuildAST( lookupContext, ExpectedResult(), weight, Base::NoWeightLimit ) ) {
+        // Let the actual call report the error
+        return {};
+    }
+
+    StaticTypeImpl::CPtr type = argument.getType();
+    if( ( type->getFlags() & ~StaticType::Flags::Reference )!=0 )
+        return {};
+
+    auto typeId = BuiltinTypes::idOf( type.get() );
+    if( !typeId )
+        return {};
+
+    return RigidArgument{ .typeId = *typeId, .valueRange = argument.getValueRange() };
+}
+
+// Whether an overload might accept the arguments. Only returns false if some argument cannot be implicitly cast to
+// the type the overload expects.
+static bool possiblyViable(
+        const LookupContext::Function::Definition *overload,
+        Slice< const std::optional<RigidArgument> > arguments )
+{
+    auto functionType = std::get<const StaticType::Function *>( overload->type->getType() );
+    ASSERT( functionType->getNumArguments()==arguments.size() );
+
+    const CastTable &castTable = AST::getCastTable();
+    for( unsigned argumentNum=0; argumentNum<arguments.size(); ++argumentNum ) {
+        const std::optional<RigidArgument> &argument = arguments[argumentNum];
+        if( !argument )
+            continue;
+
+        auto parameterType = static_cast<const StaticTypeImpl *>( functionType->getArgumentType(argumentNum).get() );
+        if( parameterType->getFlags()!=0 )
+            continue;
+
+        auto parameterId = BuiltinTypes::idOf( parameterType );
+        if( !parameterId || *parameterId==argument->typeId )
+            continue;
+
+        const CastTable::Path &path = castTable.lookup( argument->typeId, *parameterId );
+        if( !path.reachable || !path.implicitlyAllows( argument->valueRange ) )
+            return false;
+    }
+
+    return true;
+}
+
+// Whether the overload's return type might be implicitly cast to the destination type
+static bool returnPossiblyCastable(
+        const LookupContext::Function::Definition *overload, const StaticTypeImpl::CPtr &destinationType )
+{
+    auto returnType = static_cast<const StaticTypeImpl *>( overload->returnType().get() );
+    if( *returnType==*destinationType )
+        return true;
+
+    if( returnType->getFlags()!=0 || destinationType->getFlags()!=0 )
+        return true;
+
+    auto sourceId = BuiltinTypes::idOf( returnType );
+    auto destinationId = BuiltinTypes::idOf( destinationType.get() );
+    if( !sourceId || !destinationId )
+        return true;
+
+    return AST::getCastTable().lookup( *sourceId, *destinationId ).reachable;
+}
+
+// Returns the overload all of whose arguments are of the builtin type the arguments already have, if any
+static const LookupContext::Function::Definition *sameTypeOverload(
+        LookupContext &lookupContext,
+        const OverloadResolver::OperatorOverloads &overloads,
+        Slice<const NonTerminals::Expression *const> parserArguments )
+{
+    std::optional<BuiltinTypes::Id> typeId;
+    for( const NonTerminals::Expression *parserArgument : parserArguments ) {
+        std::optional<RigidArgument> argument = rigidArgument( lookupContext, *parserArgument );
+        if( !argument || ( typeId && *typeId!=argument->typeId ) )
+            return nullptr;
+
+        typeId = argument->typeId;
+    }
+
+    if( !typeId )
+        return nullptr;
+
+    return overloads.sameTypeOverloads[ static_cast<size_t>(*typeId) ];
+}
+
+void OverloadResolver::OperatorOverloads::init( const LookupContext::Function &function, size_t numArguments ) {
+    this->function = &function;
+    sameTypeOverloads.fill( nullptr );
+
+    const LookupContext::Function::ArityOverloads *overloads = function.lookupArity( numArguments );
+    if( overloads==nullptr )
+        return;
+
+    for( const LookupContext::Function::Definition *overload : overloads->all ) {
+        auto functionType = std::get<const StaticType::Function *>( overload->type->getType() );
+        ASSERT( functionType->getNumArguments()==numArguments );
+
+        auto builtinArgumentId = [functionType]( unsigned argumentNum ) -> std::optional<BuiltinTypes::Id> {
+            auto argumentType =
+                    static_cast<const StaticTypeImpl *>( functionType->getArgumentType(argumentNum).get() );
+            if( argumentType->getFlags()!=0 )
+                return std::nullopt;
+
+            return BuiltinTypes::idOf( argumentType );
+        };
+
+        // Only overloads whose arguments are all of the same builtin type go in the table
+        std::optional<BuiltinTypes::Id> firstId;
+        if( numArguments>0 )
+            firstId = builtinArgumentId( 0 );
+        if( !firstId )
+            continue;
+
+        const BuiltinTypes::Id typeId = *firstId;
+        bool sameType = true;
+        for( unsigned argumentNum=1; argumentNum<numArguments && sameType; ++argumentNum )
+            sameType = builtinArgumentId( argumentNum )==typeId;
+
+        if( !sameType )
+            continue;
+
+        const LookupContext::Function::Definition *&slot = sameTypeOverloads[ static_cast<size_t>(typeId) ];
+        ASSERT( slot==nullptr )<<"Operator "<<overload->mangledName<<" has two overloads taking builtin type "<<static_cast<int>(typeId);
+        slot = overload;
+    }
+}
+
+BuildResult OverloadResolver::resolveOverloads(
         LookupContext &lookupContext,
         ExpectedResult expectedResult,
-        const LookupContext::Function::OverloadsContainer &overloads,
+        const LookupContext::Function &function,
         Weight &weight,
         Weight weightLimit,
         ExpressionMetadata &metadata,
@@ -25,16 +176,54 @@ void OverloadResolver::resolveOverloads(
         const Tokenizer::Token *sourceLocation
     )
 {
+    const LookupContext::Function::ArityOverloads *overloads = function.lookupArity( parserArguments.size() );
+    if( overloads==nullptr ) {
+        return BuildResult::noMatchingOverload( sourceLocation );
+    }
+
+    if( overloads->all.size()==1 ) {
+        // It's the only one that might match. Either it matches or compile error.
+        return buildActualCall( lookupContext, weight, weightLimit, overloads->all[0], metadata, parserArguments );
+    }
+
     if( expectedResult ) {
-        resolveOverloadsByReturn(
-                lookupContext, expectedResult, overloads, weight, weightLimit, metadata, parserArguments,
+        return resolveOverloadsByReturn(
+                lookupContext, expectedResult, *overloads, weight, weightLimit, metadata, parserArguments,
                 sourceLocation );
     } else {
-        resolveOverloadsByArguments(
-                lookupContext, overloads, weight, weightLimit, metadata, parserArguments, sourceLocation );
+        return resolveOverloadsByArguments(
+                lookupContext, *overloads, weight, weightLimit, metadata, parserArguments, sourceLocation );
     }
 }
 
+BuildResult OverloadResolver::resolveOperator(
+        LookupContext &lookupContext,
+        ExpectedResult expectedResult,
+        const OperatorOverloads &overloads,
+        Weight &weight,
+        Weight weightLimit,
+        ExpressionMetadata &metadata,
+        Slice<const NonTerminals::Expression *const> parserArguments,
+        const Tokenizer::Token *sourceLocation
+    )
+{
+    ASSERT( overloads.function );
+
+    // An exact match needs no casts, so any other candidate weighs more. When a result type is expected, this only
+    // holds if the exact match also returns it.
+    const LookupContext::Function::Definition *overload =
+            sameTypeOverload( lookupContext, overloads, parserArguments );
+    if( overload!=nullptr && ( !expectedResult || *overload->returnType()==*expectedResult.getType() ) ) {
+        ++AST::getStatistics().operatorsResolvedDirectly;
+
+        return buildActualCall( lookupContext, weight, weightLimit, overload, metadata, parserArguments );
+    }
+
+    return resolveOverloads(
+            lookupContext, expectedResult, *overloads.function, weight, weightLimit, metadata, parserArguments,
+            sourceLocation );
+}
+
 const FunctionTypeImpl &OverloadResolver::getType() const {
     ASSERT(definition)<<"Tried to getType from unresolved overloads";
 
@@ -45,12 +234,48 @@ const FunctionTypeImpl &OverloadResolver::getType() const {
     return *downCast(*functionType);
 }
 
+bool OverloadResolver::hasSideEffects() const {
+    if( !definition->isBuiltin() && !evaluatedValue )
+        return true;
+
+    for( const Expression &argument : arguments ) {
+        if( argument.hasSideEffects() )
+            return true;
+    }
+
+    return false;
+}
+
 ExpressionId OverloadResolver::codeGen( PracticalSemanticAnalyzer::FunctionGen *functionGen ) const {
     return definition->codeGen( arguments, definition, functionGen );
 }
 
+ValueRange OverloadResolver::evaluate( Interpreter &interpreter ) const {
+    if( evaluatedValue )
+        return evaluatedValue;
+
+    std::vector<ValueRange> argumentValues;
+    argumentValues.reserve( arguments.size() );
+    for( const Expression &argument : arguments ) {
+        if( !argumentValues.emplace_back( argument.evaluate( interpreter ) ) )
+            return ValueRange();
+    }
+
+    Slice<const ValueRange> values( argumentValues );
+    if( definition->calcVrp ) {
+        // VRP is exact, so it computes the result of literal arguments
+        ValueRange result = definition->calcVrp( definition->type, values );
+        if( !result || !result.isLiteral() )
+            return ValueRange();
+
+        return result;
+    }
+
+    return interpreter.call( definition, values );
+}
+
 // Private
-void OverloadResolver::buildActualCall(
+BuildResult OverloadResolver::buildActualCall(
             LookupContext &lookupContext, Weight &weight, Weight weightLimit,
             const LookupContext::Function::Definition *definition,
             ExpressionMetadata &metadata,
@@ -65,9 +290,12 @@ void OverloadResolver::buildActualCall(
     for( unsigned argumentNum=0; argumentNum<numArguments; ++argumentNum ) {
         Expression &argument = arguments.emplace_back( *parserArguments[argumentNum] );
         Weight additionalWeight;
-        argument.buildAST(
+        BuildResult result = argument.tryBuildAST(
                 lookupContext, ExpectedResult( functionType->getArgumentType(argumentNum) ),
                 additionalWeight, weightLimit );
+        if( !result )
+            return result;
+
         ASSERT( additionalWeight<=weightLimit );
         weight+=additionalWeight;
         weightLimit-=additionalWeight;
@@ -75,24 +303,43 @@ void OverloadResolver::buildActualCall(
 
     StaticTypeImpl::CPtr returnType = static_cast<const StaticTypeImpl *>( functionType->getReturnType().get() );
     if( definition->calcVrp ) {
-        ValueRangeBase::CPtr inputRanges[ numArguments ];
-        for( unsigned argumentNum=0; argumentNum<numArguments; ++argumentNum ) {
-            inputRanges[argumentNum] = arguments[argumentNum].getValueRange();
-        }
+        std::vector<ValueRange> inputRanges;
+        inputRanges.reserve( numArguments );
+        for( const Expression &argument : arguments )
+            inputRanges.emplace_back( argument.getValueRange() );
+
+        metadata.valueRange = definition->calcVrp( definition->type, inputRanges );
+
+        // Operands computed at build time give the operation a value as well. Like theirs, it is only used for folding.
+        if( metadata.valueRange && !metadata.valueRange.isLiteral() ) {
+            bool allKnown = true;
+            for( unsigned argumentNum=0; allKnown && argumentNum<numArguments; ++argumentNum ) {
+                inputRanges[argumentNum] = arguments[argumentNum].getKnownValue();
+                allKnown = static_cast<bool>( inputRanges[argumentNum] );
+            }
 
-        metadata.valueRange = definition->calcVrp( definition->type, Slice( inputRanges, numArguments ) );
+            if( allKnown ) {
+                ValueRange value = definition->calcVrp( definition->type, inputRanges );
+                if( value && value.getKind()!=ValueRange::Kind::Compound && value.isLiteral() )
+                    evaluatedValue = std::move( value );
+            }
+        }
     } else {
+        // Calls with known arguments to functions that were already analyzed can be computed right away
+        evaluatedValue = Interpreter::evaluateCall( definition, arguments );
         metadata.valueRange = returnType->defaultRange();
     }
     metadata.type = std::move(returnType);
 
     this->definition = definition;
+
+    return BuildResult();
 }
 
-void OverloadResolver::resolveOverloadsByReturn(
+BuildResult OverloadResolver::resolveOverloadsByReturn(
         LookupContext &lookupContext,
         ExpectedResult expectedResult,
-        const LookupContext::Function::OverloadsContainer &overloads,
+        const LookupContext::Function::ArityOverloads &overloads,
         Weight &weight,
         Weight weightLimit,
         ExpressionMetadata &metadata,
@@ -100,62 +347,26 @@ void OverloadResolver::resolveOverloadsByReturn(
         const Tokenizer::Token *sourceLocation
     )
 {
-    std::unordered_map<
-            StaticType::CPtr,
-            std::vector< const LookupContext::Function::Definition * >
-        > sortedOverloads;
-    size_t numArguments = parserArguments.size();
-
-    for( auto &overload : overloads ) {
-        auto overloadType = std::get<const StaticType::Function *>(overload.second.type->getType());
-        if( overloadType->getNumArguments() == numArguments ) {
-            sortedOverloads[ overloadType->getReturnType() ].emplace_back( &overload.second );
-        }
-    }
-
-    if( sortedOverloads.size()==0 ) {
-        throw NoMatchingOverload( sourceLocation );
-    }
-
-    if( sortedOverloads.size()==1 && sortedOverloads.begin()->second.size()==1 ) {
-        // It's the only one that might match. Either it matches or compile error.
-        buildActualCall(
-                lookupContext, weight, weightLimit, *sortedOverloads.begin()->second.begin(), metadata, parserArguments );
-        return;
-    }
-
-    auto currentReturnCandidate = sortedOverloads.find( expectedResult.getType() );
-    if( currentReturnCandidate!=sortedOverloads.end() ) {
+    auto currentReturnCandidate = overloads.byReturnType.find( expectedResult.getType() );
+    if( currentReturnCandidate!=overloads.byReturnType.end() ) {
         ASSERT( ! currentReturnCandidate->second.empty() );
 
-        if( currentReturnCandidate->second.size()==1 ) {
-            // Only one overload matches the return type exactly
-            buildActualCall(
-                    lookupContext, weight, weightLimit, currentReturnCandidate->second[0], metadata, parserArguments );
-            return;
-        }
-
-        try {
-            findBestOverloadByArgument(
-                    lookupContext, currentReturnCandidate->second, weight, weightLimit, metadata,
-                    parserArguments, sourceLocation );
-
-            return;
-        } catch( NoMatchingOverload &ex ) {
-        }
+        BuildResult result = findBestOverloadByArgument(
+                lookupContext, currentReturnCandidate->second, weight, weightLimit, metadata,
+                parserArguments, sourceLocation );
+        if( result.getStatus()!=BuildResult::Status::NoMatch )
+            return result;
     }
 
-    ABORT()<<"TODO implement";
-
-    /*
-    buildActualCall(
-            lookupContext, expectedResult, weight, weightLimit, preciseResultOverloads[0], metadata, parserArguments );
-    */
+    // No overload returning the expected type matches. Choose among those whose return type can be cast to it.
+    return findBestOverloadByArgument(
+            lookupContext, overloads.all, weight, weightLimit, metadata, parserArguments, sourceLocation,
+            expectedResult );
 }
 
-void OverloadResolver::resolveOverloadsByArguments(
+BuildResult OverloadResolver::resolveOverloadsByArguments(
         LookupContext &lookupContext,
-        const LookupContext::Function::OverloadsContainer &overloads,
+        const LookupContext::Function::ArityOverloads &overloads,
         Weight &weight,
         Weight weightLimit,
         ExpressionMetadata &metadata,
@@ -163,39 +374,19 @@ void OverloadResolver::resolveOverloadsByArguments(
         const Tokenizer::Token *sourceLocation
     )
 {
-    std::vector<const LookupContext::Function::Definition *> relevantOverloads;
-    size_t numArguments = parserArguments.size();
-
-    for( auto &overload : overloads ) {
-        auto overloadType = std::get<const StaticType::Function *>(overload.second.type->getType());
-        if( overloadType->getNumArguments() == numArguments ) {
-            relevantOverloads.emplace_back( &overload.second );
-        }
-    }
-
-    if( relevantOverloads.size()==0 ) {
-        throw NoMatchingOverload( sourceLocation );
-    }
-
-    if( relevantOverloads.size()==1 ) {
-        // It's the only one that might match. Either it matches or compile error.
-        buildActualCall(
-                lookupContext, weight, weightLimit, relevantOverloads[0], metadata, parserArguments );
-        return;
-    }
-
-    findBestOverloadByArgument(
-            lookupContext, relevantOverloads, weight, weightLimit, metadata, parserArguments, sourceLocation );
+    return findBestOverloadByArgument(
+            lookupContext, overloads.all, weight, weightLimit, metadata, parserArguments, sourceLocation );
 }
 
-void OverloadResolver::findBestOverloadByArgument(
+BuildResult OverloadResolver::findBestOverloadByArgument(
         LookupContext &lookupContext,
-        Slice< const LookupContext::Function::Definition * > overloads,
+        Slice< const LookupContext::Function::Definition *const > overloads,
         Weight &weight,
         Weight weightLimit,
         ExpressionMetadata &metadata,
         Slice<const NonTerminals::Expression *const> parserArguments,
-        const Tokenizer::Token *sourceLocation
+        const Tokenizer::Token *sourceLocation,
+        ExpectedResult castResultTo
     )
 {
     Weight callWeightLimit = weightLimit - weight;
@@ -203,43 +394,60 @@ void OverloadResolver::findBestOverloadByArgument(
     OverloadResolver bestOverloader;
     ExpressionMetadata bestMetadata;
     std::vector< const LookupContext::Function::Definition * > viableOverloads;
+    Statistics &statistics = AST::getStatistics();
+
+    size_t numArguments = parserArguments.size();
+    std::vector< std::optional<RigidArgument> > rigidArguments;
+    rigidArguments.reserve( numArguments );
+    for( unsigned argumentNum=0; argumentNum<numArguments; ++argumentNum ) {
+        rigidArguments.emplace_back( rigidArgument( lookupContext, *parserArguments[argumentNum] ) );
+    }
 
     for( auto overload : overloads ) {
-        try {
-            OverloadResolver provisoryResolver;
-            Weight callWeight;
-            ExpressionMetadata callMetadata;
-
-            provisoryResolver.buildActualCall(
-                    lookupContext, callWeight, callWeightLimit, overload, callMetadata, parserArguments );
-
-            if( callWeight<bestWeight ) {
-                bestWeight = callWeight;
-                callWeightLimit = callWeight;
-                viableOverloads.clear();
-                bestOverloader = std::move( provisoryResolver );
-                bestMetadata = std::move( callMetadata );
-            }
+        ++statistics.overloadCandidates;
+        if(
+                !possiblyViable( overload, Slice( rigidArguments.data(), numArguments ) ) ||
+                ( castResultTo && !returnPossiblyCastable( overload, castResultTo.getType() ) ) )
+        {
+            ++statistics.overloadCandidatesPruned;
+            continue;
+        }
 
-            viableOverloads.emplace_back( overload );
-        } catch( NoMatchingOverload &ex ) {
-        } catch( AmbiguousOverloads &ex ) {
-        } catch( CastError &ex ) {
-        } catch( Base::ExpressionTooExpensive &ex ) {
+        ++statistics.overloadCandidatesBuilt;
+        OverloadResolver provisoryResolver;
+        Weight callWeight;
+        ExpressionMetadata callMetadata;
+
+        if( !provisoryResolver.buildActualCall(
+                    lookupContext, callWeight, callWeightLimit, overload, callMetadata, parserArguments ) )
+        {
+            continue;
         }
+
+        if( callWeight<bestWeight ) {
+            bestWeight = callWeight;
+            callWeightLimit = callWeight;
+            viableOverloads.clear();
+            bestOverloader = std::move( provisoryResolver );
+            bestMetadata = std::move( callMetadata );
+        }
+
+        viableOverloads.emplace_back( overload );
     }
 
     if( viableOverloads.empty() )
-        throw NoMatchingOverload( sourceLocation );
+        return BuildResult::noMatchingOverload( sourceLocation );
 
     if( viableOverloads.size()>1 )
-        throw AmbiguousOverloads( sourceLocation );
+        return BuildResult::ambiguousOverloads( sourceLocation );
 
     weight += bestWeight;
     ASSERT( weight<=weightLimit );
 
     (*this) = std::move( bestOverloader );
     metadata = std::move( bestMetadata );
+
+    return BuildResult();
 }
 
 } // namespace AST::ExpressionImpl
@@ -10,20 +10,54 @@
 #define AST_EXPRESSION_OVERLOAD_RESOLVER_H
 
 #include "ast/expression/base.h"
+#include "ast/builtin_types.h"
 #include "ast/expected_result.h"
 #include "ast/lookup_context.h"
+#include "tokenizer.h"
+
+#include <array>
 
 namespace AST::ExpressionImpl {
 
 class OverloadResolver {
     std::vector<Expression> arguments;
     const LookupContext::Function::Definition *definition;
+    // The result of a call to a module function, if it was computed at compile time. Only used for folding the call:
+    // the call's value range is the return type's default either way, so that implicit casts of the result are allowed
+    // or not regardless of which functions happened to be analyzed first.
+    ValueRange evaluatedValue;
 
 public:
-    void resolveOverloads(
+    // A builtin operator's overloads, looked up once when the builtin context is prepared
+    struct OperatorOverloads {
+        const LookupContext::Function *function = nullptr;
+        // Per builtin type, the overload whose arguments are all of that type
+        std::array< const LookupContext::Function::Definition *, BuiltinTypes::NumIds > sameTypeOverloads{};
+
+        void init( const LookupContext::Function &function, size_t numArguments );
+    };
+
+    // Operators' overloads, indexed by the operator's token
+    using OperatorTable =
+            std::array< OperatorOverloads, static_cast<size_t>( Tokenizer::Tokens::OP_RUNON_ERROR ) >;
+
+    BuildResult resolveOverloads(
             LookupContext &lookupContext,
             ExpectedResult expectedResult,
-            const LookupContext::Function::OverloadsContainer &overloads,
+            const LookupContext::Function &function,
+            Weight &weight,
+            Weight weightLimit,
+            ExpressionMetadata &metadata,
+            Slice<const NonTerminals::Expression *const> parserArguments,
+            const Tokenizer::Token *sourceLocation
+        );
+
+    // Same as resolveOverloads, except that when all operands are known to be of the same builtin type, the overload
+    // for that type is picked directly
+    BuildResult resolveOperator(
+            LookupContext &lookupContext,
+            ExpectedResult expectedResult,
+            const OperatorOverloads &overloads,
             Weight &weight,
             Weight weightLimit,
             ExpressionMetadata &metadata,
@@ -33,42 +67,54 @@ public:
 
     const FunctionTypeImpl &getType() const;
 
+    Slice<const Expression> getArguments() const {
+        return arguments;
+    }
+
+    bool hasSideEffects() const;
+
+    const ValueRange &getEvaluatedValue() const {
+        return evaluatedValue;
+    }
+
     ExpressionId codeGen( PracticalSemanticAnalyzer::FunctionGen *functionGen ) const;
+    ValueRange evaluate( Interpreter &interpreter ) const;
 
 private:
-    void buildActualCall(
+    BuildResult buildActualCall(
             LookupContext &lookupContext, Weight &weight, Weight weightLimit,
             const LookupContext::Function::Definition *definition,
             ExpressionMetadata &metadata,
             Slice<const NonTerminals::Expression *const> parserArguments );
 
-    void resolveOverloadsByReturn(
+    BuildResult resolveOverloadsByReturn(
             LookupContext &lookupContext,
             ExpectedResult expectedResult,
-            const LookupContext::Function::OverloadsContainer &overloads,
+            const LookupContext::Function::ArityOverloads &overloads,
             Weight &weight,
             Weight weightLimit,
             ExpressionMetadata &metadata,
             Slice<const NonTerminals::Expression *const> parserArguments,
             const Tokenizer::Token *sourceLocation
         );
-    void resolveOverloadsByArguments(
+    BuildResult resolveOverloadsByArguments(
             LookupContext &lookupContext,
-            const LookupContext::Function::OverloadsContainer &overloads,
+            const LookupContext::Function::ArityOverloads &overloads,
             Weight &weight,
             Weight weightLimit,
             ExpressionMetadata &metadata,
             Slice<const NonTerminals::Expression *const> parserArguments,
             const Tokenizer::Token *sourceLocation
         );
-    void findBestOverloadByArgument(
+    BuildResult findBestOverloadByArgument(
             LookupContext &lookupContext,
-            Slice< const LookupContext::Function::Definition * > overloads,
+            Slice< const LookupContext::Function::Definition *const > overloads,
             Weight &weight,
             Weight weightLimit,
             ExpressionMetadata &metadata,
             Slice<const NonTerminals::Expression *const> parserArguments,
-            const Tokenizer::Token *sourceLocation
+            const Tokenizer::Token *sourceLocation,
+            ExpectedResult castResultTo = ExpectedResult()
         );
 };
 
@@ -10,32 +10,30 @@
 
 #include "ast/operators/boolean.h"
 
+#include <array>
 #include <experimental/array>
 
 namespace AST::ExpressionImpl {
 
 // Non member private helpers
 static std::unordered_map< Tokenizer::Tokens, std::string > operatorNames;
-
-static String opToFuncName( Tokenizer::Tokens token ) {
-    return operatorNames.at(token);
-}
+static OverloadResolver::OperatorTable operators;
 
 // Static methods
-void UnaryOp::init(LookupContext &builtinCtx) {
+void UnaryOp::init(LookupContext &builtinCtx, const BuiltinTypes &builtinTypes) {
     auto unsignedTypes = std::experimental::make_array<const StaticTypeImpl::CPtr>(
-        builtinCtx.lookupType( "U8" ),
-        builtinCtx.lookupType( "U16" ),
-        builtinCtx.lookupType( "U32" ),
-        builtinCtx.lookupType( "U64" )
+        builtinTypes.get( BuiltinTypes::Id::U8 ),
+        builtinTypes.get( BuiltinTypes::Id::U16 ),
+        builtinTypes.get( BuiltinTypes::Id::U32 ),
+        builtinTypes.get( BuiltinTypes::Id::U64 )
     );
     auto signedTypes = std::experimental::make_array<const StaticTypeImpl::CPtr>(
-        builtinCtx.lookupType( "S8" ),
-        builtinCtx.lookupType( "S16" ),
-        builtinCtx.lookupType( "S32" ),
-        builtinCtx.lookupType( "S64" )
+        builtinTypes.get( BuiltinTypes::Id::S8 ),
+        builtinTypes.get( BuiltinTypes::Id::S16 ),
+        builtinTypes.get( BuiltinTypes::Id::S32 ),
+        builtinTypes.get( BuiltinTypes::Id::S64 )
     );
-    const StaticTypeImpl::CPtr boolType = builtinCtx.lookupType( "Bool" );
+    const StaticTypeImpl::CPtr boolType = builtinTypes.get( BuiltinTypes::Id::Bool );
 
     auto inserter = operatorNames.emplace( Tokenizer::Tokens::OP_ARROW, "__opArrow" );
     inserter = operatorNames.emplace( Tokenizer::Tokens::OP_AMPERSAND, "__opAmpersand" );
@@ -46,7 +44,18 @@ void UnaryOp::init(LookupContext &builtinCtx) {
     inserter = operatorNames.emplace( Tokenizer::Tokens::OP_PLUS, "__opPlus" );
     inserter = operatorNames.emplace( Tokenizer::Tokens::OP_PLUS_PLUS, "__opPlusPlus" );
     inserter = operatorNames.emplace( Tokenizer::Tokens::OP_LOGIC_NOT, "__opNot" );
-    builtinCtx.addBuiltinFunction( inserter.first->second, boolType, { boolType }, Operators::logicalNot, Operators::logicalNotVrp );
+    std::array<StaticTypeImpl::CPtr, 1> notArgumentTypes{ boolType };
+    builtinCtx.addBuiltinFunction(
+            inserter.first->second, boolType, notArgumentTypes, Operators::logicalNot, Operators::logicalNotVrp );
+
+    for( const auto &[token, name] : operatorNames ) {
+        OverloadResolver::OperatorOverloads &overloads = operators[ static_cast<size_t>(token) ];
+        overloads = OverloadResolver::OperatorOverloads();
+
+        const LookupContext::Identifier *identifier = builtinCtx.lookupIdentifier( name );
+        if( identifier!=nullptr )
+            overloads.init( std::get<LookupContext::Function>(*identifier), 1 );
+    }
 }
 
 UnaryOp::UnaryOp( const NonTerminals::Expression::UnaryOperator &parserOp ) :
@@ -57,45 +66,52 @@ SourceLocation UnaryOp::getLocation() const {
     return parserOp.op->location;
 }
 
+bool UnaryOp::hasSideEffects() const {
+    if( auto resolver = std::get_if<OverloadResolver>( &body ) )
+        return resolver->hasSideEffects();
+
+    // Taking an address or dereferencing hide their operand. Assume the worst.
+    return true;
+}
+
+void UnaryOp::narrowRanges( bool outcome, LookupContext::RangeNarrowing &narrowing ) const {
+    if( parserOp.op->token!=Tokenizer::Tokens::OP_LOGIC_NOT )
+        return;
+
+    std::get<OverloadResolver>( body ).getArguments()[0].narrowRanges( !outcome, narrowing );
+}
+
 // Protected methods
-void UnaryOp::buildASTImpl(
+BuildResult UnaryOp::buildASTImpl(
         LookupContext &lookupContext, ExpectedResult expectedResult, Weight &weight, Weight weightLimit )
 {
-    bool defaultHandling = true;
-
     // The special cases
     switch( parserOp.op->token ) {
     case Tokenizer::Tokens::OP_AMPERSAND:
-        defaultHandling = false;
-        body.emplace<AddressOf>( *parserOp.operand ).
+        return body.emplace<AddressOf>( *parserOp.operand ).
                 buildASTImpl(lookupContext, expectedResult, metadata, weight, weightLimit);
-        break;
     case Tokenizer::Tokens::OP_PTR:
-        defaultHandling = false;
-        body.emplace<Dereference>( *parserOp.operand ).
+        return body.emplace<Dereference>( *parserOp.operand ).
                 buildASTImpl(lookupContext, expectedResult, metadata, weight, weightLimit);
-        break;
     default:
         break;
     }
 
-    if( defaultHandling ) {
-        buildASTFromTemplate(body.emplace<OverloadResolver>(), lookupContext, expectedResult, weight, weightLimit);
-    }
+    return buildASTFromTemplate(
+            body.emplace<OverloadResolver>(), lookupContext, expectedResult, weight, weightLimit);
 }
 
-void UnaryOp::buildASTFromTemplate(
+BuildResult UnaryOp::buildASTFromTemplate(
         OverloadResolver &resolver, LookupContext &lookupContext, ExpectedResult expectedResult,
         Weight &weight, Weight weightLimit )
 {
-    String baseName = opToFuncName( parserOp.op->token );
-    auto identifier = lookupContext.lookupIdentifier( baseName );
-    ASSERT( identifier )<<"Unary operator "<<parserOp.op->token<<" is not yet implemented by the compiler";
-    const LookupContext::Function &function =
-            std::get<LookupContext::Function>(*identifier);
-
-    resolver.resolveOverloads( lookupContext, expectedResult, function.overloads, weight, weightLimit, metadata,
-            { parserOp.operand.get() }, parserOp.op );
+    size_t index = static_cast<size_t>( parserOp.op->token );
+    ASSERT( index<operators.size() && operators[index].function )<<
+            "Unary operator "<<parserOp.op->token<<" is not yet implemented by the compiler";
+
+    std::array<const NonTerminals::Expression *, 1> operands{ parserOp.operand.get() };
+    return resolver.resolveOperator(
+            lookupContext, expectedResult, operators[index], weight, weightLimit, metadata, operands, parserOp.op );
 }
 
 ExpressionId UnaryOp::codeGenImpl( PracticalSemanticAnalyzer::FunctionGen *functionGen ) const {
@@ -122,4 +138,18 @@ ExpressionId UnaryOp::codeGenImpl( PracticalSemanticAnalyzer::FunctionGen *funct
     return std::visit( Visitor{ .functionGen = functionGen }, body );
 }
 
+ValueRange UnaryOp::evaluateImpl( Interpreter &interpreter ) const {
+    if( auto resolver = std::get_if<OverloadResolver>( &body ) )
+        return resolver->evaluate( interpreter );
+
+    return ValueRange();
+}
+
+ValueRange UnaryOp::getEvaluatedValue() const {
+    if( auto resolver = std::get_if<OverloadResolver>( &body ) )
+        return resolver->getEvaluatedValue();
+
+    return ValueRange();
+}
+
 } // namespace AST::ExpressionImpl
@@ -9,6 +9,7 @@
 #ifndef AST_EXPRESSION_UNARY_OP_H
 #define AST_EXPRESSION_UNARY_OP_H
 
+#include "ast/builtin_types.h"
 #include "ast/expression/address_of.h"
 #include "ast/expression/dereference.h"
 #include "ast/expression/overload_resolver.h"
@@ -22,20 +23,24 @@ class UnaryOp final : public Base {
     std::variant<std::monostate, OverloadResolver, AddressOf, Dereference> body;
 
 public:
-    static void init(LookupContext &builtinCtx);
+    static void init(LookupContext &builtinCtx, const BuiltinTypes &builtinTypes);
 
     explicit UnaryOp( const NonTerminals::Expression::UnaryOperator &parserOp );
 
     SourceLocation getLocation() const override;
+    bool hasSideEffects() const override;
+    void narrowRanges( bool outcome, LookupContext::RangeNarrowing &narrowing ) const override;
 
 protected:
-    void buildASTImpl(
+    BuildResult buildASTImpl(
             LookupContext &lookupContext, ExpectedResult expectedResult, Weight &weight, Weight weightLimit
         ) override;
     ExpressionId codeGenImpl( PracticalSemanticAnalyzer::FunctionGen *functionGen ) const override;
+    ValueRange evaluateImpl( Interpreter &interpreter ) const override;
+    ValueRange getEvaluatedValue() const override;
 
 private:
-    void buildASTFromTemplate(
+    BuildResult buildASTFromTemplate(
             OverloadResolver &resolver, LookupContext &lookupContext, ExpectedResult expectedResult,
             Weight &weight, Weight weightLimit
         );
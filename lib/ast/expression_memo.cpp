@@ -0,0 +1,60 @@
+/* This file is part of the Practical programming langauge. https://github.com/Practical/practical-sa
+ *
+ * To the extent header files enjoy copyright protection, this file is file is copyright (C) 2021 by its authors
+ * You can see the file's authors in the AUTHORS file in the project's home repository.
+ *
+ * This is available under the Boost license. The license's text is available under the LICENSE file in the project's
+ * home directory.
+ */
+#include "ast/expression_memo.h"
+
+namespace AST {
+
+size_t ExpressionMemo::KeyHash::operator()( const Key &key ) const {
+    size_t ret = std::hash<const NonTerminals::Expression *>()( key.parserExpression );
+
+    if( key.expectedType )
+        ret ^= std::hash<PracticalSemanticAnalyzer::StaticType::CPtr>()( key.expectedType ) * 31;
+
+    return ret ^ key.mandatory;
+}
+
+const ExpressionMemo::Entry *ExpressionMemo::lookup(
+        const NonTerminals::Expression &parserExpression, const ExpectedResult &expectedResult, Weight budget )
+{
+    auto iter = _entries.find( makeKey( parserExpression, expectedResult ) );
+    if( iter==_entries.end() )
+        return nullptr;
+
+    const Entry &entry = iter->second;
+
+    // A failure might have been caused by the weight limit. It is only known to repeat with an equal or smaller budget.
+    if( !entry.expression && entry.weight<budget )
+        return nullptr;
+
+    ++_hits;
+
+    return &entry;
+}
+
+void ExpressionMemo::addSuccess(
+        const NonTerminals::Expression &parserExpression, const ExpectedResult &expectedResult,
+        std::shared_ptr<const ExpressionImpl::Base> expression, Weight weight )
+{
+    ++_builds;
+    _entries.insert_or_assign(
+            makeKey( parserExpression, expectedResult ),
+            Entry{ .expression = std::move(expression), .weight = weight, .failure = BuildResult() } );
+}
+
+void ExpressionMemo::addFailure(
+        const NonTerminals::Expression &parserExpression, const ExpectedResult &expectedResult,
+        const BuildResult &failure, Weight budget )
+{
+    ++_builds;
+    _entries.insert_or_assign(
+            makeKey( parserExpression, expectedResult ),
+            Entry{ .expression = nullptr, .weight = budget, .failure = failure } );
+}
+
+} // namespace AST
@@ -0,0 +1,95 @@
+/* This file is part of the Practical programming langauge. https://github.com/Practical/practical-sa
+ *
+ * To the extent header files enjoy copyright protection, this file is file is copyright (C) 2021 by its authors
+ * You can see the file's authors in the AUTHORS file in the project's home repository.
+ *
+ * This is available under the Boost license. The license's text is available under the LICENSE file in the project's
+ * home directory.
+ */
+#ifndef AST_EXPRESSION_MEMO_H
+#define AST_EXPRESSION_MEMO_H
+
+#include "ast/build_result.h"
+#include "ast/expected_result.h"
+#include "ast/weight.h"
+#include "nocopy.h"
+
+#include <memory>
+#include <unordered_map>
+
+namespace NonTerminals {
+    struct Expression;
+} // namespace NonTerminals
+
+namespace AST {
+
+namespace ExpressionImpl {
+    class Base;
+} // namespace ExpressionImpl
+
+// Overload resolution builds the same parser expression once per candidate. This remembers what each such build
+// produced, so that sub-expressions are only typed once per expected type.
+//
+// Built expressions may refer to the lookup context they were built in, so each context keeps its own memo.
+class ExpressionMemo : private NoCopy {
+public:
+    struct Entry {
+        // Null if the build failed
+        std::shared_ptr<const ExpressionImpl::Base> expression;
+        // On success, the weight the build added. On failure, the weight budget the build failed with.
+        Weight weight;
+        BuildResult failure;
+    };
+
+private:
+    struct Key {
+        const NonTerminals::Expression *parserExpression;
+        StaticTypeImpl::CPtr expectedType;
+        bool mandatory;
+
+        bool operator==( const Key &rhs ) const {
+            return parserExpression==rhs.parserExpression && mandatory==rhs.mandatory &&
+                    expectedType==rhs.expectedType;
+        }
+    };
+
+    struct KeyHash {
+        size_t operator()( const Key &key ) const;
+    };
+
+    std::unordered_map< Key, Entry, KeyHash > _entries;
+    size_t _hits = 0, _builds = 0;
+
+public:
+    // Returns the result of an earlier build, or nullptr. A failure is only returned if it is still valid with the
+    // given weight budget. A success is returned whatever its weight, and is too expensive if it exceeds the budget.
+    const Entry *lookup(
+            const NonTerminals::Expression &parserExpression, const ExpectedResult &expectedResult, Weight budget );
+
+    void addSuccess(
+            const NonTerminals::Expression &parserExpression, const ExpectedResult &expectedResult,
+            std::shared_ptr<const ExpressionImpl::Base> expression, Weight weight );
+    void addFailure(
+            const NonTerminals::Expression &parserExpression, const ExpectedResult &expectedResult,
+            const BuildResult &failure, Weight budget );
+
+    size_t numHits() const {
+        return _hits;
+    }
+
+    size_t numBuilds() const {
+        return _builds;
+    }
+
+private:
+    static Key makeKey( const NonTerminals::Expression &parserExpression, const ExpectedResult &expectedResult ) {
+        return Key{
+                .parserExpression = &parserExpression,
+                .expectedType = expectedResult.getType(),
+                .mandatory = expectedResult.isMandatory() };
+    }
+};
+
+} // namespace AST
+
+#endif // AST_EXPRESSION_MEMO_H
@@ -9,18 +9,20 @@
 #include "function.h"
 
 #include "ast/ast.h"
-#include "ast/expression.h"
+#include "ast/interpreter.h"
 #include "ast/mangle.h"
-#include "ast/statement_list.h"
+#include "ast/statistics.h"
 
 using namespace PracticalSemanticAnalyzer;
 
 namespace AST {
 
-Function::Function( const NonTerminals::FuncDef &parserFunction, const LookupContext &parentCtx ) :
+Function::Function( const NonTerminals::FuncDef &parserFunction, const LookupContext &parentCtx, size_t index ) :
     parserFunction( parserFunction ),
     name( parserFunction.decl.name.identifier->text ),
-    lookupCtx( &parentCtx )
+    index( index ),
+    session( index, CompilationSession::current().getMemoryLimit() ),
+    lookupCtx( std::in_place, &parentCtx )
 {
     const LookupContext::Identifier *identifierDef = parentCtx.lookupIdentifier( name );
     ASSERT( identifierDef );
@@ -40,66 +42,176 @@ Function::Function( const NonTerminals::FuncDef &parserFunction, const LookupCon
     size_t numArguments = (*function)->getNumArguments();
     arguments.reserve( numArguments );
     for( unsigned i=0; i<numArguments; ++i ) {
-        ExpressionId varExpressionId = Expression::allocateId();
-        StaticTypeImpl::CPtr argumentType = static_cast<const StaticTypeImpl *>( (*function)->getArgumentType(i).get() );
-        lookupCtx.addLocalVar(
-                parserFunction.decl.arguments.arguments[i].name.identifier,
-                argumentType,
-                varExpressionId );
         arguments.emplace_back(
                 (*function)->getArgumentType( i ),
                 parserFunction.decl.arguments.arguments[i].name.identifier->text,
-                varExpressionId
+                Expression::allocateId()
         );
     }
+
+    defineArguments();
 }
 
-void Function::codeGen( std::shared_ptr<FunctionGen> functionGen ) {
-    functionGen->functionEnter(
-            String(mangledName),
-            getReturnType(),
-            arguments,
-            "",
-            parserFunction.decl.name.identifier->location );
+void Function::buildAST() {
+    CompilationSession::Scope scope( session );
 
     struct Visitor {
         Function *_this;
-        FunctionGen *functionGen;
 
         void operator()( const std::monostate &mono ) {
             ABORT()<<"Unreachable code reached";
         }
 
         void operator()( const NonTerminals::CompoundExpression &parserExpression ) {
-            _this->codeGen( parserExpression.statementList, functionGen );
+            _this->statements.emplace( parserExpression.statementList );
+            _this->statements->buildAST( *_this->lookupCtx );
 
-            Expression expression( parserExpression.expression );
+            _this->returnValue.emplace( parserExpression.expression );
 
             Weight weight;
-            expression.buildAST( _this->lookupCtx, _this->getReturnType(), weight, Expression::NoWeightLimit );
-
-            functionGen->returnValue( expression.codeGen( functionGen ) );
+            _this->returnValue->buildAST(
+                    *_this->lookupCtx, _this->getReturnType(), weight, Expression::NoWeightLimit );
         }
 
         void operator()( const NonTerminals::CompoundStatement &parserStatement ) {
-            _this->codeGen( parserStatement.statements, functionGen );
-
-            functionGen->returnValue();
+            _this->statements.emplace( parserStatement.statements );
+            _this->statements->buildAST( *_this->lookupCtx );
         }
     };
 
-    std::visit( Visitor{ ._this = this, .functionGen = functionGen.get() }, parserFunction.body );
+    try {
+        if( parserFunction.isLazy() ) {
+            Statistics &statistics = AST::getStatistics();
+            PhaseTimer timer( statistics.parse );
+            BacktrackCounter backtracks( statistics.parserBacktracks );
+
+            size_t treeBytes = NonTerminals::parseTreeBytes();
+            size_t numTokens = parserFunction.parseBody();
+            statistics.tokens += numTokens;
+
+            size_t bodyBytes = numTokens*sizeof(Tokenizer::Token) + NonTerminals::parseTreeBytes() - treeBytes;
+            session.chargeMemory( bodyBytes );
+            lazyBodyBytes += bodyBytes;
+        }
+
+        PhaseTimer timer( AST::getStatistics().buildAST );
+        std::visit( Visitor{ ._this = this }, parserFunction.body );
+    } catch(...) {
+        setState( State::Failed );
+        throw;
+    }
+
+    setState( State::Built );
+}
+
+void Function::codeGen( std::shared_ptr<FunctionGen> functionGen ) {
+    ASSERT( state==State::Built )<<"Code generation for function "<<name<<" before its AST was built";
+    CompilationSession::Scope scope( session );
+    PhaseTimer timer( AST::getStatistics().codeGen );
+
+    functionGen->functionEnter(
+            String(mangledName),
+            getReturnType(),
+            arguments,
+            "",
+            parserFunction.decl.name.identifier->location );
+
+    statements->codeGen( *lookupCtx, functionGen.get() );
+
+    if( returnValue )
+        functionGen->returnValue( returnValue->codeGen( functionGen.get() ) );
+    else
+        functionGen->returnValue();
 
     functionGen->functionLeave();
 }
 
-void Function::codeGen(
-        const NonTerminals::StatementList &statementList, PracticalSemanticAnalyzer::FunctionGen *functionGen )
-{
-    StatementList sl( statementList );
+void Function::release() {
+    ASSERT( state==State::Built )<<"Function "<<name<<" released before its AST was built";
+
+    // The objects allocated from the arena go first, including the ones the expression memo holds
+    statements.reset();
+    returnValue.reset();
+    lookupCtx.emplace( lookupCtx->getParent() );
+    defineArguments();
+    session.getArena().reset();
+
+    if( parserFunction.isLazy() ) {
+        parserFunction.releaseBody();
+        session.refundMemory( lazyBodyBytes );
+        lazyBodyBytes = 0;
+    }
+
+    for( Function *rebuilt : session.takeRebuiltFunctions() )
+        rebuilt->release();
+
+    setState( State::Released );
+}
+
+ValueRange Function::evaluate( Interpreter &interpreter, Slice<const ValueRange> argumentValues ) {
+    // A sequential analysis would have only built the functions before the current one, which also rules out
+    // recursion. Sticking to these keeps the result the same no matter how the functions were spread over threads.
+    if( index >= CompilationSession::current().getFunctionIndex() || !waitForAST() )
+        return ValueRange();
+
+    ASSERT( argumentValues.size()==arguments.size() );
+    for( size_t i=0; i<arguments.size(); ++i ) {
+        if( !interpreter.defineVariable( arguments[i].lvalueId, argumentValues[i] ) )
+            return ValueRange();
+    }
+
+    if( !statements->evaluate( *lookupCtx, interpreter ) )
+        return ValueRange();
+
+    if( returnValue )
+        return returnValue->evaluate( interpreter );
+
+    return VoidValueRange();
+}
+
+void Function::setState( State newState ) {
+    {
+        std::lock_guard<std::mutex> lock( stateLock );
+        state = newState;
+    }
+
+    stateChanged.notify_all();
+}
+
+void Function::defineArguments() {
+    for( size_t i=0; i<arguments.size(); ++i ) {
+        lookupCtx->addLocalVar(
+                parserFunction.decl.arguments.arguments[i].name.identifier,
+                static_cast<const StaticTypeImpl *>( arguments[i].type.get() ),
+                arguments[i].lvalueId );
+    }
+}
+
+bool Function::waitForAST() {
+    {
+        std::unique_lock<std::mutex> lock( stateLock );
+        stateChanged.wait( lock, [this]() { return state!=State::Pending; } );
+
+        if( state!=State::Released )
+            return state==State::Built;
+    }
+
+    // Released when streaming, which analyzes one function at a time. The function asking keeps the rebuilt body until
+    // it is released itself.
+    CompilationSession &caller = CompilationSession::current();
+    setState( State::Pending );
+
+    // Only the time it takes is counted. Counting what is built again would make the counts depend on the mode.
+    Statistics counts = session.getStatistics();
+    buildAST();
+    Statistics &statistics = session.getStatistics();
+    counts.parse = statistics.parse;
+    counts.buildAST = statistics.buildAST;
+    statistics = counts;
+
+    caller.addRebuiltFunction( this );
 
-    sl.buildAST( lookupCtx );
-    sl.codeGen( lookupCtx, functionGen );
+    return true;
 }
 
 StaticTypeImpl::CPtr Function::getReturnType() const {
@@ -9,25 +9,58 @@
 #ifndef AST_FUNCTION_H
 #define AST_FUNCTION_H
 
+#include "ast/compilation_session.h"
+#include "ast/expression.h"
 #include "ast/lookup_context.h"
+#include "ast/statement_list.h"
 #include "parser.h"
 
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+
 namespace AST {
 
+class Interpreter;
+
 class Function : private NoCopy {
     const NonTerminals::FuncDef &parserFunction;
     String name;
     std::string mangledName;
-    LookupContext lookupCtx;
+    // Position in the module's source. Functions may only evaluate calls to functions before them.
+    size_t index;
+    // Holds the arena the function's analysis allocates from, so must be destroyed after everything below
+    CompilationSession session;
+    // Replaced when releasing the body, as analyzing the body defines its variables here
+    std::optional<LookupContext> lookupCtx;
     StaticTypeImpl::CPtr functionType;
     // XXX Should ArgumentDeclaration contain the type, being as it is that functionType contains it too?
     std::vector< PracticalSemanticAnalyzer::ArgumentDeclaration > arguments;
 
+    // The analyzed body. Kept past code generation, so that later functions can evaluate calls to this one. When
+    // streaming, it is released once generated instead, and rebuilt if a later function evaluates a call to it.
+    std::optional<StatementList> statements;
+    std::optional<Expression> returnValue;
+    // What the lazily parsed body's tokens and parse tree were charged against the memory limit
+    size_t lazyBodyBytes = 0;
+
+    // Later functions might wait, on other threads, for the body to be analyzed
+    enum class State { Pending, Built, Failed, Released };
+    State state = State::Pending;
+    mutable std::mutex stateLock;
+    mutable std::condition_variable stateChanged;
+
 public:
-    explicit Function( const NonTerminals::FuncDef &parserFunction, const LookupContext &parentCtx );
+    explicit Function( const NonTerminals::FuncDef &parserFunction, const LookupContext &parentCtx, size_t index );
 
+    void buildAST();
     void codeGen( std::shared_ptr<PracticalSemanticAnalyzer::FunctionGen> functionGen );
-    void codeGen( const NonTerminals::StatementList &statementList, PracticalSemanticAnalyzer::FunctionGen *functionGen );
+    // Frees the analyzed body, its parse tree if it was parsed lazily, and the functions rebuilt while analyzing it.
+    // Only for sequential analysis.
+    void release();
+
+    // Evaluates a call at compile time. Returns an empty range if it cannot.
+    ValueRange evaluate( Interpreter &interpreter, Slice<const ValueRange> argumentValues );
 
     StaticTypeImpl::CPtr getReturnType() const;
 
@@ -35,6 +68,10 @@ public:
         return name;
     }
 
+    const Tokenizer::Token *getNameToken() const {
+        return parserFunction.decl.name.identifier;
+    }
+
     String getMangledName() const {
         return mangledName;
     }
@@ -42,6 +79,21 @@ public:
     StaticTypeImpl::CPtr getType() const {
         return functionType;
     }
+
+    // Only valid once no thread is building the function any more
+    bool isBuilt() const {
+        return state==State::Built;
+    }
+
+    const CompilationSession &getSession() const {
+        return session;
+    }
+
+private:
+    void setState( State newState );
+    void defineArguments();
+    // Returns whether the body was built successfully. Rebuilds it if it was released.
+    bool waitForAST();
 };
 
 } // namespace AST
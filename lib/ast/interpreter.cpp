@@ -0,0 +1,78 @@
+/* This file is part of the Practical programming langauge. https://github.com/Practical/practical-sa
+ *
+ * To the extent header files enjoy copyright protection, this file is file is copyright (C) 2021 by its authors
+ * You can see the file's authors in the AUTHORS file in the project's home repository.
+ *
+ * This is available under the Boost license. The license's text is available under the LICENSE file in the project's
+ * home directory.
+ */
+#include "ast/interpreter.h"
+
+#include "ast/ast.h"
+#include "ast/expression.h"
+#include "ast/function.h"
+
+namespace AST {
+
+ValueRange Interpreter::evaluateCall(
+        const LookupContext::Function::Definition *definition, Slice<const Expression> arguments )
+{
+    if( definition->implementation==nullptr )
+        return ValueRange();
+
+    std::vector<ValueRange> argumentValues;
+    argumentValues.reserve( arguments.size() );
+    for( const Expression &argument : arguments ) {
+        const ValueRange &range = argument.getValueRange();
+        if( range.getKind()==ValueRange::Kind::Compound || !range.isLiteral() )
+            return ValueRange();
+
+        argumentValues.emplace_back( range );
+    }
+
+    Interpreter interpreter;
+    ValueRange result = interpreter.call( definition, argumentValues );
+    if( !result || !result.isLiteral() )
+        return ValueRange();
+
+    ++AST::getStatistics().callsEvaluated;
+
+    return result;
+}
+
+ValueRange Interpreter::call(
+        const LookupContext::Function::Definition *definition, Slice<const ValueRange> arguments )
+{
+    if( definition->implementation==nullptr || _frames.size()>=MaxCallDepth )
+        return ValueRange();
+
+    _frames.emplace_back();
+    ValueRange result = definition->implementation->evaluate( *this, arguments );
+    _numVariables -= _frames.back().size();
+    _frames.pop_back();
+
+    return result;
+}
+
+bool Interpreter::defineVariable( ExpressionId lvalueId, const ValueRange &value ) {
+    ASSERT( !_frames.empty() )<<"Variable defined outside of a call";
+
+    auto inserter = _frames.back().insert_or_assign( lvalueId, value );
+    if( inserter.second )
+        ++_numVariables;
+
+    return _numVariables <= MaxVariables;
+}
+
+const ValueRange *Interpreter::lookupVariable( ExpressionId lvalueId ) const {
+    if( _frames.empty() )
+        return nullptr;
+
+    auto iter = _frames.back().find( lvalueId );
+    if( iter==_frames.back().end() )
+        return nullptr;
+
+    return &iter->second;
+}
+
+} // namespace AST
@@ -0,0 +1,59 @@
+/* This file is part of the Practical programming langauge. https://github.com/Practical/practical-sa
+ *
+ * To the extent header files enjoy copyright protection, this file is file is copyright (C) 2021 by its authors
+ * You can see the file's authors in the AUTHORS file in the project's home repository.
+ *
+ * This is available under the Boost license. The license's text is available under the LICENSE file in the project's
+ * home directory.
+ */
+#ifndef AST_INTERPRETER_H
+#define AST_INTERPRETER_H
+
+#include "ast/lookup_context.h"
+#include "ast/value_range.h"
+
+#include <practical/slice.h>
+
+#include <unordered_map>
+#include <vector>
+
+namespace AST {
+
+// Evaluates calls to the module's functions at compile time, by walking their analyzed AST.
+//
+// Every value is a literal value range. Builtin operators and casts are evaluated by their (exact) VRP functions.
+// Evaluation fails, returning an empty range, on anything the interpreter cannot know: non-literal values, functions
+// that were not analyzed yet, or exceeding one of the limits below.
+class Interpreter : private NoCopy {
+public:
+    static constexpr size_t MaxSteps = 1'000'000;
+    static constexpr size_t MaxCallDepth = 256;
+    static constexpr size_t MaxVariables = 64*1024;
+
+private:
+    // Variables of each active call, by their lvalue id
+    std::vector< std::unordered_map< ExpressionId, ValueRange > > _frames;
+    size_t _steps = 0, _numVariables = 0;
+
+public:
+    Interpreter() = default;
+
+    // Evaluates a call whose arguments' value ranges are all literal. Returns an empty range if it cannot.
+    static ValueRange evaluateCall(
+            const LookupContext::Function::Definition *definition, Slice<const Expression> arguments );
+
+    ValueRange call( const LookupContext::Function::Definition *definition, Slice<const ValueRange> arguments );
+
+    // Accounts for one evaluation step. Returns false once the steps limit is exhausted.
+    bool step() {
+        return ++_steps <= MaxSteps;
+    }
+
+    bool defineVariable( ExpressionId lvalueId, const ValueRange &value );
+    // Returns nullptr if the current call has no such variable
+    const ValueRange *lookupVariable( ExpressionId lvalueId ) const;
+};
+
+} // namespace AST
+
+#endif // AST_INTERPRETER_H
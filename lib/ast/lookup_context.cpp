@@ -30,9 +30,28 @@ StaticType::CPtr LookupContext::Function::Definition::returnType() const {
     return functionType->getReturnType();
 }
 
+const LookupContext::Function::ArityOverloads *LookupContext::Function::lookupArity( size_t numArguments ) const {
+    if( numArguments>=overloadsByArity.size() || overloadsByArity[numArguments].all.empty() )
+        return nullptr;
+
+    return &overloadsByArity[numArguments];
+}
+
+void LookupContext::Function::indexOverload( const Definition &definition ) {
+    auto functionType = std::get<const StaticType::Function *>( definition.type->getType() );
+    size_t numArguments = functionType->getNumArguments();
+
+    if( numArguments>=overloadsByArity.size() )
+        overloadsByArity.resize( numArguments+1 );
+
+    ArityOverloads &arityOverloads = overloadsByArity[numArguments];
+    arityOverloads.all.emplace_back( &definition );
+    arityOverloads.byReturnType[ functionType->getReturnType() ].emplace_back( &definition );
+}
+
 StaticTypeImpl::CPtr LookupContext::_genericFunctionType =
     StaticTypeImpl::allocate( FunctionTypeImpl( nullptr, {} ) );
-ValueRangeBase::CPtr LookupContext::_genericFunctionRange =
+ValueRange LookupContext::_genericFunctionRange =
     new PointerValueRange( nullptr, BoolValueRange(false, false) );
 
 StaticTypeImpl::CPtr LookupContext::lookupType( String name, const SourceLocation &location ) const {
@@ -102,7 +121,8 @@ StaticTypeImpl::CPtr LookupContext::lookupType( const NonTerminals::TransientTyp
     return ret;
 }
 
-StaticTypeImpl::CPtr LookupContext::registerScalarType( ScalarTypeImpl &&type, ValueRangeBase::CPtr defaultValueRange ) {
+StaticTypeImpl::CPtr LookupContext::registerScalarType( ScalarTypeImpl &&type, ValueRange defaultValueRange ) {
+    assertNotSealed();
     std::string name = sliceToString(type.getName());
     auto iter = _types.emplace(
             name,
@@ -116,6 +136,7 @@ void LookupContext::addBuiltinFunction(
         const std::string &name, StaticTypeImpl::CPtr returnType, Slice<const StaticTypeImpl::CPtr> argumentTypes,
         Function::Definition::CodeGenProto *codeGen, Function::Definition::VrpProto *calcVrp)
 {
+    assertNotSealed();
     auto iter = _symbols.find( name );
 
     Function *function = nullptr;
@@ -143,6 +164,8 @@ void LookupContext::addBuiltinFunction(
     definition.type = type;
     definition.codeGen = codeGen;
     definition.calcVrp = calcVrp;
+
+    function->indexOverload( definition );
 }
 
 std::ostream &operator<<( std::ostream &out, LookupContext::AbiType abi ) {
@@ -165,6 +188,7 @@ void LookupContext::addFunctionDeclarationPass1( const Tokenizer::Token *token )
 }
 
 void LookupContext::addFunctionDefinitionPass1( const Tokenizer::Token *token ) {
+    assertNotSealed();
     auto iter = _symbols.find( token->text );
 
     Function *function = nullptr;
@@ -182,6 +206,7 @@ void LookupContext::addFunctionDefinitionPass1( const Tokenizer::Token *token )
 }
 
 void LookupContext::addStructPass1( const NonTerminals::StructDef &def ) {
+    assertNotSealed();
     auto inserter = _typesUnderConstruction.emplace(
             sliceToString(def.identifier.identifier->text),
             StaticTypeImpl::allocate( StructTypeImpl{ def.identifier.identifier->text, this } ) );
@@ -226,6 +251,73 @@ void LookupContext::addFunctionDefinitionPass2(
     definition.declarationOnly = false;
 }
 
+void LookupContext::setFunctionImplementation(
+        const Tokenizer::Token *token, StaticTypeImpl::CPtr type, ::AST::Function *implementation )
+{
+    auto iter = _symbols.find( token->text );
+    ASSERT( iter!=_symbols.end() )<<"Implementation set for undeclared function "<<token->text;
+    Function *function = std::get_if<Function>( &iter->second );
+    ASSERT( function!=nullptr );
+
+    auto overload = function->overloads.find( type );
+    ASSERT( overload!=function->overloads.end() );
+    overload->second.implementation = implementation;
+}
+
+void LookupContext::seal() {
+    assertNotSealed();
+    ASSERT( _typesUnderConstruction.empty() )<<"Sealing a lookup context with incomplete types";
+
+    // Everything handed out by lookups is made immortal, so that the threads copying the pointers leave the counts alone
+    for( const auto &type : _types )
+        type.second->freeze();
+
+    for( const auto &symbol : _symbols ) {
+        if( const Variable *variable = std::get_if<Variable>( &symbol.second ) ) {
+            variable->type->freeze();
+        } else if( const Function *function = std::get_if<Function>( &symbol.second ) ) {
+            for( const auto &overload : function->overloads )
+                overload.first->freeze();
+        }
+    }
+
+    for( const auto &source : _typeConversionsFrom ) {
+        for( const auto &cast : source.second ) {
+            cast.second.sourceType->freeze();
+            cast.second.destType->freeze();
+        }
+    }
+
+    // The generic function's type and range are shared by all contexts
+    _genericFunctionType->freeze();
+    _genericFunctionRange.makeImmortal();
+
+    _sealed = true;
+}
+
+void LookupContext::share() const {
+    ASSERT( _typesUnderConstruction.empty() )<<"Sharing a lookup context with incomplete types";
+
+    for( const auto &type : _types )
+        type.second->share();
+
+    for( const auto &symbol : _symbols ) {
+        if( const Variable *variable = std::get_if<Variable>( &symbol.second ) ) {
+            variable->type->share();
+        } else if( const Function *function = std::get_if<Function>( &symbol.second ) ) {
+            for( const auto &overload : function->overloads )
+                overload.first->share();
+        }
+    }
+
+    for( const auto &source : _typeConversionsFrom ) {
+        for( const auto &cast : source.second ) {
+            cast.second.sourceType->share();
+            cast.second.destType->share();
+        }
+    }
+}
+
 void LookupContext::declareFunctions( PracticalSemanticAnalyzer::ModuleGen *moduleGen ) const
 {
     for( auto &symbol : _symbols ) {
@@ -285,16 +377,46 @@ const LookupContext::Identifier *LookupContext::lookupIdentifier( String name )
     return &iter->second;
 }
 
+LookupContext::RangeNarrowing::~RangeNarrowing() {
+    for( auto previous = _previousRanges.rbegin(); previous!=_previousRanges.rend(); ++previous ) {
+        if( previous->second )
+            _context._narrowedRanges[ previous->first ] = std::move( previous->second );
+        else
+            _context._narrowedRanges.erase( previous->first );
+    }
+}
+
+void LookupContext::RangeNarrowing::narrow( const Variable &variable, const ValueRange &range ) {
+    ValueRange narrowed = _context.lookupVariableRange( variable ).intersect( range );
+    if( !narrowed )
+        return;
+
+    ValueRange &current = _context._narrowedRanges[ variable.lvalueId ];
+    _previousRanges.emplace_back( variable.lvalueId, std::move( current ) );
+    current = std::move( narrowed );
+}
+
+const ValueRange &LookupContext::lookupVariableRange( const Variable &variable ) const {
+    for( const LookupContext *context = this; context!=nullptr; context = context->getParent() ) {
+        auto iter = context->_narrowedRanges.find( variable.lvalueId );
+        if( iter!=context->_narrowedRanges.end() )
+            return iter->second;
+    }
+
+    return variable.type->defaultRange();
+}
+
 StaticTypeImpl::CPtr LookupContext::genericFunctionType() {
     return _genericFunctionType;
 }
 
-ValueRangeBase::CPtr LookupContext::genericFunctionRange() {
+const ValueRange &LookupContext::genericFunctionRange() {
     return _genericFunctionRange;
 }
 
 void LookupContext::addLocalVar( const Tokenizer::Token *token, StaticTypeImpl::CPtr type, ExpressionId lvalue )
 {
+    assertNotSealed();
     auto iter = _symbols.emplace( token->text, Variable(token, type, lvalue) );
 
     if( !iter.second ) {
@@ -305,6 +427,7 @@ void LookupContext::addLocalVar( const Tokenizer::Token *token, StaticTypeImpl::
 String LookupContext::addStructMember(
         const Tokenizer::Token *token, StaticTypeImpl::CPtr type, size_t offset )
 {
+    assertNotSealed();
     auto iter = _symbols.emplace( token->text, StructMember(token, type, offset) );
 
     if( !iter.second ) {
@@ -320,34 +443,39 @@ void LookupContext::addCast(
         unsigned weight, CodeGenCast codeGenCast, ValueRangeCast calcVrp,
         CastDescriptor::ImplicitCastAllowed whenPossible )
 {
+    assertNotSealed();
     ASSERT( getParent()==nullptr )<<"Non-builtin lookups not yet implemented";
 
-    {
-        auto &sourceTypeMap = _typeConversionsFrom[sourceType];
+    auto &sourceTypeMap = _typeConversionsFrom[sourceType];
 
-        auto insertIterator = sourceTypeMap.emplace(
-                std::piecewise_construct,
-                std::tuple(destType),
-                std::tuple(sourceType, destType, codeGenCast, calcVrp, weight, whenPossible) );
-        ASSERT( insertIterator.second );
-    }
+    auto insertIterator = sourceTypeMap.emplace(
+            std::piecewise_construct,
+            std::tuple(destType),
+            std::tuple(sourceType, destType, codeGenCast, calcVrp, weight, whenPossible) );
+    ASSERT( insertIterator.second );
+
+    // Unordered map nodes are stable, so we can keep pointers to the descriptor
+    const CastDescriptor *descriptor = &insertIterator.first->second;
+    insertSorted( _castsFrom[sourceType], descriptor );
+    insertSorted( _castsTo[destType], descriptor );
+}
 
-    {
-        auto &destTypeSet = _typeConversionsTo[destType];
+void LookupContext::CastsList::findNonEmpty() {
+    for( ; _context!=nullptr; _context = _context->_parent ) {
+        const CastAdjacencyMap &adjacencyMap = _context->*_adjacency;
+        if( adjacencyMap.empty() )
+            continue;
 
-        auto insertIterator = destTypeSet.emplace( sourceType );
-        ASSERT( insertIterator.second );
-    }
-}
+        auto iter = adjacencyMap.find( _type );
+        if( iter==adjacencyMap.end() )
+            continue;
 
-void LookupContext::CastsList::sort() {
-    struct Comparer {
-        bool operator()( const CastDescriptor *lhs, const CastDescriptor *rhs ) {
-            return lhs->weight < rhs->weight;
-        }
-    };
+        ASSERT( !iter->second.empty() );
+        _current = iter->second.begin();
+        _end = iter->second.end();
 
-    std::sort( casts.begin(), casts.end(), Comparer() );
+        return;
+    }
 }
 
 const LookupContext::CastDescriptor *LookupContext::lookupCast(
@@ -372,43 +500,13 @@ const LookupContext::CastDescriptor *LookupContext::lookupCast(
 LookupContext::CastsList LookupContext::allCastsTo(
         PracticalSemanticAnalyzer::StaticType::CPtr destType ) const
 {
-    CastsList ret;
-
-    for( const LookupContext *_this = this; _this!=nullptr; _this = _this->_parent ) {
-        auto destTypeIter = _this->_typeConversionsTo.find(destType);
-
-        if( destTypeIter != _this->_typeConversionsTo.end() ) {
-            for( auto sourceType : destTypeIter->second ) {
-                ret.casts.emplace_back(
-                        & _this->_typeConversionsFrom.at( sourceType ).at( destType )
-                    );
-            }
-        }
-    }
-
-    ret.sort();
-
-    return ret;
+    return CastsList( this, &LookupContext::_castsTo, std::move(destType) );
 }
 
 LookupContext::CastsList LookupContext::allCastsFrom(
         PracticalSemanticAnalyzer::StaticType::CPtr sourceType) const
 {
-    CastsList ret;
-
-    for( const LookupContext *_this = this; _this!=nullptr; _this = _this->_parent ) {
-        auto sourceTypeIter = _this->_typeConversionsFrom.find(sourceType);
-
-        if( sourceTypeIter != _this->_typeConversionsFrom.end() ) {
-            for( auto &destTypeIter : sourceTypeIter->second ) {
-                ret.casts.emplace_back( & destTypeIter.second );
-            }
-        }
-    }
-
-    ret.sort();
-
-    return ret;
+    return CastsList( this, &LookupContext::_castsFrom, std::move(sourceType) );
 }
 
 // Private methods
@@ -429,9 +527,18 @@ ExpressionId LookupContext::globalFunctionCall(
     return resultId;
 }
 
+void LookupContext::insertSorted( CastAdjacency &adjacency, const CastDescriptor *descriptor ) {
+    // Insert after all casts of equal weight, so that registration order is kept between them
+    auto position = std::upper_bound(
+            adjacency.begin(), adjacency.end(), descriptor->weight,
+            []( unsigned weight, const CastDescriptor *cast ) { return weight < cast->weight; } );
+    adjacency.insert( position, descriptor );
+}
+
 LookupContext::Function::Definition &LookupContext::addFunctionPass2(
         const Tokenizer::Token *token, StaticTypeImpl::CPtr type, AbiType abi, bool isDefinition )
 {
+    assertNotSealed();
     auto iter = _symbols.find( token->text );
     ASSERT( iter!=_symbols.end() )<<"addFunctionPass2 called for "<<token->text<<" without 1st pass";
     Function *function = std::get_if<Function>( &iter->second );
@@ -458,6 +565,9 @@ LookupContext::Function::Definition &LookupContext::addFunctionPass2(
     definition.type = std::move(type);
     definition.codeGen = globalFunctionCall;
 
+    if( insertIter.second )
+        function->indexOverload( definition );
+
     return definition;
 }
 
@@ -10,6 +10,7 @@
 #define AST_LOOKUP_CONTEXT_H
 
 #include "ast/delayed_definitions.h"
+#include "ast/expression_memo.h"
 #include "ast/static_type.h"
 #include "ast/struct_member.h"
 #include "parser/struct.h"
@@ -21,10 +22,12 @@
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 namespace AST {
 
 class Expression;
+class Function;
 
 class LookupContext : private NoCopy {
 public:
@@ -45,7 +48,7 @@ public:
                     ExpressionId(
                             Slice<const Expression>, const Function::Definition *, PracticalSemanticAnalyzer::FunctionGen *);
             using VrpProto =
-                    ValueRangeBase::CPtr(StaticTypeImpl::CPtr functType, Slice<ValueRangeBase::CPtr> inputRanges);
+                    ValueRange(StaticTypeImpl::CPtr functType, Slice<const ValueRange> inputRanges);
 
 
             const Tokenizer::Token *token = nullptr;
@@ -53,6 +56,8 @@ public:
             std::string mangledName;
             CodeGenProto *codeGen = nullptr;
             VrpProto *calcVrp = nullptr;
+            // The analyzed function, once the module's code generation reached it. Used for compile time evaluation.
+            ::AST::Function *implementation = nullptr;
             bool declarationOnly = true;
 
             Definition( const Tokenizer::Token *token, const std::string &name ) :
@@ -60,11 +65,34 @@ public:
             {}
 
             StaticType::CPtr returnType() const;
+
+            // Builtin functions are not declared in the source, and have no side effects
+            bool isBuiltin() const {
+                return token==nullptr;
+            }
         };
 
         using OverloadsContainer = std::unordered_map< StaticTypeImpl::CPtr, Definition >;
+        using OverloadsList = std::vector< const Definition * >;
+
+        // All overloads accepting the same number of arguments
+        struct ArityOverloads {
+            OverloadsList all;
+            std::unordered_map< PracticalSemanticAnalyzer::StaticType::CPtr, OverloadsList > byReturnType;
+        };
+
         std::unordered_map<const Tokenizer::Token *, OverloadsContainer::const_iterator> firstPassOverloads;
         OverloadsContainer overloads;
+        // Indexed by number of arguments
+        std::vector< ArityOverloads > overloadsByArity;
+
+        // Returns nullptr if no overload accepts numArguments arguments
+        const ArityOverloads *lookupArity( size_t numArguments ) const;
+
+    private:
+        friend LookupContext;
+
+        void indexOverload( const Definition &definition );
     };
 
     using Identifier = std::variant<Variable, Function, StructMember>;
@@ -73,10 +101,10 @@ public:
             PracticalSemanticAnalyzer::StaticType::CPtr sourceType, ExpressionId sourceExpression,
             PracticalSemanticAnalyzer::StaticType::CPtr destType,
             PracticalSemanticAnalyzer::FunctionGen *functionGen);
-    using ValueRangeCast = ValueRangeBase::CPtr (*)(
+    using ValueRangeCast = ValueRange (*)(
             const StaticTypeImpl *sourceType,
             const StaticTypeImpl *destType,
-            ValueRangeBase::CPtr inputRange,
+            const ValueRange &inputRange,
             bool isImplicit
         );
 
@@ -109,9 +137,9 @@ public:
     };
 
 private:
-    using CalcValueRangeCast = ValueRangeBase::CPtr (*)(
+    using CalcValueRangeCast = ValueRange (*)(
             PracticalSemanticAnalyzer::StaticType::CPtr sourceType,
-            ValueRangeBase::CPtr sourceRange,
+            const ValueRange &sourceRange,
             PracticalSemanticAnalyzer::StaticType::CPtr destType);
 
 public:
@@ -130,7 +158,7 @@ public:
     StaticTypeImpl::CPtr lookupType( const NonTerminals::Type &type ) const;
     StaticTypeImpl::CPtr lookupType( const NonTerminals::TransientType &type ) const;
 
-    StaticTypeImpl::CPtr registerScalarType( ScalarTypeImpl &&type, ValueRangeBase::CPtr defaultValueRange );
+    StaticTypeImpl::CPtr registerScalarType( ScalarTypeImpl &&type, ValueRange defaultValueRange );
 
     void addBuiltinFunction(
             const std::string &name, StaticTypeImpl::CPtr returnType, Slice<const StaticTypeImpl::CPtr> argumentTypes,
@@ -151,6 +179,16 @@ public:
             const Tokenizer::Token *token, StaticTypeImpl::CPtr type, AbiType abi = AbiType::Practical );
     void addStructPass2( const NonTerminals::StructDef &token, DelayedDefinitions &delayedDefs );
 
+    void setFunctionImplementation(
+            const Tokenizer::Token *token, StaticTypeImpl::CPtr type, ::AST::Function *implementation );
+
+    // Freezes a fully built context, so that any number of threads can look things up in it. A sealed context cannot
+    // be changed.
+    void seal();
+    // Readies a fully built context for lookups from several threads at once. Unlike seal, the context stays mortal,
+    // and can be changed again once the threads are done with it.
+    void share() const;
+
     void declareFunctions( PracticalSemanticAnalyzer::ModuleGen *moduleGen ) const;
     void declareStructs( PracticalSemanticAnalyzer::ModuleGen *moduleGen ) const;
     void defineStructs( PracticalSemanticAnalyzer::ModuleGen *moduleGen ) const;
@@ -163,9 +201,32 @@ public:
 
     const Identifier *lookupIdentifier( String name ) const;
 
+    // Restricts local variables' value ranges for as long as it lives. Used inside branches guarded by a condition.
+    //
+    // This is only sound because variables cannot change once defined. Whoever implements OP_ASSIGN (or any other
+    // way to modify a variable) must drop a variable's narrowing when it is assigned to, including inside loops.
+    class RangeNarrowing : private NoCopy {
+        LookupContext &_context;
+        std::vector< std::pair< ExpressionId, ValueRange > > _previousRanges;
+
+    public:
+        explicit RangeNarrowing( LookupContext &context ) : _context( context ) {}
+        ~RangeNarrowing();
+
+        // Narrows the variable to the values also in range. Does nothing if no value is.
+        void narrow( const Variable &variable, const ValueRange &range );
+    };
+
+    // The range a local variable is currently known to hold
+    const ValueRange &lookupVariableRange( const Variable &variable ) const;
+
+    ExpressionMemo &getExpressionMemo() {
+        return _expressionMemo;
+    }
+
     // Generic type and range to use for unspecified function
     static StaticTypeImpl::CPtr genericFunctionType();
-    static ValueRangeBase::CPtr genericFunctionRange();
+    static const ValueRange &genericFunctionRange();
 
     void addCast(
             StaticTypeImpl::CPtr sourceType,
@@ -173,40 +234,64 @@ public:
             unsigned weight, CodeGenCast codeGenCast, ValueRangeCast calcVrp,
             CastDescriptor::ImplicitCastAllowed whenPossible );
 
+private:
+    // Casts to or from a single type, kept sorted by weight as they are added
+    using CastAdjacency = std::vector<const CastDescriptor *>;
+    using CastAdjacencyMap = std::unordered_map< PracticalSemanticAnalyzer::StaticType::CPtr, CastAdjacency >;
+
+public:
+    // Iterates the casts from (or to) a type, walking up the parent contexts. Does not allocate.
+    //
+    // Casts are sorted by weight within each context. Since casts are currently only registered on the builtin
+    // context, this is also the overall order.
     class CastsList : private NoCopy {
         friend LookupContext;
 
-        std::vector<const CastDescriptor *> casts;
-        unsigned index = 0;
+        const LookupContext *_context = nullptr;
+        CastAdjacencyMap LookupContext::*_adjacency = nullptr;
+        PracticalSemanticAnalyzer::StaticType::CPtr _type;
+        CastAdjacency::const_iterator _current, _end;
+
+        CastsList(
+                const LookupContext *context, CastAdjacencyMap LookupContext::*adjacency,
+                PracticalSemanticAnalyzer::StaticType::CPtr type ) :
+            _context(context), _adjacency(adjacency), _type(std::move(type))
+        {
+            findNonEmpty();
+        }
 
     public:
 
         explicit operator bool() const {
-            return index<casts.size();
+            return _context!=nullptr;
         }
 
         void operator++() {
-            ++index;
+            ASSERT( _context!=nullptr )<<"Advancing past the end of a casts list";
+
+            ++_current;
+            if( _current==_end ) {
+                _context = _context->_parent;
+                findNonEmpty();
+            }
         }
 
         const CastDescriptor &operator*() const {
-            return *casts.at(index);
+            return *get();
         }
 
         const CastDescriptor *operator->() const {
-            return casts.at(index);
+            return get();
         }
 
         const CastDescriptor *get() const {
-            return casts.at(index);
-        }
-
-        size_t size() const {
-            return casts.size();
+            ASSERT( _context!=nullptr )<<"Dereferencing past the end of a casts list";
+            return *_current;
         }
 
     private:
-        void sort();
+        // Starting at _context, find the first context that has casts for our type
+        void findNonEmpty();
     };
 
     const CastDescriptor *lookupCast(
@@ -225,25 +310,32 @@ private:
     Function::Definition &addFunctionPass2(
             const Tokenizer::Token *token, StaticTypeImpl::CPtr type, AbiType abi, bool isDefinition );
 
+    static void insertSorted( CastAdjacency &adjacency, const CastDescriptor *descriptor );
+
+    void assertNotSealed() const {
+        ASSERT( !_sealed )<<"Trying to change a sealed lookup context";
+    }
+
     // Members
     static StaticTypeImpl::CPtr _genericFunctionType;
-    static ValueRangeBase::CPtr _genericFunctionRange;
+    static ValueRange _genericFunctionRange;
 
     std::unordered_map< std::string, StaticTypeImpl::Ptr > _typesUnderConstruction;
     std::unordered_map< std::string, StaticTypeImpl::CPtr > _types;
     const LookupContext *_parent = nullptr;
+    bool _sealed = false;
 
     std::unordered_map< String, Identifier > _symbols;
+    std::unordered_map< ExpressionId, ValueRange > _narrowedRanges;
 
     std::unordered_map<
             PracticalSemanticAnalyzer::StaticType::CPtr,
             std::unordered_map< PracticalSemanticAnalyzer::StaticType::CPtr, CastDescriptor >
     > _typeConversionsFrom;
 
-    std::unordered_map<
-            PracticalSemanticAnalyzer::StaticType::CPtr,
-            std::unordered_set< PracticalSemanticAnalyzer::StaticType::CPtr >
-    > _typeConversionsTo;
+    CastAdjacencyMap _castsFrom, _castsTo;
+
+    ExpressionMemo _expressionMemo;
 };
 
 } // End namespace AST
@@ -0,0 +1,48 @@
+/* This file is part of the Practical programming langauge. https://github.com/Practical/practical-sa
+ *
+ * To the extent header files enjoy copyright protection, this file is file is copyright (C) 2021 by its authors
+ * You can see the file's authors in the AUTHORS file in the project's home repository.
+ *
+ * This is available under the Boost license. The license's text is available under the LICENSE file in the project's
+ * home directory.
+ */
+#include "ast/memory_limit.h"
+
+#include <practical/errors.h>
+
+namespace AST {
+
+MemoryLimit::MemoryLimit( std::pmr::memory_resource *upstream, size_t limit ) :
+    _upstream( upstream!=nullptr ? upstream : std::pmr::new_delete_resource() ),
+    _limit( limit )
+{}
+
+void MemoryLimit::charge( size_t bytes ) {
+    size_t used = _used.fetch_add( bytes, std::memory_order_relaxed ) + bytes;
+    if( _limit!=0 && used>_limit ) {
+        refund( bytes );
+        throw PracticalSemanticAnalyzer::MemoryLimitExceeded( _limit );
+    }
+}
+
+void *MemoryLimit::do_allocate( size_t bytes, size_t alignment ) {
+    charge( bytes );
+
+    try {
+        return _upstream->allocate( bytes, alignment );
+    } catch(...) {
+        refund( bytes );
+        throw;
+    }
+}
+
+void MemoryLimit::do_deallocate( void *pointer, size_t bytes, size_t alignment ) {
+    _upstream->deallocate( pointer, bytes, alignment );
+    refund( bytes );
+}
+
+bool MemoryLimit::do_is_equal( const std::pmr::memory_resource &other ) const noexcept {
+    return this==&other;
+}
+
+} // namespace AST
@@ -0,0 +1,52 @@
+/* This file is part of the Practical programming langauge. https://github.com/Practical/practical-sa
+ *
+ * To the extent header files enjoy copyright protection, this file is file is copyright (C) 2021 by its authors
+ * You can see the file's authors in the AUTHORS file in the project's home repository.
+ *
+ * This is available under the Boost license. The license's text is available under the LICENSE file in the project's
+ * home directory.
+ */
+#ifndef AST_MEMORY_LIMIT_H
+#define AST_MEMORY_LIMIT_H
+
+#include "nocopy.h"
+
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+
+namespace AST {
+
+// Passes allocations on to another memory resource, keeping count of the bytes in use. Allocating past the limit
+// throws MemoryLimitExceeded. Can be used from several threads at once if the upstream resource can.
+//
+// Memory allocated elsewhere, such as the tokens and the parse tree, is counted against the limit by charging for it.
+class MemoryLimit : public std::pmr::memory_resource, private NoCopy {
+    std::pmr::memory_resource *_upstream;
+    size_t _limit;
+    std::atomic<size_t> _used = 0;
+
+public:
+    // A limit of 0 means there is no limit. A null upstream means the global operator new.
+    explicit MemoryLimit( std::pmr::memory_resource *upstream, size_t limit = 0 );
+
+    size_t getUsed() const {
+        return _used.load( std::memory_order_relaxed );
+    }
+
+    // Counts bytes allocated elsewhere as in use. Throws MemoryLimitExceeded, charging nothing, if that passes the limit.
+    void charge( size_t bytes );
+    // Stops counting bytes charged for
+    void refund( size_t bytes ) {
+        _used.fetch_sub( bytes, std::memory_order_relaxed );
+    }
+
+private:
+    void *do_allocate( size_t bytes, size_t alignment ) override;
+    void do_deallocate( void *pointer, size_t bytes, size_t alignment ) override;
+    bool do_is_equal( const std::pmr::memory_resource &other ) const noexcept override;
+};
+
+} // namespace AST
+
+#endif // AST_MEMORY_LIMIT_H
@@ -8,35 +8,50 @@
  */
 #include "module.h"
 
+#include "ast/compilation_session.h"
+#include "ast/dense_ids_gen.h"
 #include "ast/function.h"
+#include "ast/scheduler.h"
+#include "ast/statistics.h"
 
 #include <practical/errors.h>
 
-namespace AST {
+#include <exception>
 
-static ModuleId::Allocator<> moduleIdAllocator;
+namespace AST {
 
-Module::Module( const NonTerminals::Module &parserModule, const LookupContext &parentLookupContext ) :
+Module::Module(
+        const NonTerminals::Module &parserModule, String fileName, const LookupContext &parentLookupContext ) :
     parserModule(parserModule),
+    fileName(fileName),
     lookupContext(&parentLookupContext),
-    moduleId( moduleIdAllocator.allocate() )
+    moduleId( CompilationSession::current().allocateModuleId() )
 {} 
 
-void Module::symbolsPass1() {
-    for( const auto &structDef : parserModule.structureDefinitions ) {
-        lookupContext.addStructPass1( structDef );
+void Module::symbolsPass1( bool moduleParsed ) {
+    PhaseTimer timer( CompilationSession::current().getStatistics().symbolsPass1 );
+
+    for( ; structsRegistered<parserModule.structureDefinitions.size(); ++structsRegistered ) {
+        lookupContext.addStructPass1( parserModule.structureDefinitions[structsRegistered] );
     }
 
-    for( const auto &funcDecl : parserModule.functionDeclarations ) {
-        lookupContext.addFunctionDeclarationPass1( funcDecl.decl.name.identifier );
+    for( ; declarationsRegistered<parserModule.functionDeclarations.size(); ++declarationsRegistered ) {
+        lookupContext.addFunctionDeclarationPass1(
+                parserModule.functionDeclarations[declarationsRegistered].decl.name.identifier );
     }
 
-    for( const auto &funcDef : parserModule.functionDefinitions ) {
-        lookupContext.addFunctionDefinitionPass1( funcDef.decl.name.identifier );
+    if( !moduleParsed )
+        return;
+
+    for( ; definitionsRegistered<parserModule.functionDefinitions.size(); ++definitionsRegistered ) {
+        lookupContext.addFunctionDefinitionPass1(
+                parserModule.functionDefinitions[definitionsRegistered].decl.name.identifier );
     }
 }
 
 void Module::symbolsPass2() {
+    PhaseTimer timer( CompilationSession::current().getStatistics().symbolsPass2 );
+
     {
         // Scope the delayed definitions data structures
         AST::DelayedDefinitions delayedDefs;
@@ -82,25 +97,77 @@ void Module::symbolsPass2() {
     }
 }
 
-void Module::codeGen( PracticalSemanticAnalyzer::ModuleGen *moduleGen ) {
-    moduleGen->moduleEnter( moduleId, "Module", "file.pr", 1, 1 );
+void Module::codeGen(
+        const PracticalSemanticAnalyzer::CompilerArguments &arguments, PracticalSemanticAnalyzer::ModuleGen *moduleGen )
+{
+    moduleGen->moduleEnter( moduleId, "Module", fileName, 1, 1 );
 
     lookupContext.declareStructs( moduleGen );
     lookupContext.declareFunctions( moduleGen );
 
     lookupContext.defineStructs( moduleGen );
 
-    std::vector<Function> functions;
+    std::vector< std::unique_ptr<Function> > functions;
     functions.reserve( parserModule.functionDefinitions.size() );
 
-    for( const auto &funcDef : parserModule.functionDefinitions ) {
-        functions.emplace_back( funcDef, lookupContext );
+    for( size_t i=0; i<parserModule.functionDefinitions.size(); ++i ) {
+        const NonTerminals::FuncDef &funcDef = parserModule.functionDefinitions[i];
+        Function &function = *functions.emplace_back( safenew<Function>( funcDef, lookupContext, i ) );
+        lookupContext.setFunctionImplementation( funcDef.decl.name.identifier, function.getType(), &function );
     }
 
-    for( auto &function : functions ) {
-        function.codeGen( moduleGen->handleFunction() );
+    // Function bodies are independent of each other. From here on, they only read the module's context, possibly from
+    // several threads at once.
+    lookupContext.share();
+    Scheduler scheduler( arguments.numThreads );
+    // Functions handed out in order get their ids renumbered densely from this session's
+    CompilationSession &session = CompilationSession::current();
+
+    std::exception_ptr failure;
+    try {
+        if( arguments.streaming ) {
+            // Only the function being analyzed, and the ones it evaluates calls to, hold on to their bodies
+            for( auto &function : functions ) {
+                function->buildAST();
+                function->codeGen( std::make_shared<DenseIdsGen>( moduleGen->handleFunction(), session ) );
+                function->release();
+            }
+        } else if( arguments.deterministic ) {
+            try {
+                scheduler.run( functions.size(), [&]( size_t index ) { functions[index]->buildAST(); } );
+            } catch(...) {
+                failure = std::current_exception();
+            }
+
+            // Replay in source order. As with a sequential analysis, the functions before the first failure are
+            // generated.
+            for( auto &function : functions ) {
+                if( !function->isBuilt() )
+                    break;
+
+                function->codeGen( std::make_shared<DenseIdsGen>( moduleGen->handleFunction(), session ) );
+            }
+        } else {
+            scheduler.run( functions.size(), [&]( size_t index ) {
+                    functions[index]->buildAST();
+                    functions[index]->codeGen( moduleGen->handleFunction() );
+                } );
+        }
+    } catch(...) {
+        failure = std::current_exception();
     }
 
+    // Also when failing, so that the statistics cover the work done up to the failure
+    for( const auto &function : functions ) {
+        CompilationSession::current().mergeStatistics( function->getSession() );
+
+        // The functions are about to go away
+        lookupContext.setFunctionImplementation( function->getNameToken(), function->getType(), nullptr );
+    }
+
+    if( failure )
+        std::rethrow_exception( failure );
+
     moduleGen->moduleLeave( moduleId );
 }
 
@@ -12,21 +12,32 @@
 #include "ast/lookup_context.h"
 #include "parser/module.h"
 
+#include <boost/smart_ptr/intrusive_ref_counter.hpp>
+
 namespace AST {
 
 class Module final : public boost::intrusive_ref_counter<Module, boost::thread_unsafe_counter>, private NoCopy {
     const NonTerminals::Module &parserModule;
+    String fileName;
     LookupContext lookupContext;
     PracticalSemanticAnalyzer::ModuleId moduleId;
 
+    // How many of the parser module's items symbolsPass1 registered so far
+    size_t structsRegistered = 0, declarationsRegistered = 0, definitionsRegistered = 0;
+
 public:
     using Ptr = boost::intrusive_ptr<Module>;
 
-    explicit Module( const NonTerminals::Module &parserModule, const LookupContext &parentLookupContext );
+    explicit Module(
+            const NonTerminals::Module &parserModule, String fileName, const LookupContext &parentLookupContext );
 
-    void symbolsPass1();
+    // Registers the items the parser added since the last call. Can be called while the module is still being parsed,
+    // but function definitions are then held back until the final call. Symbols are thus registered in the same order
+    // as when calling it once the module is fully parsed.
+    void symbolsPass1( bool moduleParsed = true );
     void symbolsPass2();
-    void codeGen( PracticalSemanticAnalyzer::ModuleGen *codeGen );
+    void codeGen(
+            const PracticalSemanticAnalyzer::CompilerArguments &arguments, PracticalSemanticAnalyzer::ModuleGen *codeGen );
 
     StaticTypeImpl::CPtr constructFunctionType( const NonTerminals::FuncDeclBody &decl ) const;
 };
@@ -10,10 +10,57 @@
 
 #include "ast/operators/helper.h"
 
+#include "exact_int.h"
+
 namespace AST::Operators {
 
 using namespace PracticalSemanticAnalyzer;
 
+// Unsigned arithmetic wraps around. The exact results form a contiguous range only if they all wrapped the same number
+// of times.
+static UnsignedIntValueRange wrapUnsignedRange(
+        const std::optional<ExactInt> &minimum, const std::optional<ExactInt> &maximum,
+        const UnsignedIntValueRange &typeRange )
+{
+    if( !minimum || !maximum )
+        return typeRange;
+
+    ExactInt modulus = *ExactInt( typeRange.maximum ).checkedAdd( LongEnoughInt(1) );
+    std::optional<ExactInt> wraps = minimum->checkedFloorDiv( modulus );
+    if( !wraps || wraps!=maximum->checkedFloorDiv( modulus ) )
+        return typeRange;
+
+    ExactInt offset = *wraps->checkedMul( modulus );
+
+    return UnsignedIntValueRange(
+            minimum->checkedSub( offset )->getUnsigned(),
+            maximum->checkedSub( offset )->getUnsigned() );
+}
+
+// Signed overflow is undefined behavior, so results outside the type's range are assumed not to happen. If all of them
+// overflow, that leaves no possible result at all, and nothing is assumed.
+static SignedIntValueRange clampSignedRange(
+        const std::optional<ExactInt> &minimum, const std::optional<ExactInt> &maximum,
+        const SignedIntValueRange &typeRange )
+{
+    if( !minimum || !maximum )
+        return typeRange;
+
+    if( *maximum<ExactInt( typeRange.minimum ) || *minimum>ExactInt( typeRange.maximum ) )
+        return typeRange;
+
+    auto clamp = [&typeRange]( const ExactInt &value ) -> LongEnoughIntSigned {
+        if( value<ExactInt( typeRange.minimum ) )
+            return typeRange.minimum;
+        if( value>ExactInt( typeRange.maximum ) )
+            return typeRange.maximum;
+
+        return value.getSigned();
+    };
+
+    return SignedIntValueRange( clamp( *minimum ), clamp( *maximum ) );
+}
+
 // Plus
 
 ExpressionId bPlusCodegenUnsigned(
@@ -36,40 +83,17 @@ ExpressionId bPlusCodegenUnsigned(
     return resultId;
 }
 
-ValueRangeBase::CPtr bPlusUnsignedVrp(StaticTypeImpl::CPtr funcType, Slice<ValueRangeBase::CPtr> inputRangesBase)
+ValueRange bPlusUnsignedVrp(StaticTypeImpl::CPtr funcType, Slice<const ValueRange> inputRangesBase)
 {
-    auto inputRanges = downcastValueRanges<UnsignedIntValueRange>( inputRangesBase );
+    auto inputRanges = downcastValueRanges<UnsignedIntValueRange, 2>( inputRangesBase );
     ASSERT( inputRangesBase.size()==2 );
 
     const UnsignedIntValueRange *typeRange = getUnsignedOverloadRange( funcType, inputRanges );
-    auto ret = UnsignedIntValueRange::allocate( typeRange );
-
-    bool maxOverflow = false;
-    if( inputRanges[0]->maximum>0 && (typeRange->maximum-inputRanges[0]->maximum) < inputRanges[1]->maximum ) {
-        /* There is no overflow iff: in[0]+in[1] <= range.max
-         * in[1] <= range.max-in[0]
-         * Reversal: range.max-in[0] < in[1]
-         */
-        maxOverflow = true;
-    }
 
-    bool minOverflow = false;
-    if( inputRanges[0]->minimum>0 && (typeRange->maximum-inputRanges[0]->minimum) < inputRanges[1]->minimum ) {
-        ASSERT( maxOverflow );
-        minOverflow = true;
-    }
-
-    if( minOverflow || !maxOverflow ) {
-        ret->minimum = inputRanges[0]->minimum + inputRanges[1]->minimum;
-        ret->minimum &= typeRange->maximum;
-        ret->maximum = inputRanges[0]->maximum + inputRanges[1]->maximum;
-        ret->maximum &= typeRange->maximum;
-    } else {
-        ret->minimum = typeRange->minimum;
-        ret->maximum = typeRange->maximum;
-    }
-
-    return ret;
+    return wrapUnsignedRange(
+            ExactInt( inputRanges[0]->minimum ).checkedAdd( inputRanges[1]->minimum ),
+            ExactInt( inputRanges[0]->maximum ).checkedAdd( inputRanges[1]->maximum ),
+            *typeRange );
 }
 
 ExpressionId bPlusCodegenSigned(
@@ -92,44 +116,17 @@ ExpressionId bPlusCodegenSigned(
     return resultId;
 }
 
-ValueRangeBase::CPtr bPlusSignedVrp(StaticTypeImpl::CPtr funcType, Slice<ValueRangeBase::CPtr> inputRangesBase)
+ValueRange bPlusSignedVrp(StaticTypeImpl::CPtr funcType, Slice<const ValueRange> inputRangesBase)
 {
-    auto inputRanges = downcastValueRanges<SignedIntValueRange>( inputRangesBase );
+    auto inputRanges = downcastValueRanges<SignedIntValueRange, 2>( inputRangesBase );
     ASSERT( inputRangesBase.size()==2 );
 
     const SignedIntValueRange *typeRange = getSignedOverloadRange( funcType, inputRanges );
-    auto ret = SignedIntValueRange::allocate( typeRange );
-
-    if( inputRanges[0]->maximum>0 && (typeRange->maximum-inputRanges[0]->maximum) < inputRanges[1]->maximum ) {
-        // UB can't rule out signed overflow
-        /* There is no overflow iff: in[0]+in[1] <= range.max
-         * in[1] <= range.max-in[0]
-         * Reversal: range.max-in[0] < in[1]
-         */
-        ret->maximum = typeRange->maximum;
-    } else if( inputRanges[0]->maximum<0 && (typeRange->minimum-inputRanges[0]->maximum) > inputRanges[1]->maximum ) {
-        // UB can't rule out signed negative overflow
-        /* There is no negative overflow iff: in[0]+in[1] >= range.min
-         * in[1] >= range.min-in[0]
-         * Reversal of condition: range.min-in[0] > in[1]
-         */
-        ret->maximum = typeRange->minimum;
-    } else {
-        ret->maximum = inputRanges[0]->maximum + inputRanges[1]->maximum;
-    }
-
-    if( inputRanges[0]->minimum>0 && (typeRange->maximum-inputRanges[0]->minimum) < inputRanges[1]->minimum ) {
-        // UB can't rule out signed overflow
-        ret->minimum = typeRange->maximum;
-        ASSERT( ret->maximum == typeRange->maximum );
-    } else if( inputRanges[0]->minimum<0 && (typeRange->minimum-inputRanges[0]->minimum) > inputRanges[1]->minimum ) {
-        // UB can't rule out signed negative overflow
-        ret->minimum = typeRange->minimum;
-    } else {
-        ret->minimum = inputRanges[0]->minimum + inputRanges[1]->minimum;
-    }
 
-    return ret;
+    return clampSignedRange(
+            ExactInt( inputRanges[0]->minimum ).checkedAdd( inputRanges[1]->minimum ),
+            ExactInt( inputRanges[0]->maximum ).checkedAdd( inputRanges[1]->maximum ),
+            *typeRange );
 }
 
 
@@ -155,37 +152,17 @@ ExpressionId bMinusCodegenUnsigned(
     return resultId;
 }
 
-ValueRangeBase::CPtr bMinusUnsignedVrp(StaticTypeImpl::CPtr funcType, Slice<ValueRangeBase::CPtr> inputRangesBase)
+ValueRange bMinusUnsignedVrp(StaticTypeImpl::CPtr funcType, Slice<const ValueRange> inputRangesBase)
 {
-    auto inputRanges = downcastValueRanges<UnsignedIntValueRange>( inputRangesBase );
+    auto inputRanges = downcastValueRanges<UnsignedIntValueRange, 2>( inputRangesBase );
     ASSERT( inputRangesBase.size()==2 );
 
     const UnsignedIntValueRange *typeRange = getUnsignedOverloadRange( funcType, inputRanges );
-    auto ret = UnsignedIntValueRange::allocate( typeRange );
-
-    bool maxOverflow = false;
-    bool minOverflow = false;
-    if( inputRanges[0]->maximum < inputRanges[1]->minimum ) {
-        // Biggest number is a.max - b.min
-        maxOverflow = true;
-        minOverflow = true;
-    } else if( inputRanges[0]->minimum < inputRanges[1]->maximum ) {
-        // Smallest is a.min - b.max
-        minOverflow = true;
-    }
 
-    if( minOverflow || !maxOverflow ) {
-        // Either both or neither overflow. Destination min and max overflowed the same number of times
-        ret->minimum = inputRanges[0]->minimum - inputRanges[1]->maximum;
-        ret->minimum &= typeRange->maximum;
-        ret->maximum = inputRanges[0]->maximum - inputRanges[1]->minimum;
-        ret->maximum &= typeRange->maximum;
-    } else {
-        ret->minimum = typeRange->minimum;
-        ret->maximum = typeRange->maximum;
-    }
-
-    return ret;
+    return wrapUnsignedRange(
+            ExactInt( inputRanges[0]->minimum ).checkedSub( inputRanges[1]->maximum ),
+            ExactInt( inputRanges[0]->maximum ).checkedSub( inputRanges[1]->minimum ),
+            *typeRange );
 }
 
 ExpressionId bMinusCodegenSigned(
@@ -208,77 +185,17 @@ ExpressionId bMinusCodegenSigned(
     return resultId;
 }
 
-ValueRangeBase::CPtr bMinusSignedVrp(StaticTypeImpl::CPtr funcType, Slice<ValueRangeBase::CPtr> inputRangesBase)
+ValueRange bMinusSignedVrp(StaticTypeImpl::CPtr funcType, Slice<const ValueRange> inputRangesBase)
 {
-    auto inputRanges = downcastValueRanges<SignedIntValueRange>( inputRangesBase );
+    auto inputRanges = downcastValueRanges<SignedIntValueRange, 2>( inputRangesBase );
     ASSERT( inputRangesBase.size()==2 );
 
     const SignedIntValueRange *typeRange = getSignedOverloadRange( funcType, inputRanges );
-    auto ret = SignedIntValueRange::allocate( typeRange );
-
-    if( inputRanges[1]->minimum>=0 || inputRanges[0]->maximum <= typeRange->maximum + inputRanges[1]->minimum )
-    {
-        /* Won't overflow iff:
-         * in[1].min>0
-         * or
-         * in[0].max - in[1].min <= range.max
-         * in[0].max <= range.max + in[1].min
-         */
-
-        // Make sure the maximal result doesn't negative overflow
-        if( inputRanges[1]->minimum<0 || inputRanges[0]->maximum >= typeRange->minimum + inputRanges[1]->minimum )
-        {
-            /* Won't overflow iff:
-             * in[1].min<0
-             * or
-             * in[0].max - in[1].min >= range.min
-             * in[0].max >= range.min + in[1].min
-             */
-            ret->maximum = inputRanges[0]->maximum - inputRanges[1]->minimum;
-        } else {
-            // The maximal result performs a negative overflow. UB is guaranteed.
-            // XXX no context for exception
-            //throw UndefinedBehavior( "Guaranteed signed integer negative overflow", 0, 0 );
-            ret->maximum = ret->minimum = typeRange->minimum;
-            return ret;
-        }
-    } else {
-        // UB can't rule out signed overflow.
-        ret->maximum = typeRange->maximum;
-    }
 
-    if( inputRanges[1]->maximum<0 || inputRanges[0]->minimum >= typeRange->minimum + inputRanges[1]->maximum )
-    {
-        /* Won't negative overflow iff:
-         * in[1].max<0
-         * or
-         * in[0].min - in[1].max >= range.min
-         * in[0].min >= range.min + in[1].max
-         */
-
-        // Make sure the minimal result doesn't positive overflow
-        if( inputRanges[1]->maximum>0 || inputRanges[0]->minimum <= typeRange->maximum - inputRanges[1]->maximum )
-        {
-            /* Won't overflow iff:
-             * in[1].max>0
-             * or
-             * in[0].min - in[1].max <= range.max
-             * in[0].min <= range.max + in[1].max
-             */
-            ret->minimum = inputRanges[0]->minimum - inputRanges[1]->maximum;
-        } else {
-            // The maximal result performs a negative overflow. UB is guaranteed.
-            // XXX no context for exception
-            //throw UndefinedBehavior( "Guaranteed signed integer positive overflow", 0, 0 );
-            ret->maximum = ret->minimum = typeRange->maximum;
-            return ret;
-        }
-    } else {
-        // UB can't rule out signed negative overflow.
-        ret->minimum = typeRange->minimum;
-    }
-
-    return ret;
+    return clampSignedRange(
+            ExactInt( inputRanges[0]->minimum ).checkedSub( inputRanges[1]->maximum ),
+            ExactInt( inputRanges[0]->maximum ).checkedSub( inputRanges[1]->minimum ),
+            *typeRange );
 }
 
 
@@ -304,27 +221,17 @@ ExpressionId bMultiplyCodegenUnsigned(
     return resultId;
 }
 
-ValueRangeBase::CPtr bMultiplyUnsignedVrp(StaticTypeImpl::CPtr funcType, Slice<ValueRangeBase::CPtr> inputRangesBase)
+ValueRange bMultiplyUnsignedVrp(StaticTypeImpl::CPtr funcType, Slice<const ValueRange> inputRangesBase)
 {
-    auto inputRanges = downcastValueRanges<UnsignedIntValueRange>( inputRangesBase );
+    auto inputRanges = downcastValueRanges<UnsignedIntValueRange, 2>( inputRangesBase );
     ASSERT( inputRangesBase.size()==2 );
 
     const UnsignedIntValueRange *typeRange = getUnsignedOverloadRange( funcType, inputRanges );
-    auto ret = UnsignedIntValueRange::allocate( typeRange );
-
-    LongEnoughInt tmpResult;
-    bool overflowed = __builtin_mul_overflow( inputRanges[0]->maximum, inputRanges[1]->maximum, &tmpResult );
-    ret->maximum = tmpResult & typeRange->maximum;
-    if( overflowed || ret->maximum!=tmpResult ) {
-        // We overflowed
-        return typeRange;
-    }
 
-    overflowed = __builtin_mul_overflow( inputRanges[0]->minimum, inputRanges[1]->minimum, &ret->minimum );
-    ASSERT( !overflowed && ret->minimum == (ret->minimum & typeRange->maximum) )<<
-            "Unsigned multiplication minimal value overflowed while maximal did not";
-
-    return ret;
+    return wrapUnsignedRange(
+            ExactInt( inputRanges[0]->minimum ).checkedMul( inputRanges[1]->minimum ),
+            ExactInt( inputRanges[0]->maximum ).checkedMul( inputRanges[1]->maximum ),
+            *typeRange );
 }
 
 ExpressionId bMultiplyCodegenSigned(
@@ -347,35 +254,31 @@ ExpressionId bMultiplyCodegenSigned(
     return resultId;
 }
 
-ValueRangeBase::CPtr bMultiplySignedVrp(StaticTypeImpl::CPtr funcType, Slice<ValueRangeBase::CPtr> inputRangesBase)
+ValueRange bMultiplySignedVrp(StaticTypeImpl::CPtr funcType, Slice<const ValueRange> inputRangesBase)
 {
-    auto inputRanges = downcastValueRanges<SignedIntValueRange>( inputRangesBase );
+    auto inputRanges = downcastValueRanges<SignedIntValueRange, 2>( inputRangesBase );
     ASSERT( inputRangesBase.size()==2 );
 
     const SignedIntValueRange *typeRange = getSignedOverloadRange( funcType, inputRanges );
 
-    LongEnoughIntSigned tmp1, tmp2, tmp3, tmp4;
-
-    // XXX We depend on 2's complement representation
-#define CHECK_OVERFLOW(a) ( (a)>0 ? ( ((a)&typeRange->maximum)!=(a)) : ( ((a)&typeRange->minimum) != typeRange->minimum) )
-    bool overflowed = __builtin_mul_overflow( inputRanges[0]->maximum, inputRanges[1]->maximum, &tmp1 ) ||
-            CHECK_OVERFLOW(tmp1);
-    overflowed = overflowed || __builtin_mul_overflow( inputRanges[0]->maximum, inputRanges[1]->minimum, &tmp2 ) ||
-            CHECK_OVERFLOW(tmp2);
-    overflowed = overflowed || __builtin_mul_overflow( inputRanges[0]->minimum, inputRanges[1]->maximum, &tmp3 ) ||
-            CHECK_OVERFLOW(tmp3);
-    overflowed = overflowed || __builtin_mul_overflow( inputRanges[0]->minimum, inputRanges[1]->minimum, &tmp4 ) ||
-            CHECK_OVERFLOW(tmp4);
-#undef CHECK_OVERFLOW
-
-    if( overflowed ) {
-        return typeRange;
+    // With mixed signs, any of the corners might be the extreme
+    std::optional<ExactInt> corners[4] = {
+        ExactInt( inputRanges[0]->minimum ).checkedMul( inputRanges[1]->minimum ),
+        ExactInt( inputRanges[0]->minimum ).checkedMul( inputRanges[1]->maximum ),
+        ExactInt( inputRanges[0]->maximum ).checkedMul( inputRanges[1]->minimum ),
+        ExactInt( inputRanges[0]->maximum ).checkedMul( inputRanges[1]->maximum ),
+    };
+
+    std::optional<ExactInt> minimum = corners[0], maximum = corners[0];
+    for( const std::optional<ExactInt> &corner : corners ) {
+        if( !corner )
+            return *typeRange;
+
+        minimum = std::min( *minimum, *corner );
+        maximum = std::max( *maximum, *corner );
     }
 
-    return SignedIntValueRange::allocate(
-            std::min( std::min(tmp1, tmp2), std::min(tmp3, tmp4) ),
-            std::max( std::max(tmp1, tmp2), std::max(tmp3, tmp4) )
-        );
+    return clampSignedRange( minimum, maximum, *typeRange );
 }
 
 // Divide
@@ -399,18 +302,24 @@ ExpressionId bDivideCodegenUnsigned(
     return resultId;
 }
 
-ValueRangeBase::CPtr bDivideUnsignedVrp(StaticTypeImpl::CPtr funcType, Slice<ValueRangeBase::CPtr> inputRangesBase)
+ValueRange bDivideUnsignedVrp(StaticTypeImpl::CPtr funcType, Slice<const ValueRange> inputRangesBase)
 {
-    auto inputRanges = downcastValueRanges<UnsignedIntValueRange>( inputRangesBase );
+    auto inputRanges = downcastValueRanges<UnsignedIntValueRange, 2>( inputRangesBase );
     ASSERT( inputRangesBase.size()==2 );
 
     const UnsignedIntValueRange *typeRange = getUnsignedOverloadRange( funcType, inputRanges );
-    auto ret = UnsignedIntValueRange::allocate( typeRange );
 
-    ret->maximum = inputRanges[0]->maximum / inputRanges[1]->minimum;
-    ret->minimum = inputRanges[0]->minimum / inputRanges[1]->maximum;
+    if( inputRanges[1]->maximum==0 ) {
+        // Always divides by zero
+        return *typeRange;
+    }
+
+    // Division by zero is undefined, so the smallest divisor that matters is 1
+    LongEnoughInt smallestDivisor = std::max( inputRanges[1]->minimum, LongEnoughInt(1) );
 
-    return ret;
+    return UnsignedIntValueRange(
+            inputRanges[0]->minimum / inputRanges[1]->maximum,
+            inputRanges[0]->maximum / smallestDivisor );
 }
 
 
@@ -19,37 +19,37 @@ using PracticalSemanticAnalyzer::ExpressionId;
 
 ExpressionId bPlusCodegenUnsigned(
         Slice<const Expression>, const LookupContext::Function::Definition *, PracticalSemanticAnalyzer::FunctionGen *);
-ValueRangeBase::CPtr bPlusUnsignedVrp(StaticTypeImpl::CPtr functType, Slice<ValueRangeBase::CPtr> inputRanges);
+ValueRange bPlusUnsignedVrp(StaticTypeImpl::CPtr functType, Slice<const ValueRange> inputRanges);
 
 ExpressionId bPlusCodegenSigned(
         Slice<const Expression>, const LookupContext::Function::Definition *, PracticalSemanticAnalyzer::FunctionGen *);
-ValueRangeBase::CPtr bPlusSignedVrp(StaticTypeImpl::CPtr functType, Slice<ValueRangeBase::CPtr> inputRanges);
+ValueRange bPlusSignedVrp(StaticTypeImpl::CPtr functType, Slice<const ValueRange> inputRanges);
 
 
 
 ExpressionId bMinusCodegenUnsigned(
         Slice<const Expression>, const LookupContext::Function::Definition *, PracticalSemanticAnalyzer::FunctionGen *);
-ValueRangeBase::CPtr bMinusUnsignedVrp(StaticTypeImpl::CPtr functType, Slice<ValueRangeBase::CPtr> inputRanges);
+ValueRange bMinusUnsignedVrp(StaticTypeImpl::CPtr functType, Slice<const ValueRange> inputRanges);
 
 ExpressionId bMinusCodegenSigned(
         Slice<const Expression>, const LookupContext::Function::Definition *, PracticalSemanticAnalyzer::FunctionGen *);
-ValueRangeBase::CPtr bMinusSignedVrp(StaticTypeImpl::CPtr functType, Slice<ValueRangeBase::CPtr> inputRanges);
+ValueRange bMinusSignedVrp(StaticTypeImpl::CPtr functType, Slice<const ValueRange> inputRanges);
 
 
 
 ExpressionId bMultiplyCodegenUnsigned(
         Slice<const Expression>, const LookupContext::Function::Definition *, PracticalSemanticAnalyzer::FunctionGen *);
-ValueRangeBase::CPtr bMultiplyUnsignedVrp(StaticTypeImpl::CPtr functType, Slice<ValueRangeBase::CPtr> inputRanges);
+ValueRange bMultiplyUnsignedVrp(StaticTypeImpl::CPtr functType, Slice<const ValueRange> inputRanges);
 
 ExpressionId bMultiplyCodegenSigned(
         Slice<const Expression>, const LookupContext::Function::Definition *, PracticalSemanticAnalyzer::FunctionGen *);
-ValueRangeBase::CPtr bMultiplySignedVrp(StaticTypeImpl::CPtr functType, Slice<ValueRangeBase::CPtr> inputRanges);
+ValueRange bMultiplySignedVrp(StaticTypeImpl::CPtr functType, Slice<const ValueRange> inputRanges);
 
 
 
 ExpressionId bDivideCodegenUnsigned(
         Slice<const Expression>, const LookupContext::Function::Definition *, PracticalSemanticAnalyzer::FunctionGen *);
-ValueRangeBase::CPtr bDivideUnsignedVrp(StaticTypeImpl::CPtr functType, Slice<ValueRangeBase::CPtr> inputRanges);
+ValueRange bDivideUnsignedVrp(StaticTypeImpl::CPtr functType, Slice<const ValueRange> inputRanges);
 
 } // namespace AST::Operators
 
@@ -10,8 +10,6 @@
 
 #include "ast/operators/helper.h"
 #include "ast/ast.h"
-#include "ast/bool_value_range.h"
-#include "ast/unsigned_int_value_range.h"
 
 namespace AST::Operators {
 
@@ -50,17 +48,17 @@ ExpressionId equalsCodegenInt(
 }
 
 template<typename VR, bool negate>
-static ValueRangeBase::CPtr equalsVrpImpl(StaticTypeImpl::CPtr functType, Slice<ValueRangeBase::CPtr> inputRangesBase)
+static ValueRange equalsVrpImpl(StaticTypeImpl::CPtr functType, Slice<const ValueRange> inputRangesBase)
 {
     ASSERT( inputRangesBase.size()==2 );
-    auto inputRanges = downcastValueRanges<VR>( inputRangesBase );
+    auto inputRanges = downcastValueRanges<VR, 2>( inputRangesBase );
 
     // True is not an option iff there is no intersection between the ranges
     if( inputRanges[0]->maximum<inputRanges[1]->minimum || inputRanges[0]->minimum > inputRanges[1]->maximum ) {
         if constexpr( !negate )
-            return BoolValueRange::allocate( false, true );
+            return BoolValueRange( false, true );
         else
-            return BoolValueRange::allocate( true, false );
+            return BoolValueRange( true, false );
     }
 
     // False is not an option iff both are literals and identical
@@ -69,19 +67,19 @@ static ValueRangeBase::CPtr equalsVrpImpl(StaticTypeImpl::CPtr functType, Slice<
             inputRanges[0]->minimum==inputRanges[1]->minimum
       ) {
         if constexpr( !negate )
-            return BoolValueRange::allocate( true, false );
+            return BoolValueRange( true, false );
         else
-            return BoolValueRange::allocate( false, true );
+            return BoolValueRange( false, true );
     }
 
-    return BoolValueRange::allocate( true, true );
+    return BoolValueRange( true, true );
 }
 
-ValueRangeBase::CPtr equalsVrpUnsigned(StaticTypeImpl::CPtr functType, Slice<ValueRangeBase::CPtr> inputRangesBase) {
+ValueRange equalsVrpUnsigned(StaticTypeImpl::CPtr functType, Slice<const ValueRange> inputRangesBase) {
     return equalsVrpImpl<UnsignedIntValueRange, false>( std::move(functType), inputRangesBase );
 }
 
-ValueRangeBase::CPtr equalsVrpSigned(StaticTypeImpl::CPtr functType, Slice<ValueRangeBase::CPtr> inputRangesBase) {
+ValueRange equalsVrpSigned(StaticTypeImpl::CPtr functType, Slice<const ValueRange> inputRangesBase) {
     return equalsVrpImpl<SignedIntValueRange, false>( std::move(functType), inputRangesBase );
 }
 
@@ -93,19 +91,19 @@ ExpressionId notEqualsCodegenInt(
     return genericCodeGen< &FunctionGen::operatorNotEquals >(arguments, definition, functionGen);
 }
 
-ValueRangeBase::CPtr notEqualsVrpUnsigned(StaticTypeImpl::CPtr functType, Slice<ValueRangeBase::CPtr> inputRangesBase) {
+ValueRange notEqualsVrpUnsigned(StaticTypeImpl::CPtr functType, Slice<const ValueRange> inputRangesBase) {
     return equalsVrpImpl<UnsignedIntValueRange, true>( std::move(functType), inputRangesBase );
 }
 
-ValueRangeBase::CPtr notEqualsVrpSigned(StaticTypeImpl::CPtr functType, Slice<ValueRangeBase::CPtr> inputRangesBase) {
+ValueRange notEqualsVrpSigned(StaticTypeImpl::CPtr functType, Slice<const ValueRange> inputRangesBase) {
     return equalsVrpImpl<SignedIntValueRange, true>( std::move(functType), inputRangesBase );
 }
 
 
 template<typename VR, bool Equals, bool Negate>
-static ValueRangeBase::CPtr lessThanVrpImpl(StaticTypeImpl::CPtr functType, Slice<ValueRangeBase::CPtr> inputRangesBase)
+static ValueRange lessThanVrpImpl(StaticTypeImpl::CPtr functType, Slice<const ValueRange> inputRangesBase)
 {
-    auto inputRanges = downcastValueRanges<VR>( inputRangesBase );
+    auto inputRanges = downcastValueRanges<VR, 2>( inputRangesBase );
     ASSERT( inputRangesBase.size()==2 );
 
     // Cannot be True iff left is entirely above right
@@ -117,9 +115,9 @@ static ValueRangeBase::CPtr lessThanVrpImpl(StaticTypeImpl::CPtr functType, Slic
       )
     {
         if constexpr( !Negate )
-            return BoolValueRange::allocate( true, false );
+            return BoolValueRange( true, false );
         else
-            return BoolValueRange::allocate( false, true );
+            return BoolValueRange( false, true );
     }
 
     // Cannot be False iff left is entirely below right
@@ -130,12 +128,12 @@ static ValueRangeBase::CPtr lessThanVrpImpl(StaticTypeImpl::CPtr functType, Slic
       )
     {
         if constexpr( !Negate )
-            return BoolValueRange::allocate( false, true );
+            return BoolValueRange( false, true );
         else
-            return BoolValueRange::allocate( true, false );
+            return BoolValueRange( true, false );
     }
 
-    return BoolValueRange::allocate( true, true );
+    return BoolValueRange( true, true );
 }
 
 ExpressionId lessThanCodegenUInt(
@@ -146,7 +144,7 @@ ExpressionId lessThanCodegenUInt(
     return genericCodeGen< &FunctionGen::operatorLessThanUnsigned >(arguments, definition, functionGen);
 }
 
-ValueRangeBase::CPtr lessThanVrpUnsigned(StaticTypeImpl::CPtr funcType, Slice<ValueRangeBase::CPtr> inputRanges)
+ValueRange lessThanVrpUnsigned(StaticTypeImpl::CPtr funcType, Slice<const ValueRange> inputRanges)
 {
     return lessThanVrpImpl< UnsignedIntValueRange, false, false >( std::move(funcType), inputRanges );
 }
@@ -159,7 +157,7 @@ ExpressionId lessThanCodegenSInt(
     return genericCodeGen< &FunctionGen::operatorLessThanSigned >(arguments, definition, functionGen);
 }
 
-ValueRangeBase::CPtr lessThanVrpSigned(StaticTypeImpl::CPtr funcType, Slice<ValueRangeBase::CPtr> inputRanges)
+ValueRange lessThanVrpSigned(StaticTypeImpl::CPtr funcType, Slice<const ValueRange> inputRanges)
 {
     return lessThanVrpImpl< SignedIntValueRange, false, false >( std::move(funcType), inputRanges );
 }
@@ -173,7 +171,7 @@ ExpressionId lessThanOrEqualsCodegenUInt(
     return genericCodeGen< &FunctionGen::operatorLessThanOrEqualsUnsigned >(arguments, definition, functionGen);
 }
 
-ValueRangeBase::CPtr lessThanOrEqualsVrpUnsigned(StaticTypeImpl::CPtr funcType, Slice<ValueRangeBase::CPtr> inputRanges)
+ValueRange lessThanOrEqualsVrpUnsigned(StaticTypeImpl::CPtr funcType, Slice<const ValueRange> inputRanges)
 {
     return lessThanVrpImpl< UnsignedIntValueRange, true, false >( std::move(funcType), inputRanges );
 }
@@ -186,7 +184,7 @@ ExpressionId lessThanOrEqualsCodegenSInt(
     return genericCodeGen< &FunctionGen::operatorLessThanOrEqualsSigned >(arguments, definition, functionGen);
 }
 
-ValueRangeBase::CPtr lessThanOrEqualsVrpSigned(StaticTypeImpl::CPtr funcType, Slice<ValueRangeBase::CPtr> inputRanges)
+ValueRange lessThanOrEqualsVrpSigned(StaticTypeImpl::CPtr funcType, Slice<const ValueRange> inputRanges)
 {
     return lessThanVrpImpl< SignedIntValueRange, true, false >( std::move(funcType), inputRanges );
 }
@@ -200,7 +198,7 @@ ExpressionId greaterThenCodegenUInt(
     return genericCodeGen< &FunctionGen::operatorGreaterThanUnsigned >(arguments, definition, functionGen);
 }
 
-ValueRangeBase::CPtr greaterThenVrpUnsigned(StaticTypeImpl::CPtr funcType, Slice<ValueRangeBase::CPtr> inputRanges)
+ValueRange greaterThenVrpUnsigned(StaticTypeImpl::CPtr funcType, Slice<const ValueRange> inputRanges)
 {
     return lessThanVrpImpl< UnsignedIntValueRange, true, true >( std::move(funcType), inputRanges );
 }
@@ -213,7 +211,7 @@ ExpressionId greaterThenCodegenSInt(
     return genericCodeGen< &FunctionGen::operatorGreaterThanSigned >(arguments, definition, functionGen);
 }
 
-ValueRangeBase::CPtr greaterThenVrpSigned(StaticTypeImpl::CPtr funcType, Slice<ValueRangeBase::CPtr> inputRanges)
+ValueRange greaterThenVrpSigned(StaticTypeImpl::CPtr funcType, Slice<const ValueRange> inputRanges)
 {
     return lessThanVrpImpl< SignedIntValueRange, true, true >( std::move(funcType), inputRanges );
 }
@@ -227,7 +225,7 @@ ExpressionId greaterThenOrEqualsCodegenUInt(
     return genericCodeGen< &FunctionGen::operatorGreaterThanOrEqualsUnsigned >(arguments, definition, functionGen);
 }
 
-ValueRangeBase::CPtr greaterThenOrEqualsVrpUnsigned(StaticTypeImpl::CPtr funcType, Slice<ValueRangeBase::CPtr> inputRanges)
+ValueRange greaterThenOrEqualsVrpUnsigned(StaticTypeImpl::CPtr funcType, Slice<const ValueRange> inputRanges)
 {
     return lessThanVrpImpl< UnsignedIntValueRange, false, true >( std::move(funcType), inputRanges );
 }
@@ -240,7 +238,7 @@ ExpressionId greaterThenOrEqualsCodegenSInt(
     return genericCodeGen< &FunctionGen::operatorGreaterThanOrEqualsSigned >(arguments, definition, functionGen);
 }
 
-ValueRangeBase::CPtr greaterThenOrEqualsVrpSigned(StaticTypeImpl::CPtr funcType, Slice<ValueRangeBase::CPtr> inputRanges)
+ValueRange greaterThenOrEqualsVrpSigned(StaticTypeImpl::CPtr funcType, Slice<const ValueRange> inputRanges)
 {
     return lessThanVrpImpl< SignedIntValueRange, false, true >( std::move(funcType), inputRanges );
 }
@@ -264,8 +262,8 @@ ExpressionId logicalAnd(
     ExpressionId leftArgumentId = arguments[0].codeGen(functionGen);
     ExpressionId resultId = ExpressionImpl::Base::allocateId();
 
-    JumpPointId elsePoint = jumpPointAllocator.allocate(),
-                contPoint = jumpPointAllocator.allocate();
+    JumpPointId elsePoint = CompilationSession::current().allocateJumpPoint(),
+                contPoint = CompilationSession::current().allocateJumpPoint();
 
     functionGen->conditionalBranch( resultId, definition->returnType(), leftArgumentId, elsePoint, contPoint );
 
@@ -286,13 +284,13 @@ ExpressionId logicalAnd(
     return resultId;
 }
 
-ValueRangeBase::CPtr logicalAndVrp(
-        StaticTypeImpl::CPtr functType, Slice<ValueRangeBase::CPtr> inputRangesBase)
+ValueRange logicalAndVrp(
+        StaticTypeImpl::CPtr functType, Slice<const ValueRange> inputRangesBase)
 {
     ASSERT( inputRangesBase.size()==2 );
-    auto inputRanges = downcastValueRanges<BoolValueRange>( inputRangesBase );
+    auto inputRanges = downcastValueRanges<BoolValueRange, 2>( inputRangesBase );
 
-    return new BoolValueRange(
+    return BoolValueRange(
             inputRanges[0]->falseAllowed || inputRanges[1]->falseAllowed,
             inputRanges[0]->trueAllowed && inputRanges[1]->trueAllowed );
 }
@@ -316,8 +314,8 @@ ExpressionId logicalOr(
     ExpressionId leftArgumentId = arguments[0].codeGen(functionGen);
     ExpressionId resultId = ExpressionImpl::Base::allocateId();
 
-    JumpPointId elsePoint = jumpPointAllocator.allocate(),
-                contPoint = jumpPointAllocator.allocate();
+    JumpPointId elsePoint = CompilationSession::current().allocateJumpPoint(),
+                contPoint = CompilationSession::current().allocateJumpPoint();
 
     functionGen->conditionalBranch( resultId, definition->returnType(), leftArgumentId, elsePoint, contPoint );
 
@@ -340,12 +338,12 @@ ExpressionId logicalOr(
     return resultId;
 }
 
-ValueRangeBase::CPtr logicalOrVrp(StaticTypeImpl::CPtr functType, Slice<ValueRangeBase::CPtr> inputRangesBase)
+ValueRange logicalOrVrp(StaticTypeImpl::CPtr functType, Slice<const ValueRange> inputRangesBase)
 {
     ASSERT( inputRangesBase.size()==2 )<<"Expected value ranges for two arguments, got "<<inputRangesBase.size();
-    auto inputRanges = downcastValueRanges<BoolValueRange>( inputRangesBase );
+    auto inputRanges = downcastValueRanges<BoolValueRange, 2>( inputRangesBase );
 
-    return new BoolValueRange(
+    return BoolValueRange(
             inputRanges[0]->falseAllowed && inputRanges[1]->falseAllowed,
             inputRanges[0]->trueAllowed || inputRanges[1]->trueAllowed );
 }
@@ -366,14 +364,14 @@ ExpressionId logicalNot(
     return resultId;
 }
 
-ValueRangeBase::CPtr logicalNotVrp(
-        StaticTypeImpl::CPtr functType, Slice<ValueRangeBase::CPtr> inputRangesBase)
+ValueRange logicalNotVrp(
+        StaticTypeImpl::CPtr functType, Slice<const ValueRange> inputRangesBase)
 {
     ASSERT( inputRangesBase.size()==1 )
             <<"Expected value ranges for one argument, got "<<inputRangesBase.size();
-    auto inputRanges = downcastValueRanges<BoolValueRange>( inputRangesBase );
+    auto inputRanges = downcastValueRanges<BoolValueRange, 1>( inputRangesBase );
 
-    return new BoolValueRange(
+    return BoolValueRange(
             inputRanges[0]->trueAllowed, inputRanges[0]->falseAllowed );
 }
 
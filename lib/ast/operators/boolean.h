@@ -18,66 +18,66 @@ namespace AST::Operators {
 // ==
 ExpressionId equalsCodegenInt(
         Slice<const Expression>, const LookupContext::Function::Definition *, PracticalSemanticAnalyzer::FunctionGen *);
-ValueRangeBase::CPtr equalsVrpUnsigned(StaticTypeImpl::CPtr functType, Slice<ValueRangeBase::CPtr> inputRanges);
-ValueRangeBase::CPtr equalsVrpSigned(StaticTypeImpl::CPtr functType, Slice<ValueRangeBase::CPtr> inputRanges);
+ValueRange equalsVrpUnsigned(StaticTypeImpl::CPtr functType, Slice<const ValueRange> inputRanges);
+ValueRange equalsVrpSigned(StaticTypeImpl::CPtr functType, Slice<const ValueRange> inputRanges);
 // !=
 ExpressionId notEqualsCodegenInt(
         Slice<const Expression>, const LookupContext::Function::Definition *, PracticalSemanticAnalyzer::FunctionGen *);
-ValueRangeBase::CPtr notEqualsVrpUnsigned(StaticTypeImpl::CPtr functType, Slice<ValueRangeBase::CPtr> inputRanges);
-ValueRangeBase::CPtr notEqualsVrpSigned(StaticTypeImpl::CPtr functType, Slice<ValueRangeBase::CPtr> inputRanges);
+ValueRange notEqualsVrpUnsigned(StaticTypeImpl::CPtr functType, Slice<const ValueRange> inputRanges);
+ValueRange notEqualsVrpSigned(StaticTypeImpl::CPtr functType, Slice<const ValueRange> inputRanges);
 
 // <
 ExpressionId lessThanCodegenUInt(
         Slice<const Expression>, const LookupContext::Function::Definition *, PracticalSemanticAnalyzer::FunctionGen *);
-ValueRangeBase::CPtr lessThanVrpUnsigned(StaticTypeImpl::CPtr functType, Slice<ValueRangeBase::CPtr> inputRanges);
+ValueRange lessThanVrpUnsigned(StaticTypeImpl::CPtr functType, Slice<const ValueRange> inputRanges);
 
 ExpressionId lessThanCodegenSInt(
         Slice<const Expression>, const LookupContext::Function::Definition *, PracticalSemanticAnalyzer::FunctionGen *);
-ValueRangeBase::CPtr lessThanVrpSigned(StaticTypeImpl::CPtr functType, Slice<ValueRangeBase::CPtr> inputRanges);
+ValueRange lessThanVrpSigned(StaticTypeImpl::CPtr functType, Slice<const ValueRange> inputRanges);
 
 // <=
 ExpressionId lessThanOrEqualsCodegenUInt(
         Slice<const Expression>, const LookupContext::Function::Definition *, PracticalSemanticAnalyzer::FunctionGen *);
-ValueRangeBase::CPtr lessThanOrEqualsVrpUnsigned(StaticTypeImpl::CPtr functType, Slice<ValueRangeBase::CPtr> inputRanges);
+ValueRange lessThanOrEqualsVrpUnsigned(StaticTypeImpl::CPtr functType, Slice<const ValueRange> inputRanges);
 
 ExpressionId lessThanOrEqualsCodegenSInt(
         Slice<const Expression>, const LookupContext::Function::Definition *, PracticalSemanticAnalyzer::FunctionGen *);
-ValueRangeBase::CPtr lessThanOrEqualsVrpSigned(StaticTypeImpl::CPtr functType, Slice<ValueRangeBase::CPtr> inputRanges);
+ValueRange lessThanOrEqualsVrpSigned(StaticTypeImpl::CPtr functType, Slice<const ValueRange> inputRanges);
 
 // >
 ExpressionId greaterThenCodegenUInt(
         Slice<const Expression>, const LookupContext::Function::Definition *, PracticalSemanticAnalyzer::FunctionGen *);
-ValueRangeBase::CPtr greaterThenVrpUnsigned(StaticTypeImpl::CPtr functType, Slice<ValueRangeBase::CPtr> inputRanges);
+ValueRange greaterThenVrpUnsigned(StaticTypeImpl::CPtr functType, Slice<const ValueRange> inputRanges);
 
 ExpressionId greaterThenCodegenSInt(
         Slice<const Expression>, const LookupContext::Function::Definition *, PracticalSemanticAnalyzer::FunctionGen *);
-ValueRangeBase::CPtr greaterThenVrpSigned(StaticTypeImpl::CPtr functType, Slice<ValueRangeBase::CPtr> inputRanges);
+ValueRange greaterThenVrpSigned(StaticTypeImpl::CPtr functType, Slice<const ValueRange> inputRanges);
 
 // >=
 ExpressionId greaterThenOrEqualsCodegenUInt(
         Slice<const Expression>, const LookupContext::Function::Definition *, PracticalSemanticAnalyzer::FunctionGen *);
-ValueRangeBase::CPtr greaterThenOrEqualsVrpUnsigned(StaticTypeImpl::CPtr functType, Slice<ValueRangeBase::CPtr> inputRanges);
+ValueRange greaterThenOrEqualsVrpUnsigned(StaticTypeImpl::CPtr functType, Slice<const ValueRange> inputRanges);
 
 ExpressionId greaterThenOrEqualsCodegenSInt(
         Slice<const Expression>, const LookupContext::Function::Definition *, PracticalSemanticAnalyzer::FunctionGen *);
-ValueRangeBase::CPtr greaterThenOrEqualsVrpSigned(StaticTypeImpl::CPtr functType, Slice<ValueRangeBase::CPtr> inputRanges);
+ValueRange greaterThenOrEqualsVrpSigned(StaticTypeImpl::CPtr functType, Slice<const ValueRange> inputRanges);
 
 
 // &&
 ExpressionId logicalAnd(
         Slice<const Expression>, const LookupContext::Function::Definition *, PracticalSemanticAnalyzer::FunctionGen *);
-ValueRangeBase::CPtr logicalAndVrp(StaticTypeImpl::CPtr functType, Slice<ValueRangeBase::CPtr> inputRanges);
+ValueRange logicalAndVrp(StaticTypeImpl::CPtr functType, Slice<const ValueRange> inputRanges);
 
 // ||
 ExpressionId logicalOr(
         Slice<const Expression>, const LookupContext::Function::Definition *, PracticalSemanticAnalyzer::FunctionGen *);
-ValueRangeBase::CPtr logicalOrVrp(StaticTypeImpl::CPtr functType, Slice<ValueRangeBase::CPtr> inputRanges);
+ValueRange logicalOrVrp(StaticTypeImpl::CPtr functType, Slice<const ValueRange> inputRanges);
 
 
 // !
 ExpressionId logicalNot(
         Slice<const Expression>, const LookupContext::Function::Definition *, PracticalSemanticAnalyzer::FunctionGen *);
-ValueRangeBase::CPtr logicalNotVrp(StaticTypeImpl::CPtr functType, Slice<ValueRangeBase::CPtr> inputRanges);
+ValueRange logicalNotVrp(StaticTypeImpl::CPtr functType, Slice<const ValueRange> inputRanges);
 
 } // namespace AST::Operators
 
@@ -9,34 +9,29 @@
 #ifndef AST_OPERATORS_HELPER_H
 #define AST_OPERATORS_HELPER_H
 
-#include "ast/signed_int_value_range.h"
 #include "ast/static_type.h"
-#include "ast/unsigned_int_value_range.h"
+#include "ast/value_range.h"
+
+#include <array>
 
 namespace AST::Operators {
 
-template<typename T>
-std::vector<const T *> downcastValueRanges(Slice<ValueRangeBase::CPtr> baseRanges) {
-    std::vector<const T *> ret;
-    ret.reserve( baseRanges.size() );
-
-    for( auto baseRange : baseRanges ) {
-#ifndef NDEBUG
-        const T *ptr = dynamic_cast<const T *>( baseRange.get() );
-        ASSERT( ptr!=nullptr )<<"Downcast did from incorrect type";
-#else
-        const T *ptr = static_cast<const T *>( baseRange.get() );
-#endif
-        ret.emplace_back( ptr );
+template<typename T, size_t NumRanges>
+std::array<const T *, NumRanges> downcastValueRanges(Slice<const ValueRange> baseRanges) {
+    ASSERT( baseRanges.size()==NumRanges )<<"Expected "<<NumRanges<<" value ranges, got "<<baseRanges.size();
+
+    std::array<const T *, NumRanges> ret;
+    for( size_t i=0; i<NumRanges; ++i ) {
+        ret[i] = &baseRanges[i].get<T>();
     }
 
     return ret;
 }
 
 const UnsignedIntValueRange *getUnsignedOverloadRange(
-        const StaticTypeImpl::CPtr &funcType, Slice<const UnsignedIntValueRange *> argumentRanges );
+        const StaticTypeImpl::CPtr &funcType, Slice<const UnsignedIntValueRange *const> argumentRanges );
 const SignedIntValueRange *getSignedOverloadRange(
-        const StaticTypeImpl::CPtr &funcType, Slice<const SignedIntValueRange *> argumentRanges );
+        const StaticTypeImpl::CPtr &funcType, Slice<const SignedIntValueRange *const> argumentRanges );
 
 } // namespace AST::Operators
 
@@ -9,23 +9,23 @@
 #ifndef AST_POINTERS_H
 #define AST_POINTERS_H
 
-#include "ast/bool_value_range.h"
+#include "ast/value_range.h"
 
 namespace AST {
 
 class PointerValueRange final : public ValueRangeBase {
 public:
-    ValueRangeBase::CPtr pointedValueRange;
+    ValueRange pointedValueRange;
     BoolValueRange initialized;
 
-    explicit PointerValueRange( ValueRangeBase::CPtr pointedRange ) :
+    explicit PointerValueRange( ValueRange pointedRange ) :
         pointedValueRange( std::move( pointedRange ) ),
         initialized( false, true )
     {}
 
-    explicit PointerValueRange( ValueRangeBase::CPtr pointedRange, const BoolValueRange &initialized ) :
+    explicit PointerValueRange( ValueRange pointedRange, const BoolValueRange &initialized ) :
         pointedValueRange( std::move(pointedRange) ),
-        initialized( initialized.falseAllowed, initialized.trueAllowed )
+        initialized( initialized )
     {}
 
     explicit PointerValueRange( std::nullptr_t null ) :
@@ -40,7 +40,7 @@ public:
             return true;
 
         ASSERT( pointedValueRange );
-        return pointedValueRange->isLiteral();
+        return pointedValueRange.isLiteral();
     }
 };
 
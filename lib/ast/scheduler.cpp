@@ -0,0 +1,59 @@
+/* This file is part of the Practical programming langauge. https://github.com/Practical/practical-sa
+ *
+ * To the extent header files enjoy copyright protection, this file is file is copyright (C) 2021 by its authors
+ * You can see the file's authors in the AUTHORS file in the project's home repository.
+ *
+ * This is available under the Boost license. The license's text is available under the LICENSE file in the project's
+ * home directory.
+ */
+#include "ast/scheduler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace AST {
+
+Scheduler::Scheduler( unsigned numThreads ) : _numThreads( numThreads ) {
+    if( _numThreads==0 )
+        _numThreads = std::max( std::thread::hardware_concurrency(), 1u );
+}
+
+void Scheduler::run( size_t numTasks, const std::function<void(size_t)> &task ) {
+    std::atomic<size_t> nextTask = 0;
+    std::mutex failureLock;
+    size_t failedTask = numTasks;
+    std::exception_ptr failure;
+
+    auto worker = [&]() {
+        for( size_t index = nextTask++; index<numTasks; index = nextTask++ ) {
+            try {
+                task( index );
+            } catch(...) {
+                std::lock_guard<std::mutex> lock( failureLock );
+                if( index<failedTask ) {
+                    failedTask = index;
+                    failure = std::current_exception();
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    size_t numThreads = std::min<size_t>( _numThreads, numTasks );
+    for( size_t i=1; i<numThreads; ++i )
+        threads.emplace_back( worker );
+
+    worker();
+
+    for( auto &thread : threads )
+        thread.join();
+
+    if( failure )
+        std::rethrow_exception( failure );
+}
+
+} // namespace AST
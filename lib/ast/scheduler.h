@@ -0,0 +1,41 @@
+/* This file is part of the Practical programming langauge. https://github.com/Practical/practical-sa
+ *
+ * To the extent header files enjoy copyright protection, this file is file is copyright (C) 2021 by its authors
+ * You can see the file's authors in the AUTHORS file in the project's home repository.
+ *
+ * This is available under the Boost license. The license's text is available under the LICENSE file in the project's
+ * home directory.
+ */
+#ifndef AST_SCHEDULER_H
+#define AST_SCHEDULER_H
+
+#include "nocopy.h"
+
+#include <functional>
+
+namespace AST {
+
+// Runs a batch of independent tasks on a pool of threads.
+//
+// Free threads claim the next task in order, one at a time, so long and short tasks even out across the threads. It
+// also means a task may wait for tasks with lower indexes to finish: these were all claimed already, by threads that
+// are running them.
+class Scheduler : private NoCopy {
+    unsigned _numThreads;
+
+public:
+    // 0 means one thread per hardware thread
+    explicit Scheduler( unsigned numThreads );
+
+    unsigned getNumThreads() const {
+        return _numThreads;
+    }
+
+    // Runs task(i) for every i in [0, numTasks), and returns once they are all done. The calling thread runs tasks
+    // too. A failed task does not stop the others. Rethrows the exception of the failed task with the lowest index.
+    void run( size_t numTasks, const std::function<void(size_t)> &task );
+};
+
+} // namespace AST
+
+#endif // AST_SCHEDULER_H
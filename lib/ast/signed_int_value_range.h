@@ -9,8 +9,6 @@
 #ifndef AST_SIGNED_INT_VALUE_RANGE_H
 #define AST_SIGNED_INT_VALUE_RANGE_H
 
-#include "ast/value_range_base.h"
-
 #include <practical/practical.h>
 
 #include <type_traits>
@@ -18,27 +16,27 @@
 
 namespace AST {
 
-class SignedIntValueRange final : public ValueRangeBase {
-public:
+struct SignedIntValueRange {
     LongEnoughIntSigned minimum, maximum;
 
-    bool isLiteral() const override {
-        return minimum==maximum;
-    }
+    SignedIntValueRange() = default;
+    SignedIntValueRange( LongEnoughIntSigned minimum, LongEnoughIntSigned maximum ) :
+        minimum(minimum), maximum(maximum)
+    {}
 
-    static boost::intrusive_ptr<SignedIntValueRange> allocate( LongEnoughIntSigned min, LongEnoughIntSigned max );
-    static boost::intrusive_ptr<SignedIntValueRange> allocate( const SignedIntValueRange *that ) {
-        return allocate( that->minimum, that->maximum );
+    bool isLiteral() const {
+        return minimum==maximum;
     }
 
+    // The range of all values T can hold
     template<
             typename T,
             std::enable_if_t<
                 std::is_signed_v<T> && std::is_integral_v<T>,
                 int
             > = 0
-    > static CPtr allocate() {
-        return allocate( std::numeric_limits<T>::min(), std::numeric_limits<T>::max() );
+    > static SignedIntValueRange full() {
+        return SignedIntValueRange( std::numeric_limits<T>::min(), std::numeric_limits<T>::max() );
     }
 };
 
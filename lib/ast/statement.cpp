@@ -8,6 +8,8 @@
  */
 #include "ast/statement.h"
 
+#include "ast/ast.h"
+#include "ast/compilation_session.h"
 #include "ast/compound_statement.h"
 #include "ast/expression.h"
 
@@ -29,6 +31,8 @@ Statement::~Statement() {
 }
 
 void Statement::buildAST( LookupContext &lookupCtx ) {
+    ++AST::getStatistics().astNodes;
+
     struct Visitor {
         Statement &_this;
         LookupContext &lookupCtx;
@@ -55,9 +59,9 @@ void Statement::buildAST( LookupContext &lookupCtx ) {
 
         void operator()( const std::unique_ptr<NonTerminals::CompoundStatement> &parserCompound ) {
             auto &compound = _this.underlyingStatement.emplace<
-                    std::unique_ptr<CompoundStatement>
+                    Arena::Ptr<CompoundStatement>
                 >(
-                    safenew<CompoundStatement>( *parserCompound, lookupCtx )
+                    CompilationSession::current().getArena().make<CompoundStatement>( *parserCompound, lookupCtx )
                 );
             compound->buildAST();
         }
@@ -91,7 +95,7 @@ void Statement::codeGen( const LookupContext &lookupCtx, PracticalSemanticAnalyz
             condition.codeGen(lookupCtx, functionGen);
         }
 
-        void operator()( const std::unique_ptr<CompoundStatement> &compound ) {
+        void operator()( const Arena::Ptr<CompoundStatement> &compound ) {
             compound->codeGen(functionGen);
         }
     };
@@ -99,4 +103,36 @@ void Statement::codeGen( const LookupContext &lookupCtx, PracticalSemanticAnalyz
     std::visit( Visitor{ .lookupCtx=lookupCtx, .functionGen=functionGen}, underlyingStatement );
 }
 
+bool Statement::evaluate( const LookupContext &lookupCtx, Interpreter &interpreter ) const {
+    struct Visitor {
+        const LookupContext &lookupCtx;
+        Interpreter &interpreter;
+
+        bool operator()( std::monostate mono ) {
+            ABORT()<<"Statement is in monostate";
+        }
+
+        bool operator()( const Expression &expression ) {
+            return static_cast<bool>( expression.evaluate(interpreter) );
+        }
+
+        bool operator()( const VariableDefinition &varDef ) {
+            return varDef.evaluate( lookupCtx, interpreter );
+        }
+
+        bool operator()( const ConditionalStatement &condition ) {
+            return condition.evaluate( lookupCtx, interpreter );
+        }
+
+        bool operator()( const Arena::Ptr<CompoundStatement> &compound ) {
+            return compound->evaluate(interpreter);
+        }
+    };
+
+    if( !interpreter.step() )
+        return false;
+
+    return std::visit( Visitor{ .lookupCtx=lookupCtx, .interpreter=interpreter }, underlyingStatement );
+}
+
 } // namespace AST
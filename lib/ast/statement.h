@@ -9,6 +9,7 @@
 #ifndef AST_STATEMENT_H
 #define AST_STATEMENT_H
 
+#include "ast/arena.h"
 #include "ast/conditional_statement.h"
 #include "ast/expression.h"
 #include "ast/lookup_context.h"
@@ -22,7 +23,7 @@ class CompoundStatement;
 class Statement {
     const NonTerminals::Statement &parserStatement;
     std::variant<
-            std::monostate, Expression, VariableDefinition, ConditionalStatement, std::unique_ptr<CompoundStatement>
+            std::monostate, Expression, VariableDefinition, ConditionalStatement, Arena::Ptr<CompoundStatement>
         > underlyingStatement;
 
 public:
@@ -32,6 +33,8 @@ public:
 
     void buildAST( LookupContext &lookupCtx );
     void codeGen( const LookupContext &lookupCtx, PracticalSemanticAnalyzer::FunctionGen *functionGen ) const;
+    // Returns false if the statement cannot be evaluated at compile time
+    bool evaluate( const LookupContext &lookupCtx, Interpreter &interpreter ) const;
 };
 
 } // namespace AST
@@ -31,4 +31,13 @@ void StatementList::codeGen( const LookupContext &lookupCtx, PracticalSemanticAn
     }
 }
 
+bool StatementList::evaluate( const LookupContext &lookupCtx, Interpreter &interpreter ) const {
+    for( const auto &statement : statements ) {
+        if( !statement.evaluate( lookupCtx, interpreter ) )
+            return false;
+    }
+
+    return true;
+}
+
 } // namespace AST
@@ -23,6 +23,8 @@ public:
 
     void buildAST( LookupContext &lookupCtx );
     void codeGen( const LookupContext &lookupCtx, PracticalSemanticAnalyzer::FunctionGen *functionGen ) const;
+    // Returns false if the statement cannot be evaluated at compile time
+    bool evaluate( const LookupContext &lookupCtx, Interpreter &interpreter ) const;
 };
 
 } // namespace AST
@@ -162,6 +162,105 @@ void StaticTypeImpl::getMangledName( std::ostringstream &formatter ) const {
     std::visit( Visitor{ .formatter=formatter }, getType() );
 }
 
+bool StaticTypeImpl::freeze() const {
+    // The type is made immortal before its parts, which also stops the recursion on structs that point to themselves
+    if( isImmortal() )
+        return !mangledName.empty();
+
+    makeImmortal();
+
+    struct Visitor {
+        bool mangleable = true;
+
+        void operator()( const Scalar *scalar ) {
+        }
+
+        void operator()( const Function *function ) {
+            // The generic function type has no return type, and no mangled name
+            if( function->getReturnType() )
+                mangleable = downCast( function->getReturnType() )->freeze() && mangleable;
+            else
+                mangleable = false;
+
+            for( unsigned i=0; i<function->getNumArguments(); ++i )
+                mangleable = downCast( function->getArgumentType(i) )->freeze() && mangleable;
+        }
+
+        void operator()( const Pointer *pointer ) {
+            mangleable = downCast( pointer->getPointedType() )->freeze();
+        }
+
+        void operator()( const Array *array ) {
+            mangleable = downCast( array->getElementType() )->freeze();
+        }
+
+        void operator()( const Struct *strct ) {
+            // Struct names are not mangled yet
+            mangleable = false;
+
+            for( size_t i=0; i<strct->getNumMembers(); ++i )
+                downCast( strct->getMember(i).type )->freeze();
+        }
+    };
+
+    Visitor visitor;
+    std::visit( visitor, getType() );
+
+    // The mangled name is otherwise calculated on first use, which would write to the shared type
+    if( visitor.mangleable )
+        getMangledName();
+
+    return visitor.mangleable;
+}
+
+bool StaticTypeImpl::share() const {
+    // Frozen types are shared already. A type that was already shared also stops the recursion on structs that point
+    // to themselves.
+    if( isImmortal() || shared )
+        return !mangledName.empty();
+
+    shared = true;
+
+    struct Visitor {
+        bool mangleable = true;
+
+        void operator()( const Scalar *scalar ) {
+        }
+
+        void operator()( const Function *function ) {
+            mangleable = downCast( function->getReturnType() )->share() && mangleable;
+
+            for( unsigned i=0; i<function->getNumArguments(); ++i )
+                mangleable = downCast( function->getArgumentType(i) )->share() && mangleable;
+        }
+
+        void operator()( const Pointer *pointer ) {
+            mangleable = downCast( pointer->getPointedType() )->share();
+        }
+
+        void operator()( const Array *array ) {
+            mangleable = downCast( array->getElementType() )->share();
+        }
+
+        void operator()( const Struct *strct ) {
+            // Struct names are not mangled yet
+            mangleable = false;
+
+            for( size_t i=0; i<strct->getNumMembers(); ++i )
+                downCast( strct->getMember(i).type )->share();
+        }
+    };
+
+    Visitor visitor;
+    std::visit( visitor, getType() );
+
+    // The mangled name is otherwise calculated on first use, which would write to the shared type
+    if( visitor.mangleable )
+        getMangledName();
+
+    return visitor.mangleable;
+}
+
 bool StaticTypeImpl::sizeKnown() const {
     Flags::Type flags = getFlags();
     if( (flags & Flags::Reference) != 0 )
@@ -395,9 +494,9 @@ StaticTypeImpl::StaticTypeImpl( const StaticTypeImpl &that ) :
     std::visit( Visitor{ ._this=this }, that.content );
 }
 
-StaticTypeImpl::StaticTypeImpl( ScalarTypeImpl &&scalar, ValueRangeBase::CPtr valueRange ) :
+StaticTypeImpl::StaticTypeImpl( ScalarTypeImpl &&scalar, ValueRange valueRange ) :
     content( std::unique_ptr<ScalarTypeImpl>( new ScalarTypeImpl( std::move(scalar) ) ) ),
-    valueRange(valueRange)
+    valueRange( std::move(valueRange) )
 {
 }
 
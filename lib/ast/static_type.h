@@ -10,7 +10,8 @@
 #define AST_STATIC_TYPE_H
 
 #include "ast/struct.h"
-#include "ast/value_range_base.h"
+#include "ast/statistics.h"
+#include "ast/value_range.h"
 #include "asserts.h"
 
 #include <practical/practical.h>
@@ -110,8 +111,9 @@ private:
             StructTypeImpl::Ptr,
             StructTypeImpl::CPtr
     > content;
-    ValueRangeBase::CPtr valueRange;
+    ValueRange valueRange;
     mutable std::string mangledName;
+    mutable bool shared = false;
     Flags::Type flags = 0;
 
 public:
@@ -120,6 +122,9 @@ public:
 
     template<typename... Args>
     static Ptr allocate(Args&&... args) {
+        if( Statistics *statistics = Statistics::current() )
+            ++statistics->typesAllocated;
+
         return new StaticTypeImpl( std::forward<Args>(args)... );
     }
 
@@ -136,7 +141,14 @@ public:
 
     size_t calcHashInternal(const StructTypeImpl *anchor) const;
 
-    ValueRangeBase::CPtr defaultRange() const {
+    // Makes the type, and the types it is made of, immortal, so that threads share it without touching its count. Returns
+    // whether the type has a mangled name.
+    bool freeze() const;
+    // Calculates up front what the type, and the types it is made of, otherwise calculate on first use. Lets threads
+    // share a mortal type. Returns whether the type has a mangled name.
+    bool share() const;
+
+    const ValueRange &defaultRange() const {
         return valueRange;
     }
 
@@ -171,7 +183,7 @@ private:
     // Copy
     explicit StaticTypeImpl( const StaticTypeImpl &that );
 
-    explicit StaticTypeImpl( ScalarTypeImpl &&scalar, ValueRangeBase::CPtr valueRange );
+    explicit StaticTypeImpl( ScalarTypeImpl &&scalar, ValueRange valueRange );
     explicit StaticTypeImpl( FunctionTypeImpl &&function );
     explicit StaticTypeImpl( ArrayTypeImpl &&array );
     explicit StaticTypeImpl( PointerTypeImpl &&ptr );
@@ -0,0 +1,98 @@
+/* This file is part of the Practical programming langauge. https://github.com/Practical/practical-sa
+ *
+ * To the extent header files enjoy copyright protection, this file is file is copyright (C) 2021 by its authors
+ * You can see the file's authors in the AUTHORS file in the project's home repository.
+ *
+ * This is available under the Boost license. The license's text is available under the LICENSE file in the project's
+ * home directory.
+ */
+#ifndef AST_STATISTICS_H
+#define AST_STATISTICS_H
+
+#include "parser.h"
+
+#include <practical/practical.h>
+
+#include <chrono>
+#include <cstddef>
+#include <ctime>
+
+namespace AST {
+
+// Counters describing how much work the semantic analysis did. The ones reported to the caller are in the base.
+struct Statistics : public PracticalSemanticAnalyzer::CompileStats {
+    // Candidates rejected without building their arguments, as some argument cannot be cast to the expected type
+    size_t overloadCandidatesPruned = 0;
+    // Candidates for which the full call was built
+    size_t overloadCandidatesBuilt = 0;
+    // Operators whose operands' types picked the overload without any resolution
+    size_t operatorsResolvedDirectly = 0;
+    // Conditionals whose condition VRP decided, so that only the live clause was generated
+    size_t branchesEliminated = 0;
+    // Calls to the module's functions evaluated at compile time
+    size_t callsEvaluated = 0;
+
+    // The statistics of the compilation session current on this thread. nullptr outside of a compilation, such as
+    // while preparing the builtin context.
+    static Statistics *current();
+
+    Statistics &operator+=( const Statistics &that ) {
+        CompileStats::operator+=( that );
+
+        overloadCandidatesPruned += that.overloadCandidatesPruned;
+        overloadCandidatesBuilt += that.overloadCandidatesBuilt;
+        operatorsResolvedDirectly += that.operatorsResolvedDirectly;
+        branchesEliminated += that.branchesEliminated;
+        callsEvaluated += that.callsEvaluated;
+
+        return *this;
+    }
+};
+
+// Adds the wall and CPU time from its construction to its destruction to a phase's time
+class PhaseTimer {
+    PracticalSemanticAnalyzer::CompileStats::Time &_time;
+    std::chrono::steady_clock::time_point _wallStart;
+    std::chrono::nanoseconds _cpuStart;
+
+public:
+    explicit PhaseTimer( PracticalSemanticAnalyzer::CompileStats::Time &time ) :
+        _time( time ), _wallStart( std::chrono::steady_clock::now() ), _cpuStart( threadCpuTime() )
+    {}
+
+    PhaseTimer( const PhaseTimer &that ) = delete;
+    PhaseTimer &operator=( const PhaseTimer &that ) = delete;
+
+    ~PhaseTimer() {
+        _time.wall += std::chrono::steady_clock::now() - _wallStart;
+        _time.cpu += threadCpuTime() - _cpuStart;
+    }
+
+private:
+    static std::chrono::nanoseconds threadCpuTime() {
+        timespec time;
+        clock_gettime( CLOCK_THREAD_CPUTIME_ID, &time );
+
+        return std::chrono::seconds( time.tv_sec ) + std::chrono::nanoseconds( time.tv_nsec );
+    }
+};
+
+// Adds the parser's backtracking on this thread, from its construction to its destruction, to a count
+class BacktrackCounter {
+    size_t &_count;
+    size_t _start;
+
+public:
+    explicit BacktrackCounter( size_t &count ) : _count( count ), _start( NonTerminals::numExceptionsCaught() ) {}
+
+    BacktrackCounter( const BacktrackCounter &that ) = delete;
+    BacktrackCounter &operator=( const BacktrackCounter &that ) = delete;
+
+    ~BacktrackCounter() {
+        _count += NonTerminals::numExceptionsCaught() - _start;
+    }
+};
+
+} // namespace AST
+
+#endif // AST_STATISTICS_H
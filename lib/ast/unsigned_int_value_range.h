@@ -9,8 +9,6 @@
 #ifndef AST_UNSIGNED_INT_VALUE_RANGE_H
 #define AST_UNSIGNED_INT_VALUE_RANGE_H
 
-#include "ast/value_range_base.h"
-
 #include <practical/practical.h>
 
 #include <type_traits>
@@ -18,19 +16,19 @@
 
 namespace AST {
 
-class UnsignedIntValueRange final : public ValueRangeBase {
-public:
+struct UnsignedIntValueRange {
     LongEnoughInt minimum, maximum;
 
-    bool isLiteral() const override {
-        return minimum==maximum;
-    }
+    UnsignedIntValueRange() = default;
+    UnsignedIntValueRange( LongEnoughInt minimum, LongEnoughInt maximum ) :
+        minimum(minimum), maximum(maximum)
+    {}
 
-    static boost::intrusive_ptr<UnsignedIntValueRange> allocate( LongEnoughInt min, LongEnoughInt max );
-    static boost::intrusive_ptr<UnsignedIntValueRange> allocate( const UnsignedIntValueRange *that ) {
-        return allocate( that->minimum, that->maximum );
+    bool isLiteral() const {
+        return minimum==maximum;
     }
 
+    // The range of all values T can hold
     template<
             typename T,
             std::enable_if_t<
@@ -38,8 +36,8 @@ public:
                 int
             > = 0
     >
-    static CPtr allocate() {
-        return allocate( std::numeric_limits<T>::min(), std::numeric_limits<T>::max() );
+    static UnsignedIntValueRange full() {
+        return UnsignedIntValueRange( std::numeric_limits<T>::min(), std::numeric_limits<T>::max() );
     }
 };
 
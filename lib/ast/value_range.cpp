@@ -0,0 +1,80 @@
+/* This file is part of the Practical programming langauge. https://github.com/Practical/practical-sa
+ *
+ * To the extent header files enjoy copyright protection, this file is file is copyright (C) 2021 by its authors
+ * You can see the file's authors in the AUTHORS file in the project's home repository.
+ *
+ * This is available under the Boost license. The license's text is available under the LICENSE file in the project's
+ * home directory.
+ */
+#include "ast/value_range.h"
+
+#include <algorithm>
+
+namespace AST {
+
+template<typename T>
+static ValueRange uniteInts( const T &lhs, const T &rhs ) {
+    return T( std::min( lhs.minimum, rhs.minimum ), std::max( lhs.maximum, rhs.maximum ) );
+}
+
+template<typename T>
+static ValueRange intersectInts( const T &lhs, const T &rhs ) {
+    auto minimum = std::max( lhs.minimum, rhs.minimum );
+    auto maximum = std::min( lhs.maximum, rhs.maximum );
+    if( minimum>maximum )
+        return ValueRange();
+
+    return T( minimum, maximum );
+}
+
+ValueRange ValueRange::unite( const ValueRange &other ) const {
+    if( _kind!=other._kind )
+        return ValueRange();
+
+    switch( _kind ) {
+    case Kind::Empty:
+    case Kind::Compound:
+        break;
+    case Kind::Void:
+        return *this;
+    case Kind::Bool:
+        return BoolValueRange(
+                _bool.falseAllowed || other._bool.falseAllowed, _bool.trueAllowed || other._bool.trueAllowed );
+    case Kind::UnsignedInt:
+        return uniteInts( _unsigned, other._unsigned );
+    case Kind::SignedInt:
+        return uniteInts( _signed, other._signed );
+    }
+
+    return ValueRange();
+}
+
+ValueRange ValueRange::intersect( const ValueRange &other ) const {
+    if( _kind!=other._kind )
+        return ValueRange();
+
+    switch( _kind ) {
+    case Kind::Empty:
+    case Kind::Compound:
+        break;
+    case Kind::Void:
+        return *this;
+    case Kind::Bool:
+        {
+            BoolValueRange ret(
+                    _bool.falseAllowed && other._bool.falseAllowed, _bool.trueAllowed && other._bool.trueAllowed );
+            if( !ret.falseAllowed && !ret.trueAllowed )
+                return ValueRange();
+
+            return ret;
+        }
+    case Kind::UnsignedInt:
+        return intersectInts( _unsigned, other._unsigned );
+    case Kind::SignedInt:
+        return intersectInts( _signed, other._signed );
+    }
+
+    return ValueRange();
+}
+
+} // namespace AST
@@ -0,0 +1,168 @@
+/* This file is part of the Practical programming langauge. https://github.com/Practical/practical-sa
+ *
+ * To the extent header files enjoy copyright protection, this file is file is copyright (C) 2021 by its authors
+ * You can see the file's authors in the AUTHORS file in the project's home repository.
+ *
+ * This is available under the Boost license. The license's text is available under the LICENSE file in the project's
+ * home directory.
+ */
+#ifndef AST_VALUE_RANGE_H
+#define AST_VALUE_RANGE_H
+
+#include "ast/bool_value_range.h"
+#include "ast/signed_int_value_range.h"
+#include "ast/unsigned_int_value_range.h"
+#include "ast/value_range_base.h"
+#include "ast/void_value_range.h"
+
+#include <cstdint>
+#include <utility>
+
+namespace AST {
+
+// The range of values an expression might have.
+//
+// Scalar ranges are held inline, so computing them allocates nothing. Ranges of compound types (pointers, arrays)
+// are heap allocated and shared. A default constructed ValueRange is empty, and signals an unknown or disallowed
+// range.
+class ValueRange {
+public:
+    enum class Kind : uint8_t {
+        Empty,
+        Void,
+        Bool,
+        UnsignedInt,
+        SignedInt,
+        Compound
+    };
+
+private:
+    Kind _kind = Kind::Empty;
+    // Ranges of no scalar kind keep the default member, so that the union is never left uninitialized
+    union {
+        BoolValueRange _bool;
+        UnsignedIntValueRange _unsigned = {};
+        SignedIntValueRange _signed;
+    };
+    ValueRangeBase::CPtr _compound;
+
+public:
+    ValueRange() {}
+
+    ValueRange( const ValueRange &that ) : _kind( that._kind ), _compound( that._compound ) {
+        copyScalar( that );
+    }
+
+    ValueRange( ValueRange &&that ) : _kind( that._kind ), _compound( std::move(that._compound) ) {
+        copyScalar( that );
+    }
+
+    ValueRange &operator=( const ValueRange &that ) {
+        _kind = that._kind;
+        _compound = that._compound;
+        copyScalar( that );
+
+        return *this;
+    }
+
+    ValueRange &operator=( ValueRange &&that ) {
+        _kind = that._kind;
+        _compound = std::move(that._compound);
+        copyScalar( that );
+
+        return *this;
+    }
+
+    ValueRange( const VoidValueRange & ) : _kind( Kind::Void ) {}
+    ValueRange( const BoolValueRange &range ) : _kind( Kind::Bool ), _bool( range ) {}
+    ValueRange( const UnsignedIntValueRange &range ) : _kind( Kind::UnsignedInt ), _unsigned( range ) {}
+    ValueRange( const SignedIntValueRange &range ) : _kind( Kind::SignedInt ), _signed( range ) {}
+
+    ValueRange( ValueRangeBase::CPtr range ) : _compound( std::move(range) ) {
+        if( _compound )
+            _kind = Kind::Compound;
+    }
+
+    ValueRange( const ValueRangeBase *range ) : ValueRange( ValueRangeBase::CPtr(range) ) {}
+
+    explicit operator bool() const {
+        return _kind!=Kind::Empty;
+    }
+
+    Kind getKind() const {
+        return _kind;
+    }
+
+    bool isLiteral() const {
+        switch( _kind ) {
+        case Kind::Empty:
+            break;
+        case Kind::Void:
+            return true;
+        case Kind::Bool:
+            return _bool.isLiteral();
+        case Kind::UnsignedInt:
+            return _unsigned.isLiteral();
+        case Kind::SignedInt:
+            return _signed.isLiteral();
+        case Kind::Compound:
+            return _compound->isLiteral();
+        }
+
+        ABORT()<<"isLiteral called on an empty value range";
+    }
+
+    // Compound ranges are shared by pointer. Makes them immortal, so that threads share them without touching the count.
+    void makeImmortal() const {
+        if( _compound )
+            _compound->makeImmortal();
+    }
+
+    // The smallest range holding every value of both ranges. Empty if the ranges cannot be merged.
+    ValueRange unite( const ValueRange &other ) const;
+    // The values both ranges hold. Empty if there are none, or if the ranges cannot be intersected.
+    ValueRange intersect( const ValueRange &other ) const;
+
+    template<typename T>
+    const T &get() const {
+        if constexpr( std::is_same_v<T, BoolValueRange> ) {
+            ASSERT( _kind==Kind::Bool )<<"Value range of kind "<<static_cast<int>(_kind)<<" used as bool";
+            return _bool;
+        } else if constexpr( std::is_same_v<T, UnsignedIntValueRange> ) {
+            ASSERT( _kind==Kind::UnsignedInt )<<"Value range of kind "<<static_cast<int>(_kind)<<" used as unsigned";
+            return _unsigned;
+        } else if constexpr( std::is_same_v<T, SignedIntValueRange> ) {
+            ASSERT( _kind==Kind::SignedInt )<<"Value range of kind "<<static_cast<int>(_kind)<<" used as signed";
+            return _signed;
+        } else {
+            static_assert( std::is_base_of_v< ValueRangeBase, T > );
+            ASSERT( _kind==Kind::Compound )<<"Value range of kind "<<static_cast<int>(_kind)<<" used as compound";
+
+            return *_compound->downCast<T>();
+        }
+    }
+
+private:
+    // Only the active member of the union is initialized. Copying any other would read uninitialized memory.
+    void copyScalar( const ValueRange &that ) {
+        switch( _kind ) {
+        case Kind::Empty:
+        case Kind::Void:
+        case Kind::Compound:
+            break;
+        case Kind::Bool:
+            _bool = that._bool;
+            break;
+        case Kind::UnsignedInt:
+            _unsigned = that._unsigned;
+            break;
+        case Kind::SignedInt:
+            _signed = that._signed;
+            break;
+        }
+    }
+};
+
+} // namespace AST
+
+#endif // AST_VALUE_RANGE_H
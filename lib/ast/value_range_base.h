@@ -9,17 +9,24 @@
 #ifndef AST_VALUE_RANGE_BASE_H
 #define AST_VALUE_RANGE_BASE_H
 
+#include "ast/statistics.h"
 #include "asserts.h"
 #include "nocopy.h"
 
-#include <boost/smart_ptr/intrusive_ref_counter.hpp>
+#include <practical/ref_counted.h>
+
 #include <boost/smart_ptr/intrusive_ptr.hpp>
 
 namespace AST {
 
-class ValueRangeBase : private NoCopy, public boost::intrusive_ref_counter<ValueRangeBase, boost::thread_unsafe_counter>
+class ValueRangeBase : private NoCopy, public RefCounted<ValueRangeBase>
 {
 public:
+    ValueRangeBase() {
+        if( Statistics *statistics = Statistics::current() )
+            ++statistics->valueRangesAllocated;
+    }
+
     virtual ~ValueRangeBase() {}
 
     virtual bool isLiteral() const = 0;
@@ -8,6 +8,8 @@
  */
 #include "ast/variable_definition.h"
 
+#include "ast/interpreter.h"
+
 using namespace PracticalSemanticAnalyzer;
 
 namespace AST {
@@ -45,4 +47,19 @@ void VariableDefinition::codeGen(
     }
 }
 
+bool VariableDefinition::evaluate( const LookupContext &lookupCtx, Interpreter &interpreter ) const {
+    const LookupContext::Identifier *identifier = lookupCtx.lookupIdentifier( parserVarDef.body.name.identifier->text );
+    const auto &varDef = std::get< LookupContext::Variable >(*identifier);
+
+    // An uninitialized variable is not known, and fails the evaluation once read
+    ValueRange value = varDef.type->defaultRange();
+    if( initValue ) {
+        value = initValue->evaluate(interpreter);
+        if( !value )
+            return false;
+    }
+
+    return interpreter.defineVariable( varDef.lvalueId, value );
+}
+
 } // namespace AST
@@ -9,13 +9,10 @@
 #ifndef AST_VOID_VALUE_RANGE_H
 #define AST_VOID_VALUE_RANGE_H
 
-#include "ast/value_range_base.h"
-
 namespace AST {
 
-class VoidValueRange final : public ValueRangeBase {
-public:
-    bool isLiteral() const override {
+struct VoidValueRange {
+    bool isLiteral() const {
         return true;
     }
 };
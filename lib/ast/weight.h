@@ -10,6 +10,7 @@
 #define AST_WEIGHT_H
 
 #include <iostream>
+#include <limits>
 
 namespace AST {
 
@@ -74,6 +75,16 @@ struct Weight {
         return result-=that;
     }
 
+    // The largest weight that can be added to this one without going past limit, which this one must not exceed.
+    // Unlike subtraction, this respects the length taking precedence.
+    constexpr Weight remaining( const Weight &limit ) const noexcept {
+        if( limit.weight>=weight )
+            return Weight( limit.weight - weight, limit.length - length );
+
+        // Any weight at all fits into a shorter length
+        return Weight( std::numeric_limits<unsigned>::max(), limit.length - length - 1 );
+    }
+
     static constexpr Weight max() noexcept {
         return Weight(
                 std::numeric_limits<unsigned>::max(),
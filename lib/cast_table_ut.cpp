@@ -0,0 +1,154 @@
+/* This file is part of the Practical programming langauge. https://github.com/Practical/practical-sa
+ *
+ * This file is file is copyright (C) 2021 by its authors.
+ * You can see the file's authors in the AUTHORS file in the project's home repository.
+ *
+ * This is available under the Boost license. The license's text is available under the LICENSE file in the project's
+ * home directory.
+ */
+#include "ast/ast.h"
+#include "ast/cast_chain.h"
+#include "ut/recording_gen.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// The cast table must hand out the very paths the cast search finds
+class CastTableTest : public CppUnit::TestFixture {
+    using BuiltinTypes = AST::BuiltinTypes;
+    using ExpressionMetadata = AST::ExpressionImpl::ExpressionMetadata;
+    using ValueRange = AST::ValueRange;
+    using Weight = AST::Weight;
+
+    static std::string describe( const ValueRange &range ) {
+        std::ostringstream text;
+        switch( range.getKind() ) {
+        case ValueRange::Kind::Empty:
+            text<<"empty";
+            break;
+        case ValueRange::Kind::Void:
+            text<<"void";
+            break;
+        case ValueRange::Kind::Bool:
+            text<<"bool "<<range.get<AST::BoolValueRange>().falseAllowed<<range.get<AST::BoolValueRange>().trueAllowed;
+            break;
+        case ValueRange::Kind::UnsignedInt:
+            text<<"unsigned "<<range.get<AST::UnsignedIntValueRange>().minimum<<".."<<
+                    range.get<AST::UnsignedIntValueRange>().maximum;
+            break;
+        case ValueRange::Kind::SignedInt:
+            text<<"signed "<<range.get<AST::SignedIntValueRange>().minimum<<".."<<
+                    range.get<AST::SignedIntValueRange>().maximum;
+            break;
+        case ValueRange::Kind::Compound:
+            text<<"compound";
+            break;
+        }
+
+        return text.str();
+    }
+
+    // Narrows the range down to the value 0, or to false
+    static ValueRange zeroOf( const ValueRange &range ) {
+        switch( range.getKind() ) {
+        case ValueRange::Kind::Bool:
+            return AST::BoolValueRange( true, false );
+        case ValueRange::Kind::UnsignedInt:
+            return AST::UnsignedIntValueRange( 0, 0 );
+        case ValueRange::Kind::SignedInt:
+            return AST::SignedIntValueRange( 0, 0 );
+        default:
+            return range;
+        }
+    }
+
+    // Everything the cast produces: the outcome, the weight, the code and the resulting range
+    static std::string castResult(
+            bool search, BuiltinTypes::Id source, BuiltinTypes::Id destination, const ValueRange &sourceRange,
+            Weight weightLimit )
+    {
+        // A session of its own, so that both casts get the same ids
+        AST::CompilationSession session;
+        AST::CompilationSession::Scope scope{ session };
+
+        const BuiltinTypes &builtinTypes = AST::AST::getBuiltinTypes();
+        ExpressionMetadata srcMetadata{ .type = builtinTypes.get( source ), .valueRange = sourceRange };
+
+        AST::Arena::Ptr<AST::CastChain> chain;
+        Weight weight( 2, 1 );
+        AST::BuildResult result = ( search ? AST::CastChain::searchAllocate : AST::CastChain::allocate )(
+                chain, AST::AST::getBuiltinCtx(), builtinTypes.get( destination ), srcMetadata, weight, weightLimit,
+                true, SourceLocation() );
+
+        std::ostringstream text;
+        text<<static_cast<int>( result.getStatus() );
+        if( !result )
+            return text.str();
+
+        text<<" weight "<<weight.weight<<" length "<<weight.length<<" range "<<
+                describe( chain->getMetadata().valueRange )<<"\n";
+
+        UT::RecordingFunctionGen functionGen;
+        chain->codeGen( srcMetadata.type, PracticalSemanticAnalyzer::ExpressionId( 1 ), &functionGen );
+        text<<functionGen.getText();
+
+        return text.str();
+    }
+
+    void allPairsTest() {
+        UT::prepare();
+
+        const BuiltinTypes &builtinTypes = AST::AST::getBuiltinTypes();
+        const Weight weightLimits[] = {
+            Weight::max(), Weight( std::numeric_limits<unsigned>::max(), 2 ), Weight( 2, 3 ) };
+
+        size_t numSucceeded = 0;
+        for( size_t source=0; source<BuiltinTypes::NumIds; ++source ) {
+            auto sourceId = static_cast<BuiltinTypes::Id>(source);
+            const ValueRange &defaultRange = builtinTypes.get( sourceId )->defaultRange();
+            const ValueRange sourceRanges[] = { defaultRange, zeroOf( defaultRange ) };
+
+            for( size_t destination=0; destination<BuiltinTypes::NumIds; ++destination ) {
+                if( source==destination )
+                    continue;
+
+                auto destinationId = static_cast<BuiltinTypes::Id>(destination);
+                for( const ValueRange &sourceRange : sourceRanges ) {
+                    for( Weight weightLimit : weightLimits ) {
+                        // Named, so that a failure says which cast it was
+                        std::ostringstream cast;
+                        cast<<builtinTypes.get( sourceId )<<" -> "<<builtinTypes.get( destinationId )<<" from "<<
+                                describe( sourceRange )<<" up to length "<<weightLimit.length<<": ";
+
+                        std::string expected = castResult( true, sourceId, destinationId, sourceRange, weightLimit );
+                        CPPUNIT_ASSERT_EQUAL(
+                                cast.str() + expected,
+                                cast.str() + castResult( false, sourceId, destinationId, sourceRange, weightLimit ) );
+
+                        if( expected[0]=='0' )
+                            ++numSucceeded;
+                    }
+                }
+            }
+        }
+
+        // Make sure the comparisons covered actual paths
+        CPPUNIT_ASSERT( numSucceeded>0 );
+    }
+
+public:
+    static CppUnit::Test *suite()
+    {
+        CppUnit::TestSuite *suiteOfTests = new CppUnit::TestSuite( "CastTableTest" );
+        suiteOfTests->addTest( new CppUnit::TestCaller<CastTableTest>(
+                    "allPairsTest",
+                    &CastTableTest::allPairsTest ) );
+        return suiteOfTests;
+    }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( CastTableTest );
@@ -0,0 +1,291 @@
+/* This file is part of the Practical programming langauge. https://github.com/Practical/practical-sa
+ *
+ * This file is file is copyright (C) 2021 by its authors.
+ * You can see the file's authors in the AUTHORS file in the project's home repository.
+ *
+ * This is available under the Boost license. The license's text is available under the LICENSE file in the project's
+ * home directory.
+ */
+#include "ut/recording_gen.h"
+
+#include <practical/errors.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <fstream>
+#include <regex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+
+// The ways of compiling a module must all hand the backend the same thing
+class CompileTest : public CppUnit::TestFixture {
+    using CompilerArguments = PracticalSemanticAnalyzer::CompilerArguments;
+
+    static std::string testPath( const char *name ) {
+        const char *basePath = getenv("TOP_DIR");
+        std::string path;
+        if( basePath!=nullptr ) {
+            path = basePath;
+            path += '/';
+        }
+        path += "tests/compile/";
+        path += name;
+
+        return path;
+    }
+
+    static std::string readFile( const std::string &path ) {
+        std::ifstream file( path );
+        CPPUNIT_ASSERT( file );
+
+        std::ostringstream content;
+        content<<file.rdbuf();
+
+        return content.str();
+    }
+
+    // Compiles source, and returns what the backend got. With sorted, the functions are sorted rather than in the
+    // order they were handed out.
+    static std::string compile( const std::string &source, const CompilerArguments &arguments, bool sorted = false ) {
+        UT::prepare();
+
+        UT::RecordingModuleGen moduleGen;
+        PracticalSemanticAnalyzer::compile( String(source), "functions.pr", &arguments, &moduleGen );
+
+        return sorted ? moduleGen.getSortedText() : moduleGen.getText();
+    }
+
+    static const std::regex &idPattern() {
+        static const std::regex pattern( "(ExpressionId|JumpPointId)\\(([0-9]+)\\)" );
+
+        return pattern;
+    }
+
+    // Renumbers the ids of each function in the order they first show up in it. Functions generated in no particular
+    // order get their ids in no particular order, but must otherwise be the same.
+    static std::string renumberIds( const std::string &text ) {
+        std::istringstream lines( text );
+        std::ostringstream result;
+        std::unordered_map<std::string, std::string> ids;
+
+        std::string line;
+        while( std::getline( lines, line ) ) {
+            if( line.compare( 0, 9, "function " )==0 )
+                ids.clear();
+
+            auto last = line.cbegin();
+            for( std::sregex_iterator match( line.begin(), line.end(), idPattern() ), end; match!=end; ++match ) {
+                result<<std::string( last, (*match)[0].first );
+                auto mapped = ids.try_emplace( (*match)[0].str(), "" );
+                if( mapped.second )
+                    mapped.first->second = (*match)[1].str() + "(" + std::to_string( ids.size() ) + ")";
+                result<<mapped.first->second;
+                last = (*match)[0].second;
+            }
+            result<<std::string( last, line.cend() )<<"\n";
+        }
+
+        return result.str();
+    }
+
+    // The distinct values of the ids of the given kind in text
+    static std::set<unsigned long> collectIds( const std::string &text, const std::string &kind ) {
+        std::set<unsigned long> values;
+        for( std::sregex_iterator match( text.begin(), text.end(), idPattern() ), end; match!=end; ++match ) {
+            if( (*match)[1].str()==kind )
+                values.insert( std::stoul( (*match)[2].str() ) );
+        }
+
+        return values;
+    }
+
+    void modesTest() {
+        std::string source = readFile( testPath( "functions.pr" ) );
+
+        CompilerArguments sequential;
+        std::string expected = compile( source, sequential );
+        CPPUNIT_ASSERT( !expected.empty() );
+
+        CompilerArguments parallel;
+        parallel.numThreads = 4;
+        CPPUNIT_ASSERT_EQUAL( expected, compile( source, parallel ) );
+
+        CompilerArguments pipelined;
+        pipelined.numThreads = 4;
+        pipelined.pipelined = true;
+        CPPUNIT_ASSERT_EQUAL( expected, compile( source, pipelined ) );
+
+        CompilerArguments streaming;
+        streaming.streaming = true;
+        CPPUNIT_ASSERT_EQUAL( expected, compile( source, streaming ) );
+
+        // The functions may come in any order, and so may the ids they get, but each one must otherwise be the same
+        CompilerArguments nonDeterministic;
+        nonDeterministic.numThreads = 4;
+        nonDeterministic.deterministic = false;
+        CPPUNIT_ASSERT_EQUAL(
+                renumberIds( compile( source, sequential, true ) ),
+                renumberIds( compile( source, nonDeterministic, true ) ) );
+    }
+
+    // Functions handed out in order get the ids the sequential compilation would, with none skipped
+    void denseIdsTest() {
+        std::string source = readFile( testPath( "functions.pr" ) );
+
+        CompilerArguments sequential;
+        std::string expected = compile( source, sequential );
+
+        CompilerArguments parallel;
+        parallel.numThreads = 4;
+        CPPUNIT_ASSERT_EQUAL( expected, compile( source, parallel ) );
+
+        for( const char *kind : { "ExpressionId", "JumpPointId" } ) {
+            std::set<unsigned long> values = collectIds( expected, kind );
+            CPPUNIT_ASSERT( !values.empty() );
+            CPPUNIT_ASSERT_EQUAL( 1ul, *values.begin() );
+            CPPUNIT_ASSERT_EQUAL( static_cast<unsigned long>( values.size() ), *values.rbegin() );
+        }
+    }
+
+    // The counts describe the module, and must not depend on how it was compiled
+    void statsTest() {
+        std::string source = readFile( testPath( "functions.pr" ) );
+
+        PracticalSemanticAnalyzer::CompileStats expected;
+        CompilerArguments sequential;
+        sequential.stats = &expected;
+        compile( source, sequential );
+        CPPUNIT_ASSERT( expected.tokens!=0 );
+
+        CompilerArguments modes[4];
+        modes[0].numThreads = 4;
+        modes[1].pipelined = true;
+        // Streaming rebuilds the functions it evaluates calls to
+        modes[2].streaming = true;
+        modes[3].streaming = true;
+        modes[3].pipelined = true;
+
+        for( CompilerArguments &arguments : modes ) {
+            PracticalSemanticAnalyzer::CompileStats stats;
+            arguments.stats = &stats;
+            compile( source, arguments );
+
+            CPPUNIT_ASSERT_EQUAL( expected.tokens, stats.tokens );
+            CPPUNIT_ASSERT_EQUAL( expected.astNodes, stats.astNodes );
+            CPPUNIT_ASSERT_EQUAL( expected.parserBacktracks, stats.parserBacktracks );
+        }
+    }
+
+    static std::string errorOf( const std::string &source, const CompilerArguments &arguments ) {
+        try {
+            compile( source, arguments );
+        } catch( PracticalSemanticAnalyzer::compile_error &error ) {
+            return error.what();
+        }
+
+        CPPUNIT_ASSERT( false );
+        return std::string();
+    }
+
+    // The pipelined tokenizer and parser find errors in a different order. They must still be the sequential ones.
+    void pipelinedErrorsTest() {
+        CompilerArguments sequential;
+        CompilerArguments pipelined;
+        pipelined.pipelined = true;
+
+        const char *sources[] = {
+            // Tokenizer error after a parser error
+            "def f( -> U32 { 1 }\ndef g() -> U32 { 2 }\ndef h() -> U32 { \"unterminated }\n",
+            // Parser error after an error registering a symbol
+            "struct S { def x : U8; }\nstruct S { def y : U8; }\ndef f( -> U32 { 1 }\n",
+            "struct S { def x : U8; }\nstruct S { def y : U8; }\ndef f() -> U32 { 1 }\n",
+        };
+
+        for( const char *source : sources ) {
+            std::string expected = errorOf( source, sequential );
+            CPPUNIT_ASSERT_EQUAL( expected, errorOf( source, pipelined ) );
+        }
+    }
+
+    void memoryLimitTest() {
+        std::string source = readFile( testPath( "functions.pr" ) );
+
+        for( bool pipelined : { false, true } ) {
+            for( bool streaming : { false, true } ) {
+                CompilerArguments arguments;
+                arguments.pipelined = pipelined;
+                arguments.streaming = streaming;
+
+                arguments.memoryLimit = 1;
+                CPPUNIT_ASSERT_THROW( compile( source, arguments ), PracticalSemanticAnalyzer::MemoryLimitExceeded );
+
+                arguments.memoryLimit = 64*1024*1024;
+                CPPUNIT_ASSERT( !compile( source, arguments ).empty() );
+            }
+        }
+    }
+
+    void compileManyTest() {
+        UT::prepare();
+
+        std::string expected = compile( readFile( testPath( "functions.pr" ) ), CompilerArguments() );
+
+        UT::RecordingModuleGen goodGen, errorGen, missingGen, goodGen2;
+        const PracticalSemanticAnalyzer::CompileJob jobs[] = {
+            { .path = testPath( "functions.pr" ), .codeGen = &goodGen },
+            { .path = testPath( "error.pr" ), .codeGen = &errorGen },
+            { .path = testPath( "no_such_file.pr" ), .codeGen = &missingGen },
+            { .path = testPath( "functions.pr" ), .codeGen = &goodGen2 },
+        };
+
+        CompilerArguments arguments;
+        arguments.numThreads = 2;
+        std::vector<PracticalSemanticAnalyzer::CompileJobResult> results =
+                PracticalSemanticAnalyzer::compileMany( Slice<const PracticalSemanticAnalyzer::CompileJob>( jobs, 4 ),
+                        &arguments );
+
+        // The failures are reported per job, and do not affect the other jobs
+        CPPUNIT_ASSERT_EQUAL( size_t(4), results.size() );
+        CPPUNIT_ASSERT( results[0].succeeded );
+        CPPUNIT_ASSERT( results[0].error.empty() );
+        CPPUNIT_ASSERT( !results[1].succeeded );
+        CPPUNIT_ASSERT( results[1].error.find( "undefined" )!=std::string::npos );
+        CPPUNIT_ASSERT( !results[2].succeeded );
+        CPPUNIT_ASSERT( !results[2].error.empty() );
+        CPPUNIT_ASSERT( results[3].succeeded );
+
+        // Only the module's name differs from compiling the source directly
+        std::string text = goodGen.getText();
+        CPPUNIT_ASSERT_EQUAL( expected.substr( expected.find( "function " ) ), text.substr( text.find( "function " ) ) );
+        CPPUNIT_ASSERT_EQUAL( text, goodGen2.getText() );
+    }
+
+public:
+    static CppUnit::Test *suite()
+    {
+        CppUnit::TestSuite *suiteOfTests = new CppUnit::TestSuite( "CompileTest" );
+        suiteOfTests->addTest( new CppUnit::TestCaller<CompileTest>(
+                    "modesTest",
+                    &CompileTest::modesTest ) );
+        suiteOfTests->addTest( new CppUnit::TestCaller<CompileTest>(
+                    "denseIdsTest",
+                    &CompileTest::denseIdsTest ) );
+        suiteOfTests->addTest( new CppUnit::TestCaller<CompileTest>(
+                    "statsTest",
+                    &CompileTest::statsTest ) );
+        suiteOfTests->addTest( new CppUnit::TestCaller<CompileTest>(
+                    "pipelinedErrorsTest",
+                    &CompileTest::pipelinedErrorsTest ) );
+        suiteOfTests->addTest( new CppUnit::TestCaller<CompileTest>(
+                    "memoryLimitTest",
+                    &CompileTest::memoryLimitTest ) );
+        suiteOfTests->addTest( new CppUnit::TestCaller<CompileTest>(
+                    "compileManyTest",
+                    &CompileTest::compileManyTest ) );
+        return suiteOfTests;
+    }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( CompileTest );
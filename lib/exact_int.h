@@ -13,6 +13,7 @@
 
 #include <cstdint>
 #include <iostream>
+#include <optional>
 #include <variant>
 
 // An integer type that can hold the whole range of 128 bits, both signed and unsigned
@@ -95,13 +96,134 @@ public:
     Type getType() const {
         return type;
     }
+
+    // Checked arithmetic. Returns an empty optional if the result cannot be represented.
+    //
+    // The result is unsigned if both operands are unsigned or if it doesn't fit in the signed type.
+    std::optional<ExactInt> checkedAdd(const ExactInt &that) const {
+        bool preferUnsigned = type==Type::UNSIGNED && that.type==Type::UNSIGNED;
+
+        if( negative()==that.negative() ) {
+            Tu resultMagnitude;
+            if( __builtin_add_overflow( magnitude(), that.magnitude(), &resultMagnitude ) )
+                return std::nullopt;
+
+            return fromSignMagnitude( negative(), resultMagnitude, preferUnsigned );
+        }
+
+        // Different signs: the result takes the sign of the operand with the bigger magnitude
+        if( magnitude()>=that.magnitude() )
+            return fromSignMagnitude( negative(), magnitude() - that.magnitude(), preferUnsigned );
+
+        return fromSignMagnitude( that.negative(), that.magnitude() - magnitude(), preferUnsigned );
+    }
+
+    std::optional<ExactInt> checkedSub(const ExactInt &that) const {
+        bool preferUnsigned = type==Type::UNSIGNED && that.type==Type::UNSIGNED;
+
+        // Different signs: the magnitudes add up, and the result takes this one's sign
+        if( negative()!=that.negative() ) {
+            Tu resultMagnitude;
+            if( __builtin_add_overflow( magnitude(), that.magnitude(), &resultMagnitude ) )
+                return std::nullopt;
+
+            return fromSignMagnitude( negative(), resultMagnitude, preferUnsigned );
+        }
+
+        // Same signs: the result takes this one's sign, unless that one has the bigger magnitude
+        if( magnitude()>=that.magnitude() )
+            return fromSignMagnitude( negative(), magnitude() - that.magnitude(), preferUnsigned );
+
+        return fromSignMagnitude( !negative(), that.magnitude() - magnitude(), preferUnsigned );
+    }
+
+    std::optional<ExactInt> checkedMul(const ExactInt &that) const {
+        Tu resultMagnitude;
+        if( __builtin_mul_overflow( magnitude(), that.magnitude(), &resultMagnitude ) )
+            return std::nullopt;
+
+        return fromSignMagnitude(
+                negative()!=that.negative(), resultMagnitude, type==Type::UNSIGNED && that.type==Type::UNSIGNED );
+    }
+
+    // Rounds towards zero, like C++ does. Division by zero fails.
+    std::optional<ExactInt> checkedDiv(const ExactInt &that) const {
+        if( that.magnitude()==0 )
+            return std::nullopt;
+
+        return fromSignMagnitude(
+                negative()!=that.negative(), magnitude() / that.magnitude(),
+                type==Type::UNSIGNED && that.type==Type::UNSIGNED );
+    }
+
+    // Multiplies by 2^bits
+    std::optional<ExactInt> checkedShiftLeft(unsigned bits) const {
+        if( magnitude()==0 )
+            return *this;
+
+        if( bits>=128 || (magnitude() >> (127 - bits)) > 1 )
+            return std::nullopt;
+
+        return fromSignMagnitude( negative(), magnitude() << bits, type==Type::UNSIGNED );
+    }
+
+    // Divides by 2^bits, rounding towards negative infinity (i.e. - an arithmetic shift)
+    ExactInt shiftRight(unsigned bits) const {
+        if( bits>=128 )
+            return ExactInt( negative() ? Ts(-1) : Ts(0) );
+
+        if( type==Type::UNSIGNED )
+            return ExactInt( u >> bits );
+
+        return ExactInt( s >> bits );
+    }
+
+    // The mathematical floor of this/that. Division by zero fails.
+    std::optional<ExactInt> checkedFloorDiv(const ExactInt &that) const {
+        std::optional<ExactInt> quotient = checkedDiv( that );
+        if( !quotient || negative()==that.negative() || magnitude() % that.magnitude() == 0 )
+            return quotient;
+
+        return quotient->checkedSub( ExactInt( Ts(1) ) );
+    }
+
 private:
     bool nonNegative() const {
         return type==Type::UNSIGNED || s>=0;
     }
+
+    bool negative() const {
+        return !nonNegative();
+    }
+
+    // Absolute value. Well defined even for the smallest signed value.
+    Tu magnitude() const {
+        if( nonNegative() )
+            return u;
+
+        return Tu(0) - u;
+    }
+
+    static std::optional<ExactInt> fromSignMagnitude(bool negative, Tu magnitude, bool preferUnsigned) {
+        static constexpr Tu SignedMax = ~Tu(0) >> 1;
+
+        if( negative && magnitude!=0 ) {
+            if( magnitude>SignedMax+1 )
+                return std::nullopt;
+
+            ExactInt ret( Ts(0) );
+            ret.u = Tu(0) - magnitude;
+            return ret;
+        }
+
+        if( preferUnsigned || magnitude>SignedMax )
+            return ExactInt( magnitude );
+
+        return ExactInt( Ts(magnitude) );
+    }
 };
 
-std::ostream &operator<<(std::ostream &out, unsigned __int128 val) {
+inline std::ostream &operator<<(std::ostream &out, unsigned __int128 val) {
     char output[50];
     int i=0;
 
@@ -120,7 +242,7 @@ std::ostream &operator<<(std::ostream &out, unsigned __int128 val) {
     return out;
 }
 
-std::ostream &operator<<(std::ostream &out, signed __int128 val) {
+inline std::ostream &operator<<(std::ostream &out, signed __int128 val) {
     if( val<0 ) {
         val = -val;
         out<<'-';
@@ -129,7 +251,7 @@ std::ostream &operator<<(std::ostream &out, signed __int128 val) {
     return out<<static_cast<unsigned __int128>(val);
 }
 
-std::ostream &operator<<(std::ostream &out, ExactInt i) {
+inline std::ostream &operator<<(std::ostream &out, ExactInt i) {
     switch( i.getType() ) {
     case ExactInt::Type::SIGNED:
         out<<i.getSigned();
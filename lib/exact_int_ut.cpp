@@ -24,6 +24,88 @@ class ExactIntTest : public CppUnit::TestFixture {
         CPPUNIT_ASSERT( high>low );
     }
 
+    void checkedArithmeticTest() {
+        ExactInt u64Max( UINT64_MAX ), s64Min( INT64_MIN );
+
+        // 64 bit operands never overflow
+        CPPUNIT_ASSERT( *u64Max.checkedAdd( u64Max ) > u64Max );
+        CPPUNIT_ASSERT( *u64Max.checkedMul( u64Max ) > *u64Max.checkedAdd( u64Max ) );
+        CPPUNIT_ASSERT( *s64Min.checkedMul( s64Min ) > u64Max );
+        CPPUNIT_ASSERT( *s64Min.checkedSub( u64Max ) < s64Min );
+        CPPUNIT_ASSERT( *ExactInt( 0u ).checkedSub( 1u ) == ExactInt( -1 ) );
+
+        CPPUNIT_ASSERT( *ExactInt( -7 ).checkedDiv( 2 ) == ExactInt( -3 ) );
+        CPPUNIT_ASSERT( *ExactInt( -7 ).checkedFloorDiv( 2 ) == ExactInt( -4 ) );
+        CPPUNIT_ASSERT( !ExactInt( 7 ).checkedDiv( 0 ) );
+        CPPUNIT_ASSERT( ExactInt( -7 ).shiftRight( 1 ) == ExactInt( -4 ) );
+
+        // 128 bit overflows are detected
+        unsigned __int128 rawMax = ~(unsigned __int128)0;
+        ExactInt max( rawMax ), min( -static_cast<signed __int128>( rawMax >> 1 ) - 1 );
+        CPPUNIT_ASSERT( !max.checkedAdd( 1u ) );
+        CPPUNIT_ASSERT( !min.checkedSub( 1 ) );
+        CPPUNIT_ASSERT( !min.checkedMul( 2 ) );
+        CPPUNIT_ASSERT( !max.checkedMul( -1 ) );
+        CPPUNIT_ASSERT( min.checkedMul( -1 )->getType()==ExactInt::Type::UNSIGNED );
+        CPPUNIT_ASSERT( *min.checkedMul( 1 ) == min );
+        CPPUNIT_ASSERT( !ExactInt( 1u ).checkedShiftLeft( 128 ) );
+
+        std::optional<ExactInt> result = max.checkedSub( rawMax >> 1 );
+        CPPUNIT_ASSERT( result.has_value() );
+        CPPUNIT_ASSERT( *ExactInt( 1u ).checkedShiftLeft( 127 ) == *result );
+    }
+
+    // Subtraction at the edges of the unsigned and signed ranges
+    void checkedSubTest() {
+        unsigned __int128 rawMax = ~(unsigned __int128)0;
+        ExactInt max( rawMax ), smax( static_cast<signed __int128>( rawMax >> 1 ) ), min( -smax.getSigned() - 1 );
+        ExactInt zero( 0 ), uzero( 0u );
+
+        std::optional<ExactInt> result = max.checkedSub( max );
+        CPPUNIT_ASSERT( result.has_value() );
+        CPPUNIT_ASSERT( *result == zero );
+        CPPUNIT_ASSERT( result->getType()==ExactInt::Type::UNSIGNED );
+
+        result = min.checkedSub( min );
+        CPPUNIT_ASSERT( result.has_value() );
+        CPPUNIT_ASSERT( *result == zero );
+
+        result = smax.checkedSub( smax );
+        CPPUNIT_ASSERT( result.has_value() );
+        CPPUNIT_ASSERT( *result == zero );
+
+        // The whole unsigned range, from the bottom of the signed one
+        result = smax.checkedSub( min );
+        CPPUNIT_ASSERT( result.has_value() );
+        CPPUNIT_ASSERT( *result == max );
+
+        result = zero.checkedSub( min );
+        CPPUNIT_ASSERT( result.has_value() );
+        CPPUNIT_ASSERT( *result == *smax.checkedAdd( 1 ) );
+
+        result = min.checkedSub( -1 );
+        CPPUNIT_ASSERT( result.has_value() );
+        CPPUNIT_ASSERT( *result == *min.checkedAdd( 1 ) );
+
+        result = uzero.checkedSub( smax );
+        CPPUNIT_ASSERT( result.has_value() );
+        CPPUNIT_ASSERT( *result == *min.checkedAdd( 1 ) );
+
+        result = max.checkedSub( smax );
+        CPPUNIT_ASSERT( result.has_value() );
+        CPPUNIT_ASSERT( *result == *smax.checkedAdd( 1 ) );
+
+        // Results below the signed range
+        CPPUNIT_ASSERT( !uzero.checkedSub( max ) );
+        CPPUNIT_ASSERT( !min.checkedSub( smax ) );
+        CPPUNIT_ASSERT( !min.checkedSub( max ) );
+        CPPUNIT_ASSERT( !ExactInt( -1 ).checkedSub( max ) );
+
+        // Results above the unsigned range
+        CPPUNIT_ASSERT( !max.checkedSub( min ) );
+        CPPUNIT_ASSERT( !max.checkedSub( -1 ) );
+    }
+
 public:
     static CppUnit::Test *suite()
     {
@@ -31,6 +113,12 @@ public:
         suiteOfTests->addTest( new CppUnit::TestCaller<ExactIntTest>(
                     "basicTest",
                     &ExactIntTest::basicTest ) );
+        suiteOfTests->addTest( new CppUnit::TestCaller<ExactIntTest>(
+                    "checkedArithmeticTest",
+                    &ExactIntTest::checkedArithmeticTest ) );
+        suiteOfTests->addTest( new CppUnit::TestCaller<ExactIntTest>(
+                    "checkedSubTest",
+                    &ExactIntTest::checkedSubTest ) );
         return suiteOfTests;
     }
 };
@@ -0,0 +1,148 @@
+/* This file is part of the Practical programming langauge. https://github.com/Practical/practical-sa
+ *
+ * This file is file is copyright (C) 2021 by its authors.
+ * You can see the file's authors in the AUTHORS file in the project's home repository.
+ *
+ * This is available under the Boost license. The license's text is available under the LICENSE file in the project's
+ * home directory.
+ */
+#include "ast/ast.h"
+#include "ast/expression.h"
+#include "parser.h"
+#include "tokenizer.h"
+#include "ut/recording_gen.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <limits>
+#include <string>
+#include <vector>
+
+class ExpressionMemoTest : public CppUnit::TestFixture {
+    struct BuildStats {
+        size_t builds, hits;
+    };
+
+    // A lookup context with f overloaded as (U32, U8)->U32 and (U32, U16)->U32, and a U32 variable a
+    struct Context {
+        AST::CompilationSession session;
+        AST::CompilationSession::Scope scope{ session };
+        std::vector<Tokenizer::Token> declarationSource = Tokenizer::Tokenizer::tokenize( "f f a" );
+        AST::LookupContext lookupContext{ &AST::AST::getBuiltinCtx() };
+
+        Context() {
+            const AST::BuiltinTypes &builtinTypes = AST::AST::getBuiltinTypes();
+            const AST::StaticTypeImpl::CPtr &u32 = builtinTypes.get( AST::BuiltinTypes::Id::U32 );
+
+            std::vector<const Tokenizer::Token *> declarationTokens;
+            for( const auto &token : declarationSource ) {
+                if( token.token==Tokenizer::Tokens::IDENTIFIER )
+                    declarationTokens.emplace_back( &token );
+            }
+
+            for( size_t i=0; i<2; ++i ) {
+                auto overloadType = AST::StaticTypeImpl::allocate( AST::FunctionTypeImpl( AST::StaticTypeImpl::CPtr(u32), {
+                            u32, builtinTypes.get( i==0 ? AST::BuiltinTypes::Id::U8 : AST::BuiltinTypes::Id::U16 ) } ) );
+
+                lookupContext.addFunctionDeclarationPass1( declarationTokens[i] );
+                lookupContext.addFunctionDeclarationPass2( declarationTokens[i], overloadType );
+            }
+            lookupContext.addLocalVar( declarationTokens[2], u32, AST::ExpressionImpl::Base::allocateId() );
+        }
+    };
+
+    static AST::StaticTypeImpl::CPtr u32() {
+        return AST::AST::getBuiltinTypes().get( AST::BuiltinTypes::Id::U32 );
+    }
+
+    // Type "f(f(...f(a, 1)..., 1), 1)", nested depth times. Both candidates want the inner call as a U32, so without
+    // reuse every level doubles the work.
+    static BuildStats typeNestedCalls( size_t depth ) {
+        UT::prepare();
+        Context context;
+
+        std::string source = "a";
+        for( size_t i=0; i<depth; ++i )
+            source = "f(" + source + ", 1)";
+
+        auto tokens = Tokenizer::Tokenizer::tokenize( source );
+        NonTerminals::Expression parserExpression;
+        parserExpression.parse( tokens );
+
+        AST::Expression expression( parserExpression );
+        AST::Weight weight;
+        expression.buildAST( context.lookupContext, u32(), weight, AST::ExpressionImpl::Base::NoWeightLimit );
+
+        const AST::ExpressionMemo &memo = context.lookupContext.getExpressionMemo();
+        return BuildStats{ .builds = memo.numBuilds(), .hits = memo.numHits() };
+    }
+
+    void linearGrowthTest() {
+        BuildStats stats[4];
+        for( size_t i=0; i<4; ++i )
+            stats[i] = typeNestedCalls( 4 * (i+1) );
+
+        // Each additional nesting level adds the same amount of work
+        size_t buildsPerStep = stats[1].builds - stats[0].builds;
+        for( size_t i=2; i<4; ++i ) {
+            CPPUNIT_ASSERT_EQUAL( buildsPerStep, stats[i].builds - stats[i-1].builds );
+        }
+
+        CPPUNIT_ASSERT( stats[0].hits>0 );
+    }
+
+    // A reused build must still fit the weight limit of the build reusing it
+    void weightLimitTest() {
+        UT::prepare();
+        Context context;
+
+        auto tokens = Tokenizer::Tokenizer::tokenize( "f(a, 1)" );
+        NonTerminals::Expression parserExpression;
+        parserExpression.parse( tokens );
+
+        AST::Expression first( parserExpression );
+        AST::Weight firstWeight;
+        first.buildAST( context.lookupContext, u32(), firstWeight, AST::ExpressionImpl::Base::NoWeightLimit );
+        CPPUNIT_ASSERT( AST::Weight()<firstWeight );
+
+        const AST::ExpressionMemo &memo = context.lookupContext.getExpressionMemo();
+        size_t hits = memo.numHits();
+
+        AST::Expression cheap( parserExpression );
+        AST::Weight weight;
+        AST::BuildResult result = cheap.tryBuildAST( context.lookupContext, u32(), weight, AST::Weight() );
+        CPPUNIT_ASSERT( result.getStatus()==AST::BuildResult::Status::TooExpensive );
+        CPPUNIT_ASSERT_EQUAL( hits+1, memo.numHits() );
+
+        // The limit counts the weight accumulated before the expression, length first
+        AST::Weight before( 5, 0 );
+        CPPUNIT_ASSERT( before.remaining( AST::Weight( 7, 2 ) )==AST::Weight( 2, 2 ) );
+        CPPUNIT_ASSERT( before.remaining( AST::Weight( 0, 2 ) )==AST::Weight( std::numeric_limits<unsigned>::max(), 1 ) );
+
+        AST::Expression tooLong( parserExpression );
+        weight = before;
+        result = tooLong.tryBuildAST( context.lookupContext, u32(), weight, AST::Weight( 0, firstWeight.length ) );
+        CPPUNIT_ASSERT( result.getStatus()==AST::BuildResult::Status::TooExpensive );
+
+        AST::Expression shorter( parserExpression );
+        weight = before;
+        CPPUNIT_ASSERT( shorter.tryBuildAST(
+                    context.lookupContext, u32(), weight, AST::Weight( 0, firstWeight.length + 1 ) ) );
+        CPPUNIT_ASSERT( weight==before + firstWeight );
+    }
+
+public:
+    static CppUnit::Test *suite()
+    {
+        CppUnit::TestSuite *suiteOfTests = new CppUnit::TestSuite( "ExpressionMemoTest" );
+        suiteOfTests->addTest( new CppUnit::TestCaller<ExpressionMemoTest>(
+                    "linearGrowthTest",
+                    &ExpressionMemoTest::linearGrowthTest ) );
+        suiteOfTests->addTest( new CppUnit::TestCaller<ExpressionMemoTest>(
+                    "weightLimitTest",
+                    &ExpressionMemoTest::weightLimitTest ) );
+        return suiteOfTests;
+    }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( ExpressionMemoTest );
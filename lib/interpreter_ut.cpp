@@ -0,0 +1,101 @@
+/* This file is part of the Practical programming langauge. https://github.com/Practical/practical-sa
+ *
+ * This file is file is copyright (C) 2021 by its authors.
+ * You can see the file's authors in the AUTHORS file in the project's home repository.
+ *
+ * This is available under the Boost license. The license's text is available under the LICENSE file in the project's
+ * home directory.
+ */
+#include "ast/interpreter.h"
+#include "ut/recording_gen.h"
+
+#include <practical/errors.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <string>
+
+class InterpreterTest : public CppUnit::TestFixture {
+    static bool contains( const std::string &text, const std::string &fragment ) {
+        return text.find( fragment )!=std::string::npos;
+    }
+
+    static constexpr const char *squareSource = "def sq(a : U32) -> U32 { a * a }\n";
+
+    void foldCallTest() {
+        std::string text = UT::compileToText( std::string(squareSource) + "def f() -> U32 { sq(3) }" );
+        CPPUNIT_ASSERT( !contains( text, "= call " ) );
+        CPPUNIT_ASSERT( contains( text, "= 9 : U32" ) );
+
+        // Operators over evaluated calls fold as well
+        text = UT::compileToText( std::string(squareSource) + "def f() -> U32 { sq(3) + sq(4) }" );
+        CPPUNIT_ASSERT( !contains( text, "= call " ) );
+        CPPUNIT_ASSERT( !contains( text, "binaryOperatorPlusUnsigned" ) );
+        CPPUNIT_ASSERT( contains( text, "= 25 : U32" ) );
+
+        // Arguments VRP doesn't know leave the call alone
+        text = UT::compileToText( std::string(squareSource) + "def f(x : U32) -> U32 { sq(x) }" );
+        CPPUNIT_ASSERT( contains( text, "= call " ) );
+    }
+
+    void definitionOrderTest() {
+        // An evaluated result is only used for folding. Narrowing it implicitly is an error no matter where the callee
+        // is defined.
+        const char *use = "def main() -> S32 { def x : U8 = sq( 3 ); 0 }\n";
+
+        CPPUNIT_ASSERT_THROW(
+                UT::compileToText( std::string(squareSource) + use ), PracticalSemanticAnalyzer::compile_error );
+        CPPUNIT_ASSERT_THROW(
+                UT::compileToText( use + std::string(squareSource) ), PracticalSemanticAnalyzer::compile_error );
+
+        // Only calls to functions defined earlier are evaluated, so that the result doesn't depend on the threads
+        std::string text = UT::compileToText( "def f() -> U32 { sq(3) }\n" + std::string(squareSource) );
+        CPPUNIT_ASSERT( contains( text, "= call " ) );
+    }
+
+    void statementsTest() {
+        // Variables, conditionals and recursion
+        std::string text = UT::compileToText(
+                "def abs(x : S32) -> S32 { def r : S32 = x; if( x < 0 ) { 0 - x } else { r } }\n"
+                "def fact(n : U32) -> U32 { if( n < 2 ) { 1 } else { n * fact(n - 1) } }\n"
+                "def f() -> S32 { abs(0 - 12) }\n"
+                "def g() -> U32 { fact(5) }\n" );
+        CPPUNIT_ASSERT( contains( text, "= 12 : S32" ) );
+        CPPUNIT_ASSERT( contains( text, "= 120 : U32" ) );
+
+        // The recursive call inside fact itself is not evaluated
+        CPPUNIT_ASSERT( contains( text, "= call " ) );
+    }
+
+    void limitsTest() {
+        // Recursing deeper than MaxCallDepth gives up, and the call is generated
+        std::string text = UT::compileToText(
+                "def fact(n : U32) -> U32 { if( n < 2 ) { 1 } else { n * fact(n - 1) } }\n"
+                "def f() -> U32 { fact(" + std::to_string( AST::Interpreter::MaxCallDepth + 1 ) + ") }\n" );
+
+        size_t fBody = text.rfind( "function " );
+        CPPUNIT_ASSERT( fBody!=std::string::npos );
+        CPPUNIT_ASSERT( contains( text.substr( fBody ), "= call " ) );
+    }
+
+public:
+    static CppUnit::Test *suite()
+    {
+        CppUnit::TestSuite *suiteOfTests = new CppUnit::TestSuite( "InterpreterTest" );
+        suiteOfTests->addTest( new CppUnit::TestCaller<InterpreterTest>(
+                    "foldCallTest",
+                    &InterpreterTest::foldCallTest ) );
+        suiteOfTests->addTest( new CppUnit::TestCaller<InterpreterTest>(
+                    "definitionOrderTest",
+                    &InterpreterTest::definitionOrderTest ) );
+        suiteOfTests->addTest( new CppUnit::TestCaller<InterpreterTest>(
+                    "statementsTest",
+                    &InterpreterTest::statementsTest ) );
+        suiteOfTests->addTest( new CppUnit::TestCaller<InterpreterTest>(
+                    "limitsTest",
+                    &InterpreterTest::limitsTest ) );
+        return suiteOfTests;
+    }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( InterpreterTest );
@@ -111,7 +111,7 @@ size_t FunctionArguments::parse(Slice<const Tokenizer::Token> source) {
                     "EOF while scanning arguments list" );
         }
 
-        Expression *argument = &arguments.emplace_back();
+        Expression *argument = &appendNode( arguments );
         tokensConsumed += argument->parse( source.subslice(tokensConsumed) );
     }
 
@@ -125,7 +125,7 @@ size_t Expression::parse(Slice<const Tokenizer::Token> source) {
         ConditionalExpressionOrStatement condition;
         tokensConsumed = condition.parse( source, ExpectedResult::Expression );
 
-        value = safenew<ConditionalExpression>( condition.removeExpression() );
+        value = newNode<ConditionalExpression>( condition.removeExpression() );
 
         RULE_LEAVE();
     }
@@ -135,7 +135,7 @@ size_t Expression::parse(Slice<const Tokenizer::Token> source) {
         CompoundExpression compound;
         tokensConsumed=compound.parse(source);
 
-        value = safenew<CompoundExpression>( std::move(compound) );
+        value = newNode<CompoundExpression>( std::move(compound) );
 
         RULE_LEAVE();
     }
@@ -169,7 +169,7 @@ const Type *Expression::reparseAsType() const {
     }
 
     if( !altTypeParse ) {
-        altTypeParse = safenew<NonTerminals::Type>();
+        altTypeParse = newNode<NonTerminals::Type>();
 
         size_t tokensConsumed = altTypeParse->parse( getNTTokens() );
         if( tokensConsumed != getNTTokens().size() ) {
@@ -257,7 +257,7 @@ size_t Expression::parsePrefixOp(
                 UnaryOperator &op1 = value.emplace< UnaryOperator >();
                 op1.op = op;
                 // The operator we found is a valid prefix operator for this level
-                op1.operand = safenew< Expression >();
+                op1.operand = newNode< Expression >();
                 tokensConsumed += op1.operand->parsePrefixOp( source.subslice(tokensConsumed), level, operators );
             }
             RULE_LEAVE();
@@ -280,7 +280,7 @@ size_t Expression::parsePrefixOp(
                         "Expected `(` after cast type",
                         "End of file looking for cast expression"
                 );
-                cast.expression = safenew< Expression >();
+                cast.expression = newNode< Expression >();
                 tokensConsumed += cast.expression->parse( source.subslice( tokensConsumed ) );
                 expectToken(
                         Tokenizer::Tokens::BRACKET_ROUND_CLOSE,
@@ -321,7 +321,7 @@ size_t Expression::parseInfixOp(
      */
 
     BinaryOperator op;
-    op.operands[0] = safenew<Expression>();
+    op.operands[0] = newNode<Expression>();
     tokensConsumed = op.operands[0]->actualParse( source, level-1 );
 
     size_t provisionalTokensConsumed = tokensConsumed;
@@ -341,7 +341,7 @@ size_t Expression::parseInfixOp(
     ASSERT( opInfo->second==Operators::OperatorType::Regular );
     tokensConsumed = provisionalTokensConsumed;
 
-    op.operands[1] = safenew< Expression >();
+    op.operands[1] = newNode< Expression >();
     tokensConsumed += op.operands[1]->actualParse( source.subslice(tokensConsumed), level-1 );
 
     while( true ) {
@@ -356,11 +356,11 @@ size_t Expression::parseInfixOp(
 
         // Commit to extending
         tokensConsumed = provisionalTokensConsumed;
-        op2.operands[0] = safenew< Expression >();
+        op2.operands[0] = newNode< Expression >();
         op2.operands[0]->value = std::move( op );
         op = std::move( op2 );
 
-        op.operands[1] = safenew< Expression >();
+        op.operands[1] = newNode< Expression >();
         tokensConsumed += op.operands[1]->actualParse( source.subslice( tokensConsumed ), level-1 );
     }
 
@@ -375,7 +375,7 @@ size_t Expression::parseInfixR2LOp(
     RULE_ENTER(source);
 
     BinaryOperator op;
-    op.operands[0] = safenew< Expression >();
+    op.operands[0] = newNode< Expression >();
     tokensConsumed += op.operands[0]->actualParse( source, level-1 );
 
     size_t provisionalTokensConsumed = tokensConsumed;
@@ -395,7 +395,7 @@ size_t Expression::parseInfixR2LOp(
 
     tokensConsumed = provisionalTokensConsumed;
 
-    op.operands[1] = safenew< Expression >();
+    op.operands[1] = newNode< Expression >();
     tokensConsumed += op.operands[1]->actualParse( source.subslice(tokensConsumed), level );
 
     value = std::move( op );
@@ -423,7 +423,7 @@ size_t Expression::parsePostfixOp(
 
         switch( opInfo->second ) {
         case Operators::OperatorType::Regular:
-            op.operand = safenew< Expression >( std::move( *this ) );
+            op.operand = newNode< Expression >( std::move( *this ) );
             value = std::move( op );
             ASSERT( ! op.operand );
             break;
@@ -431,7 +431,7 @@ size_t Expression::parsePostfixOp(
             {
                 FunctionCall funcCall;
                 funcCall.op = op.op;
-                funcCall.expression = safenew< Expression >( std::move( *this ) );
+                funcCall.expression = newNode< Expression >( std::move( *this ) );
                 tokensConsumed += funcCall.arguments.parse( source.subslice(tokensConsumed) );
                 value = std::move( funcCall );
             }
@@ -479,7 +479,7 @@ size_t Statement::parse(Slice<const Tokenizer::Token> source) {
         CompoundStatement compound;
         tokensConsumed=compound.parse(source);
 
-        content = safenew<CompoundStatement>( std::move(compound) );
+        content = newNode<CompoundStatement>( std::move(compound) );
 
         RULE_LEAVE();
     }
@@ -518,7 +518,7 @@ size_t StatementList::parse(Slice<const Tokenizer::Token> source) {
             Statement statement;
             tokensConsumed += statement.parse(source.subslice(tokensConsumed));
 
-            statements.emplace_back( std::move(statement) );
+            appendNode( statements, std::move(statement) );
         }
     } catch( parser_error &err ) {
         EXCEPTION_CAUGHT(err);
@@ -587,7 +587,7 @@ size_t FuncDeclArgsNonEmpty::parse(Slice<const Tokenizer::Token> source) {
     do {
         FuncDeclArg arg;
         tokensConsumed += arg.parse(source.subslice(tokensConsumed));
-        arguments.emplace_back( std::move(arg) );
+        appendNode( arguments, std::move(arg) );
 
         more = wishForToken( Tokenizer::Tokens::COMMA, source, tokensConsumed, true );
     } while( more );
@@ -637,6 +637,12 @@ size_t FuncDef::parse(Slice<const Tokenizer::Token> source) {
     }
 
     tokensConsumed += decl.parse( source.subslice(tokensConsumed) );
+
+    lazyBody = wishForToken( Tokenizer::Tokens::LAZY_BODY, source, tokensConsumed, true );
+    if( lazyBody!=nullptr ) {
+        RULE_LEAVE();
+    }
+
     CompoundExpressionOrStatement body;
     tokensConsumed += body.parse( source.subslice(tokensConsumed) );
     if( body.isStatement() )
@@ -647,6 +653,30 @@ size_t FuncDef::parse(Slice<const Tokenizer::Token> source) {
     RULE_LEAVE();
 }
 
+size_t FuncDef::parseBody() const {
+    ASSERT( isLazy() )<<"Function "<<getName()<<" has no lazy body to parse";
+    if( !std::holds_alternative<std::monostate>(body) )
+        return 0;
+
+    bodyTokens = Tokenizer::Tokenizer::tokenize( lazyBody->text, lazyBody->location );
+
+    CompoundExpressionOrStatement parsedBody;
+    parsedBody.parse( bodyTokens );
+    if( parsedBody.isStatement() )
+        body = parsedBody.removeStatement();
+    else
+        body = parsedBody.removeExpression();
+
+    return bodyTokens.size();
+}
+
+void FuncDef::releaseBody() const {
+    ASSERT( isLazy() )<<"Function "<<getName()<<" has no lazy body to release";
+
+    body = std::monostate();
+    std::vector<Tokenizer::Token>().swap( bodyTokens );
+}
+
 size_t FuncDecl::parse(Slice<const Tokenizer::Token> source) {
     RULE_ENTER(source);
 
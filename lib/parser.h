@@ -238,17 +238,35 @@ namespace NonTerminals {
 
     struct FuncDef : public NonTerminal {
         FuncDeclBody decl;
-        std::variant<std::monostate, CompoundExpression, CompoundStatement> body;
+        // Empty while a lazily tokenized body is not parsed
+        mutable std::variant<std::monostate, CompoundExpression, CompoundStatement> body;
 
         FuncDef() : body{} {
         }
-        FuncDef( FuncDef &&that ) : decl( std::move(that.decl) ), body( std::move(that.body) ) {}
+        FuncDef( FuncDef &&that ) :
+            decl( std::move(that.decl) ), body( std::move(that.body) ), lazyBody( that.lazyBody ),
+            bodyTokens( std::move(that.bodyTokens) )
+        {}
 
         size_t parse(Slice<const Tokenizer::Token> source) override final;
 
         String getName() const {
             return decl.name.getName();
         }
+
+        // Whether the body was left for later by Tokenizer::tokenizeLazily
+        bool isLazy() const {
+            return lazyBody!=nullptr;
+        }
+
+        // Tokenizes and parses a lazy body, unless it is already parsed. Returns the number of tokens it tokenized.
+        size_t parseBody() const;
+        // Frees a lazy body's tokens and parse tree. It can be parsed again later.
+        void releaseBody() const;
+
+    private:
+        const Tokenizer::Token *lazyBody = nullptr;
+        mutable std::vector<Tokenizer::Token> bodyTokens;
     };
 
     struct FuncDecl : public NonTerminal {
@@ -265,6 +283,12 @@ namespace NonTerminals {
         }
     };
 
+    // The number of parser errors caught so far on this thread while backtracking. Only grows.
+    size_t numExceptionsCaught();
+    // Bytes of parse tree nodes allocated so far on this thread, including nodes discarded while backtracking. Only
+    // grows.
+    size_t parseTreeBytes();
+
 } // NonTerminals namespace
 
 #endif // PARSER_H
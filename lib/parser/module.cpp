@@ -24,6 +24,15 @@ void Module::parse(String source) {
 size_t Module::parse(Slice<const Tokenizer::Token> source) {
     RULE_ENTER(source);
 
+    parseItems(source);
+    tokensConsumed = source.size();
+
+    RULE_LEAVE();
+}
+
+void Module::parseItems(Slice<const Tokenizer::Token> source) {
+    size_t tokensConsumed = 0;
+
     skipWS(source, tokensConsumed);
     while( tokensConsumed<source.size() ) {
         const Tokenizer::Token *currentToken = wishForToken(
@@ -34,7 +43,7 @@ size_t Module::parse(Slice<const Tokenizer::Token> source) {
             FuncDef func;
 
             tokensConsumed += func.parse( source.subslice(tokensConsumed) );
-            functionDefinitions.emplace_back( std::move(func) );
+            appendNode( functionDefinitions, std::move(func) );
 
             skipWS(source, tokensConsumed);
             continue;
@@ -48,7 +57,7 @@ size_t Module::parse(Slice<const Tokenizer::Token> source) {
             FuncDecl func;
 
             tokensConsumed += func.parse( source.subslice(tokensConsumed) );
-            functionDeclarations.emplace_back( std::move(func) );
+            appendNode( functionDeclarations, std::move(func) );
 
             skipWS(source, tokensConsumed);
             continue;
@@ -62,7 +71,7 @@ size_t Module::parse(Slice<const Tokenizer::Token> source) {
             StructDef strct;
 
             tokensConsumed += strct.parse( source.subslice(tokensConsumed) );
-            structureDefinitions.emplace_back( std::move(strct) );
+            appendNode( structureDefinitions, std::move(strct) );
 
             skipWS(source, tokensConsumed);
             continue;
@@ -70,8 +79,6 @@ size_t Module::parse(Slice<const Tokenizer::Token> source) {
 
         throw parser_error("Unidentified statement in global context", source[tokensConsumed].location );
     }
-
-    RULE_LEAVE();
 }
 
 } // namespace NonTerminals
@@ -22,6 +22,8 @@ namespace NonTerminals {
 
         void parse(String source);
         size_t parse(Slice<const Tokenizer::Token> source) override final;
+        // Adds the top level items in source to the module. source must hold whole items.
+        void parseItems(Slice<const Tokenizer::Token> source);
         String getName() const {
             return toSlice("__main");
         }
@@ -37,7 +37,7 @@ size_t Type::parse(Slice<const Tokenizer::Token> source) {
         switch( token->token ) {
         case Tokenizer::Tokens::BRACKET_SQUARE_OPEN:
             {
-                auto elementType = std::make_unique<Type>();
+                auto elementType = newNode<Type>();
                 elementType->type = std::move(type);
 
                 Array &array = type.emplace< Array >( std::move(elementType), token );
@@ -49,7 +49,7 @@ size_t Type::parse(Slice<const Tokenizer::Token> source) {
             break;
         case Tokenizer::Tokens::OP_PTR:
             {
-                auto pointedType = std::make_unique<Type>();
+                auto pointedType = newNode<Type>();
                 pointedType->type = std::move(type);
 
                 type.emplace< Pointer >( std::move(pointedType), token );
@@ -43,7 +43,7 @@ size_t VariableDefinition::parse(Slice<const Tokenizer::Token> source) {
         Expression initValue;
         provisionalConsumed += initValue.parse( source.subslice(provisionalConsumed) );
 
-        this->initValue = safenew<Expression>( std::move(initValue) );
+        this->initValue = newNode<Expression>( std::move(initValue) );
         tokensConsumed = provisionalConsumed;
     } catch( parser_error &err ) {
         EXCEPTION_CAUGHT(err);
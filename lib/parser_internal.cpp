@@ -6,6 +6,17 @@
 size_t PARSER_RECURSION_DEPTH;
 #endif
 
+thread_local size_t PARSER_EXCEPTIONS_CAUGHT;
+thread_local size_t PARSER_TREE_BYTES;
+
+size_t NonTerminals::numExceptionsCaught() {
+    return PARSER_EXCEPTIONS_CAUGHT;
+}
+
+size_t NonTerminals::parseTreeBytes() {
+    return PARSER_TREE_BYTES;
+}
+
 namespace InternalNonTerminals {
 
 bool skipWS(Slice<const Tokenizer::Token> source, size_t &index) {
@@ -87,9 +98,9 @@ size_t ExpressionOrStatement::parse(Slice<const Tokenizer::Token> source) {
         tokensConsumed = parsed.parse(source);
 
         if( parsed.isStatement() )
-            content.emplace<Statement>( safenew<CompoundStatement>(parsed.removeStatement()) );
+            content.emplace<Statement>( newNode<CompoundStatement>(parsed.removeStatement()) );
         else
-            content.emplace<NonTerminals::Expression>( safenew<CompoundExpression>(parsed.removeExpression()) );
+            content.emplace<NonTerminals::Expression>( newNode<CompoundExpression>(parsed.removeExpression()) );
 
         RULE_LEAVE();
     }
@@ -127,7 +138,7 @@ size_t ConditionalExpressionOrStatement::parse(Slice<const Tokenizer::Token> sou
 
     std::unique_ptr<ExpressionOrStatement> elseClause;
     if( wishForToken(Tokenizer::Tokens::RESERVED_ELSE, source, tokensConsumed) ) {
-        elseClause = safenew<ExpressionOrStatement>();
+        elseClause = newNode<ExpressionOrStatement>();
         tokensConsumed += elseClause->parse( source.subslice(tokensConsumed) );
     }
 
@@ -148,9 +159,9 @@ size_t ConditionalExpressionOrStatement::parse(Slice<const Tokenizer::Token> sou
 
             auto &statement=this->condition.emplace<Statement::ConditionalStatement>();
             statement.condition=std::move(condition);
-            statement.ifClause = safenew<Statement>( ifClause.removeStatement() );
+            statement.ifClause = newNode<Statement>( ifClause.removeStatement() );
             if( elseClause )
-                statement.elseClause = safenew<Statement>( elseClause->removeStatement() );
+                statement.elseClause = newNode<Statement>( elseClause->removeStatement() );
         }
         break;
     case ExpectedResult::Expression:
@@ -11,6 +11,25 @@
 
 #include "parser.h"
 
+// Parser errors caught while backtracking on this thread. See NonTerminals::numExceptionsCaught
+extern thread_local size_t PARSER_EXCEPTIONS_CAUGHT;
+// Bytes of parse tree nodes allocated on this thread. See NonTerminals::parseTreeBytes
+extern thread_local size_t PARSER_TREE_BYTES;
+
+// Allocates a parse tree node on the heap, accounting for it in PARSER_TREE_BYTES
+template<typename T, typename... Args>
+std::unique_ptr<T> newNode( Args&&... args ) {
+    PARSER_TREE_BYTES += sizeof(T);
+    return safenew<T>( std::forward<Args>(args)... );
+}
+
+// Appends a parse tree node to a list of them, accounting for it in PARSER_TREE_BYTES
+template<typename T, typename... Args>
+T &appendNode( std::vector<T> &nodes, Args&&... args ) {
+    PARSER_TREE_BYTES += sizeof(T);
+    return nodes.emplace_back( std::forward<Args>(args)... );
+}
+
 #if VERBOSE_PARSING
 extern size_t PARSER_RECURSION_DEPTH;
 
@@ -31,6 +50,7 @@ extern size_t PARSER_RECURSION_DEPTH;
     return tokensConsumed
 
 #define EXCEPTION_CAUGHT(ex) \
+    ++PARSER_EXCEPTIONS_CAUGHT; \
     PARSER_RECURSION_DEPTH = RECURSION_CURRENT_DEPTH + 1; \
     for( size_t I=0; I<RECURSION_CURRENT_DEPTH; ++I ) std::cout<<"  "; \
     std::cout<< __PRETTY_FUNCTION__ << " caught " << ex.what() << "\n"
@@ -41,7 +61,7 @@ extern size_t PARSER_RECURSION_DEPTH;
 #define RULE_LEAVE() \
     this->parsedSlice = source.subslice(0, tokensConsumed); \
     return tokensConsumed
-#define EXCEPTION_CAUGHT(ex)
+#define EXCEPTION_CAUGHT(ex) ++PARSER_EXCEPTIONS_CAUGHT
 
 #endif
 
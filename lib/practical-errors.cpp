@@ -116,4 +116,14 @@ KnownRuntimeViolation::KnownRuntimeViolation(const char *message, const SourceLo
     compile_error( message, location )
 {}
 
+MemoryLimitExceeded::MemoryLimitExceeded( size_t limit ) :
+    compile_error( SourceLocation() )
+{
+    std::stringstream buf;
+
+    buf<<"Memory limit of "<<limit<<" bytes exceeded";
+
+    setMsg( buf.str().c_str() );
+}
+
 } // namespace PracticalSemanticAnalyzer
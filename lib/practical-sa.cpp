@@ -9,13 +9,22 @@
 #include "config.h"
 
 #include "ast/ast.h"
+#include "ast/memory_limit.h"
+#include "ast/scheduler.h"
 #include "ast/static_type.h"
+#include "ast/statistics.h"
 #include "mmap.h"
+#include "nocopy.h"
 #include "parser.h"
+#include "spsc_queue.h"
 
 #include <practical/defines.h>
 #include <practical/practical.h>
 
+#include <algorithm>
+#include <exception>
+#include <thread>
+
 DEF_TYPED_NS( PracticalSemanticAnalyzer, ModuleId );
 DEF_TYPED_NS( PracticalSemanticAnalyzer, ExpressionId );
 DEF_TYPED_NS( PracticalSemanticAnalyzer, JumpPointId );
@@ -209,35 +218,243 @@ void prepare( BuiltinContextGen *ctxGen ) {
     AST::AST::prepare(ctxGen);
 }
 
-int compile(std::string path, const CompilerArguments *arguments, ModuleGen *codeGen) {
-    // Load file into memory
-    Mmap<MapMode::ReadOnly> sourceFile(path);
+using Clock = std::chrono::steady_clock;
+
+// Adds a compilation session's statistics to the result once the compilation is done, also when it fails
+class StatsReport : private NoCopy {
+    CompileStats &_total;
+    const AST::Statistics &_statistics;
+
+public:
+    StatsReport( CompileStats &total, const AST::Statistics &statistics ) :
+        _total( total ), _statistics( statistics )
+    {}
+
+    ~StatsReport() {
+        _total += _statistics;
+    }
+};
+
+// Tokenizes on a thread of its own, while this thread parses the items tokenized so far and registers their symbols.
+//
+// As in a sequential compilation, a tokenizer error anywhere in the source is reported before parser errors, and a
+// parser error before errors registering the symbols.
+static void compilePipelined(
+        String source, String fileName, const CompilerArguments &arguments, ModuleGen *codeGen,
+        Clock::time_point start, CompileJobResult &result )
+{
+    using Item = std::vector<Tokenizer::Token>;
+
+    SpscQueue<Item, 64> queue;
+    std::exception_ptr tokenizerError;
+    CompileStats::Time tokenizeTime;
+
+    std::thread tokenizer( [&]() {
+            AST::PhaseTimer timer( tokenizeTime );
+
+            try {
+                Tokenizer::Tokenizer::tokenizeItems( source, [&]( Item &&item ) { queue.push( std::move(item) ); } );
+            } catch(...) {
+                tokenizerError = std::current_exception();
+            }
+
+            queue.close();
+        } );
+
+    AST::MemoryLimit memory( arguments.memoryResource, arguments.memoryLimit );
+    AST::CompilationSession session( &memory );
+    AST::CompilationSession::Scope scope( session );
+    AST::Statistics &statistics = session.getStatistics();
+    StatsReport report( result.stats, statistics );
+
+    // The parse tree points into the items' tokens. Moving an item keeps its tokens where they are.
+    std::vector<Item> items;
+    NonTerminals::Module module;
+    std::exception_ptr parserError, symbolsError;
+
+    session.startModule( module, fileName );
+
+    Item item;
+    while( queue.pop( item ) ) {
+        // Keep popping after a failure, so that the tokenizer can finish
+        if( parserError )
+            continue;
+
+        statistics.tokens += item.size();
+
+        try {
+            AST::PhaseTimer timer( statistics.parse );
+            AST::BacktrackCounter backtracks( statistics.parserBacktracks );
+            size_t treeBytes = NonTerminals::parseTreeBytes();
+            const Item &parsedItem = items.emplace_back( std::move(item) );
+            module.parseItems( parsedItem );
+
+            session.chargeMemory(
+                    parsedItem.capacity()*sizeof(Tokenizer::Token) + NonTerminals::parseTreeBytes() - treeBytes );
+        } catch(...) {
+            parserError = std::current_exception();
+            continue;
+        }
+
+        // A later item may still fail to parse
+        if( symbolsError )
+            continue;
 
-    AST::AST ast;
+        try {
+            session.symbolsPass1();
+        } catch(...) {
+            symbolsError = std::current_exception();
+        }
+    }
+
+    tokenizer.join();
+    statistics.tokenize += tokenizeTime;
+
+    for( const std::exception_ptr &error : { tokenizerError, parserError, symbolsError } ) {
+        if( error )
+            std::rethrow_exception( error );
+    }
+
+    Clock::time_point parsed = Clock::now();
+    result.parseTime = parsed - start;
+
+    session.finishModule( arguments, codeGen );
 
-    // Parse + symbols lookup
+    result.analysisTime = Clock::now() - parsed;
+}
+
+static void compileSource(
+        String source, String fileName, const CompilerArguments &arguments, ModuleGen *codeGen,
+        Clock::time_point start, CompileJobResult &result )
+{
     ASSERT( AST::AST::prepared() )<<"compile called without calling prepare first";
-    auto tokenizedModule = Tokenizer::Tokenizer::tokenize( sourceFile.getSlice<const char>() );
+
+    if( arguments.pipelined && !arguments.streaming )
+        return compilePipelined( source, fileName, arguments, codeGen, start, result );
+
+    AST::MemoryLimit memory( arguments.memoryResource, arguments.memoryLimit );
+    AST::CompilationSession session( &memory );
+    AST::Statistics &statistics = session.getStatistics();
+    StatsReport report( result.stats, statistics );
+
+    // Parse + symbols lookup. When streaming, the function bodies are parsed as they are analyzed.
+    std::vector<Tokenizer::Token> tokenizedModule;
+    {
+        AST::PhaseTimer timer( statistics.tokenize );
+        tokenizedModule = arguments.streaming ?
+                Tokenizer::Tokenizer::tokenizeLazily( source ) : Tokenizer::Tokenizer::tokenize( source );
+    }
+    // The function bodies' placeholders are not tokens of the source. The bodies' tokens are counted once parsed.
+    statistics.tokens += std::count_if(
+            tokenizedModule.begin(), tokenizedModule.end(),
+            []( const Tokenizer::Token &token ) { return token.token!=Tokenizer::Tokens::LAZY_BODY; } );
+    session.chargeMemory( tokenizedModule.capacity()*sizeof(Tokenizer::Token) );
+
     NonTerminals::Module module;
-    module.parse( tokenizedModule );
+    {
+        AST::PhaseTimer timer( statistics.parse );
+        AST::BacktrackCounter backtracks( statistics.parserBacktracks );
+        size_t treeBytes = NonTerminals::parseTreeBytes();
+        module.parse( tokenizedModule );
+        session.chargeMemory( NonTerminals::parseTreeBytes() - treeBytes );
+    }
+
+    Clock::time_point parsed = Clock::now();
+    result.parseTime = parsed - start;
 
     // And that other thing
-    ast.codeGen( module, codeGen );
+    session.codeGen( module, fileName, arguments, codeGen );
+
+    result.analysisTime = Clock::now() - parsed;
+}
+
+static void compileFile(
+        const std::string &path, const CompilerArguments &arguments, ModuleGen *codeGen, CompileJobResult &result )
+{
+    Clock::time_point start = Clock::now();
+
+    // Load file into memory
+    Mmap<MapMode::ReadOnly> sourceFile = [&]() {
+        AST::PhaseTimer timer( result.stats.read );
+        return Mmap<MapMode::ReadOnly>(path);
+    }();
+
+    compileSource( sourceFile.getSlice<const char>(), path, arguments, codeGen, start, result );
+}
+
+static void addStats( const CompilerArguments *arguments, const CompileJobResult &result ) {
+    if( arguments!=nullptr && arguments->stats!=nullptr )
+        *arguments->stats += result.stats;
+}
+
+int compile(std::string path, const CompilerArguments *arguments, ModuleGen *codeGen) {
+    CompilerArguments defaultArguments;
+    CompileJobResult result;
+
+    try {
+        compileFile( path, arguments!=nullptr ? *arguments : defaultArguments, codeGen, result );
+    } catch(...) {
+        addStats( arguments, result );
+        throw;
+    }
+
+    addStats( arguments, result );
 
     return 0;
 }
 
+int compile(String source, String fileName, const CompilerArguments *arguments, ModuleGen *codeGen) {
+    CompilerArguments defaultArguments;
+    CompileJobResult result;
+
+    try {
+        compileSource(
+                source, fileName, arguments!=nullptr ? *arguments : defaultArguments, codeGen, Clock::now(), result );
+    } catch(...) {
+        addStats( arguments, result );
+        throw;
+    }
+
+    addStats( arguments, result );
+
+    return 0;
+}
+
+std::vector<CompileJobResult> compileMany( Slice<const CompileJob> jobs, const CompilerArguments *arguments ) {
+    ASSERT( AST::AST::prepared() )<<"compileMany called without calling prepare first";
+
+    CompilerArguments moduleArguments;
+    if( arguments!=nullptr )
+        moduleArguments = *arguments;
+    // The pool's threads are busy with whole modules
+    moduleArguments.numThreads = 1;
+    moduleArguments.pipelined = false;
+
+    std::vector<CompileJobResult> results( jobs.size() );
+    AST::Scheduler scheduler( arguments!=nullptr ? arguments->numThreads : 1 );
+    scheduler.run( jobs.size(), [&]( size_t index ) {
+            try {
+                compileFile( jobs[index].path, moduleArguments, jobs[index].codeGen, results[index] );
+                results[index].succeeded = true;
+            } catch( std::exception &ex ) {
+                results[index].error = ex.what();
+            }
+        } );
+
+    for( const CompileJobResult &result : results )
+        addStats( arguments, result );
+
+    return results;
+}
+
 } // PracticalSemanticAnalyzer
 
 using namespace PracticalSemanticAnalyzer;
 
 namespace std {
 
-static size_t indent = 0;
 size_t hash< StaticType >::operator()(const StaticType &type) const {
-    size_t ret = AST::downCast( &type )->getHash();
-    indent--;
-    return ret;
+    return AST::downCast( &type )->getHash();
 }
 
 } // namespace std
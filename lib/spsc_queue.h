@@ -0,0 +1,97 @@
+/* This file is part of the Practical programming langauge. https://github.com/Practical/practical-sa
+ *
+ * To the extent header files enjoy copyright protection, this file is file is copyright (C) 2021 by its authors
+ * You can see the file's authors in the AUTHORS file in the project's home repository.
+ *
+ * This is available under the Boost license. The license's text is available under the LICENSE file in the project's
+ * home directory.
+ */
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include "nocopy.h"
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+
+// Bounded queue passing values from a single producer thread to a single consumer thread. Pushing and popping take no
+// locks while the queue is neither full nor empty.
+//
+// Pushing to a full queue, or popping from an empty one, blocks until the other side catches up.
+template<typename T, size_t Capacity>
+class SpscQueue : private NoCopy {
+    static_assert( Capacity>0 && (Capacity & (Capacity-1))==0, "Queue capacity must be a power of 2" );
+    static constexpr size_t CacheLineSize = 64;
+
+    std::array<T, Capacity> _slots;
+    // Only written by the consumer
+    alignas(CacheLineSize) std::atomic<size_t> _head = 0;
+    // Only written by the producer
+    alignas(CacheLineSize) std::atomic<size_t> _tail = 0;
+    std::atomic<bool> _closed = false;
+
+    // Blocking on a full or empty queue
+    std::mutex _mutex;
+    std::condition_variable _changed;
+    std::atomic<unsigned> _numWaiting = 0;
+
+    template<typename Predicate>
+    void waitFor( Predicate ready ) {
+        std::unique_lock<std::mutex> lock( _mutex );
+        _numWaiting.fetch_add( 1 );
+        _changed.wait( lock, ready );
+        _numWaiting.fetch_sub( 1, std::memory_order_relaxed );
+    }
+
+    // Wakes the other side, if it is waiting for the change just made
+    void notify() {
+        // A waiter registers before checking the queue, and the change was made before checking for waiters. Either
+        // the waiter sees the change, or this sees the waiter.
+        std::atomic_thread_fence( std::memory_order_seq_cst );
+        if( _numWaiting.load( std::memory_order_relaxed )==0 )
+            return;
+
+        std::lock_guard<std::mutex> lock( _mutex );
+        _changed.notify_all();
+    }
+
+public:
+    void push( T value ) {
+        size_t tail = _tail.load( std::memory_order_relaxed );
+        if( tail - _head.load( std::memory_order_acquire ) == Capacity )
+            waitFor( [&]() { return tail - _head.load()!=Capacity; } );
+
+        _slots[ tail % Capacity ] = std::move(value);
+        _tail.store( tail+1, std::memory_order_release );
+        notify();
+    }
+
+    // Called by the producer after its last push
+    void close() {
+        _closed.store( true, std::memory_order_release );
+        notify();
+    }
+
+    // Returns false once the queue is closed and everything pushed was popped
+    bool pop( T &value ) {
+        size_t head = _head.load( std::memory_order_relaxed );
+        if( _tail.load( std::memory_order_acquire )==head ) {
+            waitFor( [&]() { return _tail.load()!=head || _closed.load(); } );
+
+            // The last push happens before closing
+            if( _tail.load( std::memory_order_acquire )==head )
+                return false;
+        }
+
+        value = std::move( _slots[ head % Capacity ] );
+        _head.store( head+1, std::memory_order_release );
+        notify();
+
+        return true;
+    }
+};
+
+#endif // SPSC_QUEUE_H
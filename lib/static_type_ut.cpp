@@ -0,0 +1,64 @@
+/* This file is part of the Practical programming langauge. https://github.com/Practical/practical-sa
+ *
+ * This file is file is copyright (C) 2021 by its authors.
+ * You can see the file's authors in the AUTHORS file in the project's home repository.
+ *
+ * This is available under the Boost license. The license's text is available under the LICENSE file in the project's
+ * home directory.
+ */
+#include "ast/delayed_definitions.h"
+#include "ast/lookup_context.h"
+#include "ast/static_type.h"
+#include "parser/module.h"
+#include "ut/recording_gen.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class StaticTypeTest : public CppUnit::TestFixture {
+    void freezeStructTest() {
+        UT::prepare();
+
+        NonTerminals::Module parserModule;
+        parserModule.parse( toSlice( "struct Node { def next : Node@; def value : U32; }" ) );
+
+        AST::LookupContext lookupContext( &AST::AST::getBuiltinCtx() );
+        lookupContext.addStructPass1( parserModule.structureDefinitions[0] );
+
+        AST::DelayedDefinitions delayedDefs;
+        lookupContext.addStructPass2( parserModule.structureDefinitions[0], delayedDefs );
+        CPPUNIT_ASSERT( delayedDefs.ready.empty() && delayedDefs.pending.empty() );
+        for( AST::StructTypeImpl *needHash : delayedDefs.hashless )
+            needHash->calcHash();
+
+        // Reach the struct through its member that points back to it
+        AST::StaticTypeImpl::CPtr pointer = lookupContext.lookupType(
+                parserModule.structureDefinitions[0].variables[0].body.type );
+        auto pointed = std::get<const PracticalSemanticAnalyzer::StaticType::Pointer *>( pointer->getType() );
+        AST::StaticTypeImpl::CPtr node = AST::downCast( pointed->getPointedType() );
+        CPPUNIT_ASSERT( !node->isImmortal() );
+
+        // Structs have no mangled name. The member pointing back to the struct must not recurse forever.
+        CPPUNIT_ASSERT( !node->freeze() );
+        CPPUNIT_ASSERT( node->isImmortal() );
+
+        auto strct = std::get<const PracticalSemanticAnalyzer::StaticType::Struct *>( node->getType() );
+        CPPUNIT_ASSERT_EQUAL( size_t(2), strct->getNumMembers() );
+        for( size_t i=0; i<strct->getNumMembers(); ++i )
+            CPPUNIT_ASSERT( AST::downCast( strct->getMember(i).type )->isImmortal() );
+
+        // Freezing again changes nothing
+        CPPUNIT_ASSERT( !node->freeze() );
+    }
+
+public:
+    static CppUnit::Test *suite()
+    {
+        CppUnit::TestSuite *suiteOfTests = new CppUnit::TestSuite( "StaticTypeTest" );
+        suiteOfTests->addTest( new CppUnit::TestCaller<StaticTypeTest>(
+                    "freezeStructTest",
+                    &StaticTypeTest::freezeStructTest ) );
+        return suiteOfTests;
+    }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( StaticTypeTest );
@@ -157,9 +157,13 @@ bool Tokenizer::next() {
 }
 
 std::vector<Token> Tokenizer::tokenize(String source) {
+    return tokenize( source, SourceLocation{ .line=1, .col=1 } );
+}
+
+std::vector<Token> Tokenizer::tokenize(String source, SourceLocation start) {
     std::vector<Token> tokens;
 
-    Tokenizer tokenizer(source);
+    Tokenizer tokenizer(source, start);
 
     while( tokenizer.next() ) {
         tokens.push_back(tokenizer.current());
@@ -168,6 +172,94 @@ std::vector<Token> Tokenizer::tokenize(String source) {
     return tokens;
 }
 
+void Tokenizer::tokenizeItems(String source, const std::function<void (std::vector<Token> &&)> &publish) {
+    std::vector<Token> item;
+    size_t depth = 0;
+
+    Tokenizer tokenizer(source);
+
+    while( tokenizer.next() ) {
+        switch( tokenizer.currentToken() ) {
+        case Tokens::BRACKET_CURLY_OPEN:
+            depth++;
+            break;
+        case Tokens::BRACKET_CURLY_CLOSE:
+            if( depth>0 )
+                depth--;
+            break;
+        case Tokens::RESERVED_DEF:
+        case Tokens::RESERVED_DECL:
+        case Tokens::RESERVED_STRUCT:
+            // Outside of any braces, these start the next item
+            if( depth==0 && !item.empty() ) {
+                publish( std::move(item) );
+                item.clear();
+            }
+            break;
+        default:
+            break;
+        }
+
+        item.push_back(tokenizer.current());
+    }
+
+    if( !item.empty() )
+        publish( std::move(item) );
+}
+
+std::vector<Token> Tokenizer::tokenizeLazily(String source) {
+    std::vector<Token> tokens;
+    size_t depth = 0;
+    // Whether the curly brackets at the top level open a function's body
+    bool inFunction = false;
+    Token body;
+
+    Tokenizer tokenizer(source);
+
+    while( tokenizer.next() ) {
+        switch( tokenizer.currentToken() ) {
+        case Tokens::RESERVED_DEF:
+            if( depth==0 )
+                inFunction = true;
+            break;
+        case Tokens::RESERVED_DECL:
+        case Tokens::RESERVED_STRUCT:
+            if( depth==0 )
+                inFunction = false;
+            break;
+        case Tokens::BRACKET_CURLY_OPEN:
+            if( depth++==0 && inFunction ) {
+                body = tokenizer.current();
+                body.token = Tokens::LAZY_BODY;
+            }
+            break;
+        case Tokens::BRACKET_CURLY_CLOSE:
+            if( depth>0 && --depth==0 && inFunction ) {
+                const char *end = tokenizer.currentTokenText().get() + tokenizer.currentTokenText().size();
+                body.text = String( body.text.get(), end - body.text.get() );
+                tokens.push_back(body);
+                inFunction = false;
+
+                continue;
+            }
+            break;
+        default:
+            break;
+        }
+
+        if( depth==0 || !inFunction )
+            tokens.push_back(tokenizer.current());
+    }
+
+    if( depth>0 && inFunction ) {
+        // Unterminated body. Parsing it will tell what is wrong.
+        body.text = String( body.text.get(), source.get() + source.size() - body.text.get() );
+        tokens.push_back(body);
+    }
+
+    return tokens;
+}
+
 void Tokenizer::consumeWS() {
     token = Tokens::WS;
     while( nextChar() && isWS(file[position]) )
@@ -418,6 +510,7 @@ std::ostream &operator<<(std::ostream &out, Tokenizer::Tokens token) {
         CASE(RESERVED_REF);
         CASE(RESERVED_NULL);
         CASE(RESERVED_STRUCT);
+        CASE(LAZY_BODY);
     }
 
     out<<"Tokens("<<static_cast<int>(token)<<")";
@@ -14,6 +14,7 @@
 #include <practical/slice.h>
 
 #include <cstring>
+#include <functional>
 #include <iostream>
 #include <memory>
 
@@ -99,6 +100,8 @@ enum class Tokens {
     RESERVED_REF,
     RESERVED_NULL,
     RESERVED_STRUCT,
+    // A function's body, left for later by tokenizeLazily
+    LAZY_BODY,
 };
 
 struct Token {
@@ -125,6 +128,10 @@ public:
     Tokenizer(String file) : file(file), location{ .line=1, .col=1 } {
     }
 
+    // Tokenizes part of a file, that starts at the given location
+    Tokenizer(String file, SourceLocation start) : file(file), location(start) {
+    }
+
     bool next();
 
     Token current() const {
@@ -150,6 +157,13 @@ public:
     }
 
     static std::vector<Token> tokenize(String source);
+    static std::vector<Token> tokenize(String source, SourceLocation start);
+    // Tokenizes everything except for function bodies. Each body is left as a single LAZY_BODY token, whose text is
+    // the body's source, to be tokenized only once it is needed.
+    static std::vector<Token> tokenizeLazily(String source);
+    // Tokenizes one top level item (function, declaration or struct) at a time. Each item's tokens are passed to
+    // publish as soon as the item ends, so that parsing it can start while the rest of the source is tokenized.
+    static void tokenizeItems(String source, const std::function<void (std::vector<Token> &&)> &publish);
 
 private:
     // XXX all of the is* functions here are ASCII
@@ -222,6 +222,64 @@ class TokenizerTest : public CppUnit::TestFixture  {
         }
     }
 
+    void itemsTest() {
+        const char *source =
+                "decl f() -> U32;\n"
+                "def g() -> U32 { def a : U32 = 1; a }\n"
+                "struct S { def x : U8; }";
+
+        std::vector< std::vector<Tokenizer::Token> > items;
+        Tokenizer::Tokenizer::tokenizeItems( source, [&]( std::vector<Tokenizer::Token> &&item ) {
+                    items.emplace_back( std::move(item) );
+                } );
+
+        // The def inside g's body does not start an item
+        CPPUNIT_ASSERT_EQUAL( size_t(3), items.size() );
+        CPPUNIT_ASSERT( items[0][0].token==Tokenizer::Tokens::RESERVED_DECL );
+        CPPUNIT_ASSERT( items[1][0].token==Tokenizer::Tokens::RESERVED_DEF );
+        CPPUNIT_ASSERT( items[2][0].token==Tokenizer::Tokens::RESERVED_STRUCT );
+
+        // Together, the items hold exactly the tokens of the whole source
+        std::vector<Tokenizer::Token> tokens = Tokenizer::Tokenizer::tokenize( source );
+        size_t numTokens = 0;
+        for( const auto &item : items ) {
+            for( const auto &token : item ) {
+                CPPUNIT_ASSERT( numTokens<tokens.size() );
+                CPPUNIT_ASSERT( token.token==tokens[numTokens].token );
+                CPPUNIT_ASSERT_EQUAL( tokens[numTokens].location, token.location );
+                ++numTokens;
+            }
+        }
+        CPPUNIT_ASSERT_EQUAL( tokens.size(), numTokens );
+    }
+
+    void lazyTest() {
+        const char *source =
+                "def g() -> U32 {\n    def a : U32 = 1; \"}\" ; { a }\n}\n"
+                "struct S { def x : U8; }";
+
+        std::vector<Tokenizer::Token> tokens = Tokenizer::Tokenizer::tokenizeLazily( source );
+        std::vector<Tokenizer::Token> allTokens = Tokenizer::Tokenizer::tokenize( source );
+
+        // The body is a single token, and the rest is tokenized as usual
+        auto body = std::find_if( tokens.begin(), tokens.end(), []( const Tokenizer::Token &token ) {
+                    return token.token==Tokenizer::Tokens::LAZY_BODY;
+                } );
+        CPPUNIT_ASSERT( body!=tokens.end() );
+        CPPUNIT_ASSERT_EQUAL( std::string("{\n    def a : U32 = 1; \"}\" ; { a }\n}"), sliceToString( body->text ) );
+        CPPUNIT_ASSERT( tokens.back().token==Tokenizer::Tokens::BRACKET_CURLY_CLOSE );
+        CPPUNIT_ASSERT_EQUAL( allTokens.back().location, tokens.back().location );
+
+        // Tokenizing the body later gives the same tokens as tokenizing it in place
+        std::vector<Tokenizer::Token> bodyTokens = Tokenizer::Tokenizer::tokenize( body->text, body->location );
+        size_t bodyStart = body - tokens.begin();
+        CPPUNIT_ASSERT_EQUAL( allTokens.size(), tokens.size() - 1 + bodyTokens.size() );
+        for( size_t i=0; i<bodyTokens.size(); ++i ) {
+            CPPUNIT_ASSERT( bodyTokens[i].token==allTokens[bodyStart + i].token );
+            CPPUNIT_ASSERT_EQUAL( allTokens[bodyStart + i].location, bodyTokens[i].location );
+        }
+    }
+
 public:
     static CppUnit::Test *suite()
     {
@@ -229,6 +287,12 @@ public:
         suiteOfTests->addTest( new CppUnit::TestCaller<TokenizerTest>(
                     "test",
                     &TokenizerTest::test ) );
+        suiteOfTests->addTest( new CppUnit::TestCaller<TokenizerTest>(
+                    "itemsTest",
+                    &TokenizerTest::itemsTest ) );
+        suiteOfTests->addTest( new CppUnit::TestCaller<TokenizerTest>(
+                    "lazyTest",
+                    &TokenizerTest::lazyTest ) );
         return suiteOfTests;
     }
 };
@@ -0,0 +1,275 @@
+/* This file is part of the Practical programming langauge. https://github.com/Practical/practical-sa
+ *
+ * To the extent header files enjoy copyright protection, this file is file is copyright (C) 2021 by its authors
+ * You can see the file's authors in the AUTHORS file in the project's home repository.
+ *
+ * This is available under the Boost license. The license's text is available under the LICENSE file in the project's
+ * home directory.
+ */
+#ifndef UT_RECORDING_GEN_H
+#define UT_RECORDING_GEN_H
+
+#include "ast/ast.h"
+
+#include <practical/practical.h>
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Code generation backends for UTs that compile actual source. They record the callbacks they get as text.
+namespace UT {
+
+class BuiltinCtxGen : public PracticalSemanticAnalyzer::BuiltinContextGen {
+    uintptr_t lastId = 0;
+
+    PracticalSemanticAnalyzer::TypeId nextId() {
+        PracticalSemanticAnalyzer::TypeId ret;
+        ret.n = ++lastId;
+
+        return ret;
+    }
+
+public:
+    PracticalSemanticAnalyzer::TypeId registerVoidType() override {
+        return nextId();
+    }
+
+    PracticalSemanticAnalyzer::TypeId registerBoolType() override {
+        return nextId();
+    }
+
+    PracticalSemanticAnalyzer::TypeId registerIntegerType( size_t bitSize, size_t alignment, bool _signed ) override {
+        return nextId();
+    }
+
+    PracticalSemanticAnalyzer::TypeId registerCharType( size_t bitSize, size_t alignment, bool _signed ) override {
+        return nextId();
+    }
+};
+
+// The builtin context is prepared once per process. Any UT might be the first to need it.
+inline void prepare() {
+    static BuiltinCtxGen ctxGen;
+
+    if( !AST::AST::prepared() )
+        PracticalSemanticAnalyzer::prepare( &ctxGen );
+}
+
+class RecordingFunctionGen : public PracticalSemanticAnalyzer::FunctionGen {
+    std::ostringstream _text;
+
+public:
+    using ExpressionId = PracticalSemanticAnalyzer::ExpressionId;
+    using JumpPointId = PracticalSemanticAnalyzer::JumpPointId;
+    using StaticType = PracticalSemanticAnalyzer::StaticType;
+
+    std::string getText() const {
+        return _text.str();
+    }
+
+    void functionEnter(
+            String name, StaticType::CPtr returnType, Slice<const PracticalSemanticAnalyzer::ArgumentDeclaration> arguments,
+            String file, const PracticalSemanticAnalyzer::SourceLocation &location) override
+    {
+        _text<<"function "<<name<<" -> "<<returnType;
+        for( const auto &argument : arguments )
+            _text<<" "<<argument.name<<":"<<argument.type<<"="<<argument.lvalueId;
+        _text<<"\n";
+    }
+
+    void functionLeave() override {
+        _text<<"leave\n";
+    }
+
+    void returnValue(ExpressionId id) override {
+        _text<<"return "<<id<<"\n";
+    }
+
+    void returnValue() override {
+        _text<<"return\n";
+    }
+
+    void conditionalBranch(
+            ExpressionId id, StaticType::CPtr type, ExpressionId conditionExpression, JumpPointId elsePoint,
+            JumpPointId continuationPoint ) override
+    {
+        _text<<id<<" = if "<<conditionExpression<<" else "<<elsePoint<<" continue "<<continuationPoint<<"\n";
+    }
+
+    void setConditionClauseResult( ExpressionId id ) override {
+        _text<<"clause "<<id<<"\n";
+    }
+
+    void setJumpPoint(JumpPointId id, String name) override {
+        _text<<"label "<<id<<"\n";
+    }
+
+    void jump(JumpPointId destination) override {
+        _text<<"jump "<<destination<<"\n";
+    }
+
+    void setLiteral(ExpressionId id, LongEnoughInt value, StaticType::CPtr type) override {
+        _text<<id<<" = "<<value<<" : "<<type<<"\n";
+    }
+
+    void setLiteral(ExpressionId id, bool value) override {
+        _text<<id<<" = "<<( value ? "true" : "false" )<<"\n";
+    }
+
+    void setLiteral(ExpressionId id, String value) override {
+        _text<<id<<" = \""<<value<<"\"\n";
+    }
+
+    void setLiteralNull(ExpressionId id, StaticType::CPtr type) override {
+        _text<<id<<" = null : "<<type<<"\n";
+    }
+
+    void allocateStackVar(ExpressionId id, StaticType::CPtr type, String name) override {
+        _text<<id<<" = alloca "<<name<<" : "<<type<<"\n";
+    }
+
+    void assign( ExpressionId lvalue, ExpressionId rvalue ) override {
+        _text<<"*"<<lvalue<<" = "<<rvalue<<"\n";
+    }
+
+    void dereferencePointer( ExpressionId id, StaticType::CPtr type, ExpressionId addr ) override {
+        _text<<id<<" = *"<<addr<<"\n";
+    }
+
+#define RECORD_CAST(name) \
+    void name( ExpressionId id, ExpressionId source, StaticType::CPtr sourceType, StaticType::CPtr destType ) override { \
+        _text<<id<<" = " #name " "<<source<<" : "<<destType<<"\n"; \
+    }
+
+    RECORD_CAST(truncateInteger)
+    RECORD_CAST(changeIntegerSign)
+    RECORD_CAST(expandIntegerSigned)
+    RECORD_CAST(expandIntegerUnsigned)
+#undef RECORD_CAST
+
+    void callFunctionDirect(
+            ExpressionId id, String name, Slice<const ExpressionId> arguments, StaticType::CPtr returnType ) override
+    {
+        _text<<id<<" = call "<<name;
+        for( ExpressionId argument : arguments )
+            _text<<" "<<argument;
+        _text<<"\n";
+    }
+
+#define RECORD_BINARY(name) \
+    void name( ExpressionId id, ExpressionId left, ExpressionId right, StaticType::CPtr resultType ) override { \
+        _text<<id<<" = " #name " "<<left<<" "<<right<<" : "<<resultType<<"\n"; \
+    }
+
+    RECORD_BINARY(binaryOperatorPlusUnsigned)
+    RECORD_BINARY(binaryOperatorPlusSigned)
+    RECORD_BINARY(binaryOperatorMinusUnsigned)
+    RECORD_BINARY(binaryOperatorMinusSigned)
+    RECORD_BINARY(binaryOperatorMultiplyUnsigned)
+    RECORD_BINARY(binaryOperatorMultiplySigned)
+    RECORD_BINARY(binaryOperatorDivideUnsigned)
+    RECORD_BINARY(operatorEquals)
+    RECORD_BINARY(operatorNotEquals)
+    RECORD_BINARY(operatorLessThanUnsigned)
+    RECORD_BINARY(operatorLessThanSigned)
+    RECORD_BINARY(operatorLessThanOrEqualsUnsigned)
+    RECORD_BINARY(operatorLessThanOrEqualsSigned)
+    RECORD_BINARY(operatorGreaterThanUnsigned)
+    RECORD_BINARY(operatorGreaterThanSigned)
+    RECORD_BINARY(operatorGreaterThanOrEqualsUnsigned)
+    RECORD_BINARY(operatorGreaterThanOrEqualsSigned)
+#undef RECORD_BINARY
+
+    void operatorLogicalNot( ExpressionId id, ExpressionId argument ) override {
+        _text<<id<<" = not "<<argument<<"\n";
+    }
+};
+
+// handleFunction may be called from several threads. Each function is recorded separately.
+class RecordingModuleGen : public PracticalSemanticAnalyzer::ModuleGen {
+    std::ostringstream _module;
+    std::mutex _mutex;
+    std::vector< std::shared_ptr<RecordingFunctionGen> > _functions;
+
+public:
+    using StaticType = PracticalSemanticAnalyzer::StaticType;
+
+    // The module's callbacks, followed by those of its functions in the order they were handed out
+    std::string getText() {
+        std::string text = _module.str();
+        for( const std::string &function : getFunctions() )
+            text += function;
+
+        return text;
+    }
+
+    // The functions in the order they were handed out
+    std::vector<std::string> getFunctions() {
+        std::lock_guard<std::mutex> lock( _mutex );
+
+        std::vector<std::string> functions;
+        for( const auto &function : _functions )
+            functions.emplace_back( function->getText() );
+
+        return functions;
+    }
+
+    // Same as getText, except that the functions are sorted. For comparing compilations that generate the functions in
+    // no particular order.
+    std::string getSortedText() {
+        std::vector<std::string> functions = getFunctions();
+        std::sort( functions.begin(), functions.end() );
+
+        std::string text = _module.str();
+        for( const std::string &function : functions )
+            text += function;
+
+        return text;
+    }
+
+    void moduleEnter(PracticalSemanticAnalyzer::ModuleId id, String name, String file, size_t line, size_t col) override {
+        _module<<"module "<<id<<" "<<file<<"\n";
+    }
+
+    void moduleLeave(PracticalSemanticAnalyzer::ModuleId id) override {
+        _module<<"module leave "<<id<<"\n";
+    }
+
+    void declareIdentifier(String name, String mangledName, StaticType::CPtr type) override {
+        _module<<"declare "<<name<<" "<<mangledName<<" : "<<type<<"\n";
+    }
+
+    void declareStruct(StaticType::CPtr structType) override {
+        _module<<"declare "<<structType<<"\n";
+    }
+
+    void defineStruct(StaticType::CPtr structType) override {
+        _module<<"define "<<structType<<"\n";
+    }
+
+    std::shared_ptr<PracticalSemanticAnalyzer::FunctionGen> handleFunction() override {
+        std::lock_guard<std::mutex> lock( _mutex );
+
+        return _functions.emplace_back( std::make_shared<RecordingFunctionGen>() );
+    }
+};
+
+// Compiles source and returns what the backend got
+inline std::string compileToText(
+        const std::string &source, const PracticalSemanticAnalyzer::CompilerArguments *arguments = nullptr )
+{
+    prepare();
+
+    RecordingModuleGen moduleGen;
+    PracticalSemanticAnalyzer::compile( String(source), "ut.pr", arguments, &moduleGen );
+
+    return moduleGen.getText();
+}
+
+} // namespace UT
+
+#endif // UT_RECORDING_GEN_H
@@ -0,0 +1,146 @@
+/* This file is part of the Practical programming langauge. https://github.com/Practical/practical-sa
+ *
+ * This file is file is copyright (C) 2021 by its authors.
+ * You can see the file's authors in the AUTHORS file in the project's home repository.
+ *
+ * This is available under the Boost license. The license's text is available under the LICENSE file in the project's
+ * home directory.
+ */
+#include "ast/value_range.h"
+#include "ut/recording_gen.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <string>
+
+class ValueRangeTest : public CppUnit::TestFixture {
+    static bool contains( const std::string &text, const std::string &fragment ) {
+        return text.find( fragment )!=std::string::npos;
+    }
+
+    static size_t count( const std::string &text, const std::string &fragment ) {
+        size_t found = 0;
+        for( size_t pos = text.find( fragment ); pos!=std::string::npos; pos = text.find( fragment, pos+1 ) )
+            ++found;
+
+        return found;
+    }
+
+    using ValueRange = AST::ValueRange;
+    using Unsigned = AST::UnsignedIntValueRange;
+    using Signed = AST::SignedIntValueRange;
+
+    static ValueRange boolRange( bool falseAllowed, bool trueAllowed ) {
+        return AST::BoolValueRange( falseAllowed, trueAllowed );
+    }
+
+    void uniteTest() {
+        ValueRange united = ValueRange( Unsigned( 3, 5 ) ).unite( Unsigned( 10, 12 ) );
+        CPPUNIT_ASSERT( united.getKind()==ValueRange::Kind::UnsignedInt );
+        CPPUNIT_ASSERT_EQUAL( LongEnoughInt(3), united.get<Unsigned>().minimum );
+        CPPUNIT_ASSERT_EQUAL( LongEnoughInt(12), united.get<Unsigned>().maximum );
+
+        united = ValueRange( Signed( -5, -2 ) ).unite( Signed( -3, 4 ) );
+        CPPUNIT_ASSERT_EQUAL( LongEnoughIntSigned(-5), united.get<Signed>().minimum );
+        CPPUNIT_ASSERT_EQUAL( LongEnoughIntSigned(4), united.get<Signed>().maximum );
+
+        united = boolRange( false, true ).unite( boolRange( true, false ) );
+        CPPUNIT_ASSERT( !united.isLiteral() );
+
+        // Ranges of different kinds don't merge
+        CPPUNIT_ASSERT( !boolRange( false, true ).unite( Unsigned( 1, 1 ) ) );
+    }
+
+    void intersectTest() {
+        ValueRange common = ValueRange( Unsigned( 3, 10 ) ).intersect( Unsigned( 7, 20 ) );
+        CPPUNIT_ASSERT_EQUAL( LongEnoughInt(7), common.get<Unsigned>().minimum );
+        CPPUNIT_ASSERT_EQUAL( LongEnoughInt(10), common.get<Unsigned>().maximum );
+
+        common = ValueRange( Signed( -8, 0 ) ).intersect( Signed( 0, 8 ) );
+        CPPUNIT_ASSERT( common.isLiteral() );
+        CPPUNIT_ASSERT_EQUAL( LongEnoughIntSigned(0), common.get<Signed>().minimum );
+
+        // Nothing in common
+        CPPUNIT_ASSERT( !ValueRange( Unsigned( 3, 5 ) ).intersect( Unsigned( 6, 9 ) ) );
+        CPPUNIT_ASSERT( !boolRange( false, true ).intersect( boolRange( true, false ) ) );
+        CPPUNIT_ASSERT( !boolRange( false, true ).intersect( Unsigned( 1, 1 ) ) );
+    }
+
+    // Comparisons the narrowed ranges decide are folded to literals, and disappear from the generated code
+    void narrowingTest() {
+        // Mirrored comparison. x is [0,9] in the then clause.
+        std::string text = UT::compileToText(
+                "def f(x : U32) -> Bool { if( 10 > x ) { x < 20 } else { false } }" );
+        CPPUNIT_ASSERT( !contains( text, "operatorLessThanUnsigned" ) );
+
+        // Negation narrows both clauses, the other way around
+        text = UT::compileToText( "def f(x : U32) -> Bool { if( !(x >= 10) ) { x < 20 } else { x > 5 } }" );
+        CPPUNIT_ASSERT( !contains( text, "operatorLessThanUnsigned" ) );
+        CPPUNIT_ASSERT( !contains( text, "operatorGreaterThanUnsigned" ) );
+
+        // A true && narrows by both operands. A false one says nothing.
+        text = UT::compileToText( "def f(x : U32) -> Bool { if( x > 5 && x < 10 ) { x >= 6 } else { x >= 6 } }" );
+        CPPUNIT_ASSERT_EQUAL( size_t(1), count( text, "operatorGreaterThanOrEqualsUnsigned" ) );
+
+        // A false || narrows by both operands. A true one says nothing.
+        text = UT::compileToText( "def f(x : U32) -> Bool { if( x < 5 || x > 10 ) { x >= 5 } else { x >= 5 } }" );
+        CPPUNIT_ASSERT_EQUAL( size_t(1), count( text, "operatorGreaterThanOrEqualsUnsigned" ) );
+    }
+
+    void narrowingScopeTest() {
+        // The narrowing ends with the clause
+        std::string text = UT::compileToText(
+                "def f(x : U32) -> Bool { if( x < 5 ) { def y : Bool = x <= 4; } x <= 4 }" );
+        CPPUNIT_ASSERT_EQUAL( size_t(1), count( text, "operatorLessThanOrEqualsUnsigned" ) );
+    }
+
+    void emptyNarrowingTest() {
+        // No U32 is below 0. The then clause is dead, and the else clause learns nothing from x>=0.
+        std::string text = UT::compileToText(
+                "def f(x : U32) -> Bool { if( x < 0 ) { x == 7 } else { x >= 1 } }" );
+        CPPUNIT_ASSERT( !contains( text, "operatorEquals" ) );
+        CPPUNIT_ASSERT_EQUAL( size_t(1), count( text, "operatorGreaterThanOrEqualsUnsigned" ) );
+    }
+
+    void signedOverflowTest() {
+        // a+a is exactly [202,254], all of which overflows S8. That leaves nothing to fold to.
+        std::string text = UT::compileToText(
+                "def k(a : S8) -> S8 { if( a > 100 ) { a + a } else { 0 } }" );
+
+        CPPUNIT_ASSERT( contains( text, "binaryOperatorPlusSigned" ) );
+        CPPUNIT_ASSERT( !contains( text, "= 127 : S8" ) );
+
+        // Partial overflow still narrows to the part that fits, here the single value 127
+        text = UT::compileToText( "def k(a : S8) -> S8 { if( a > 62 ) { a + 64 } else { 0 } }" );
+
+        CPPUNIT_ASSERT( !contains( text, "binaryOperatorPlusSigned" ) );
+        CPPUNIT_ASSERT( contains( text, "= 127 : S8" ) );
+    }
+
+public:
+    static CppUnit::Test *suite()
+    {
+        CppUnit::TestSuite *suiteOfTests = new CppUnit::TestSuite( "ValueRangeTest" );
+        suiteOfTests->addTest( new CppUnit::TestCaller<ValueRangeTest>(
+                    "uniteTest",
+                    &ValueRangeTest::uniteTest ) );
+        suiteOfTests->addTest( new CppUnit::TestCaller<ValueRangeTest>(
+                    "intersectTest",
+                    &ValueRangeTest::intersectTest ) );
+        suiteOfTests->addTest( new CppUnit::TestCaller<ValueRangeTest>(
+                    "signedOverflowTest",
+                    &ValueRangeTest::signedOverflowTest ) );
+        suiteOfTests->addTest( new CppUnit::TestCaller<ValueRangeTest>(
+                    "narrowingTest",
+                    &ValueRangeTest::narrowingTest ) );
+        suiteOfTests->addTest( new CppUnit::TestCaller<ValueRangeTest>(
+                    "narrowingScopeTest",
+                    &ValueRangeTest::narrowingScopeTest ) );
+        suiteOfTests->addTest( new CppUnit::TestCaller<ValueRangeTest>(
+                    "emptyNarrowingTest",
+                    &ValueRangeTest::emptyNarrowingTest ) );
+        return suiteOfTests;
+    }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( ValueRangeTest );